@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "resource_handles.h"
+
+namespace vulvox
+{
+    /// <summary>
+    /// Single instance of a draw_batch call, the model (and in a bindless batch the texture) can differ per item.
+    /// </summary>
+    struct Batch_Item
+    {
+        Model_Handle model;
+        uint32_t texture_index = 0; //Layer in the texture array of the batch
+        Texture_Handle texture; //Texture of the item in a bindless batch, ignored when the batch uses a texture array
+        glm::mat4 model_matrix{ 1.0f };
+    };
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "pch.h"
+#include "cpu_instance_culler.h"
+
+#include <bit>
+
+//SSE is part of every x64 target, AVX only when the compiler targets it (/arch:AVX, -mavx)
+#if defined(__AVX__)
+#define VULVOX_CULL_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VULVOX_CULL_SSE
+#include <immintrin.h>
+#endif
+
+namespace vulvox
+{
+    void CPU_Instance_Culler::set_enabled(const bool enable)
+    {
+        enabled = enable;
+    }
+
+    bool CPU_Instance_Culler::is_enabled() const
+    {
+        return enabled;
+    }
+
+    void CPU_Instance_Culler::begin_frame(const std::array<glm::vec4, 6>& frustum_planes)
+    {
+        this->frustum_planes = frustum_planes;
+    }
+
+    uint32_t CPU_Instance_Culler::cull(Thread_Pool& thread_pool, std::span<const glm::mat4> model_matrices, const glm::vec4& bounding_sphere, CPU_Cull_Result& result) const
+    {
+        VULVOX_PROFILE_SCOPE("CPU_Instance_Culler::cull");
+
+        //The index vectors of previous culls are reused, so their capacity carries over between draws
+        uint32_t batch_count = thread_pool.get_batch_count(model_matrices.size(), MIN_BATCH_SIZE);
+        std::vector<CPU_Cull_Result::Batch>& batches = result.batches;
+        batches.resize(batch_count);
+
+        for (auto& batch : batches)
+        {
+            batch.visible.clear();
+        }
+
+        thread_pool.parallel_for(model_matrices.size(), MIN_BATCH_SIZE, [&](size_t begin, size_t end, uint32_t batch)
+            {
+                cull_batch(model_matrices, bounding_sphere, begin, end, batches[batch].visible);
+            });
+
+        //Prefix sum of the visible counts, every batch writes its own range of the output
+        uint32_t visible_count = 0;
+        for (auto& batch : batches)
+        {
+            batch.offset = visible_count;
+            visible_count += static_cast<uint32_t>(batch.visible.size());
+        }
+
+        result.visible_count = visible_count;
+        return visible_count;
+    }
+
+    void CPU_Instance_Culler::cull_batch(std::span<const glm::mat4> model_matrices, const glm::vec4& bounding_sphere, const size_t begin, const size_t end, std::vector<uint32_t>& visible) const
+    {
+        size_t count = end - begin;
+
+        //Structure of arrays scratch space, reused by every batch this thread runs
+        thread_local std::vector<float> center_x;
+        thread_local std::vector<float> center_y;
+        thread_local std::vector<float> center_z;
+        thread_local std::vector<float> scale_squared;
+
+        center_x.resize(count);
+        center_y.resize(count);
+        center_z.resize(count);
+        scale_squared.resize(count);
+
+        //Move the bounding sphere with the instance, the radius is scaled by the largest axis scale (same as instance_cull.comp)
+        glm::vec4 sphere_center(glm::vec3(bounding_sphere), 1.0f);
+        for (size_t i = 0; i < count; i++)
+        {
+            const glm::mat4& model_matrix = model_matrices[begin + i];
+
+            glm::vec4 center = model_matrix * sphere_center;
+            center_x[i] = center.x;
+            center_y[i] = center.y;
+            center_z[i] = center.z;
+
+            float scale_x = glm::dot(glm::vec3(model_matrix[0]), glm::vec3(model_matrix[0]));
+            float scale_y = glm::dot(glm::vec3(model_matrix[1]), glm::vec3(model_matrix[1]));
+            float scale_z = glm::dot(glm::vec3(model_matrix[2]), glm::vec3(model_matrix[2]));
+            scale_squared[i] = std::max(std::max(scale_x, scale_y), scale_z);
+        }
+
+        size_t i = 0;
+
+#if defined(VULVOX_CULL_AVX)
+        //8 spheres per iteration
+        __m256 radius = _mm256_set1_ps(bounding_sphere.w);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 x = _mm256_loadu_ps(center_x.data() + i);
+            __m256 y = _mm256_loadu_ps(center_y.data() + i);
+            __m256 z = _mm256_loadu_ps(center_z.data() + i);
+            __m256 negative_radius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_mul_ps(radius, _mm256_sqrt_ps(_mm256_loadu_ps(scale_squared.data() + i))));
+
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (const glm::vec4& plane : frustum_planes)
+            {
+                __m256 distance = _mm256_add_ps(
+                    _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(plane.x)), _mm256_mul_ps(y, _mm256_set1_ps(plane.y))),
+                    _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(plane.z)), _mm256_set1_ps(plane.w)));
+
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negative_radius, _CMP_GE_OQ));
+            }
+
+            for (uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(inside)); mask != 0; mask &= mask - 1)
+            {
+                visible.push_back(static_cast<uint32_t>(begin + i + std::countr_zero(mask)));
+            }
+        }
+#elif defined(VULVOX_CULL_SSE)
+        //4 spheres per iteration
+        __m128 radius = _mm_set1_ps(bounding_sphere.w);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x = _mm_loadu_ps(center_x.data() + i);
+            __m128 y = _mm_loadu_ps(center_y.data() + i);
+            __m128 z = _mm_loadu_ps(center_z.data() + i);
+            __m128 negative_radius = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(radius, _mm_sqrt_ps(_mm_loadu_ps(scale_squared.data() + i))));
+
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (const glm::vec4& plane : frustum_planes)
+            {
+                __m128 distance = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.x)), _mm_mul_ps(y, _mm_set1_ps(plane.y))),
+                    _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negative_radius));
+            }
+
+            for (uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(inside)); mask != 0; mask &= mask - 1)
+            {
+                visible.push_back(static_cast<uint32_t>(begin + i + std::countr_zero(mask)));
+            }
+        }
+#endif
+
+        //Remaining spheres (all of them without SIMD support)
+        for (; i < count; i++)
+        {
+            float negative_radius = -bounding_sphere.w * std::sqrt(scale_squared[i]);
+
+            bool inside = true;
+            for (const glm::vec4& plane : frustum_planes)
+            {
+                if (plane.x * center_x[i] + plane.y * center_y[i] + plane.z * center_z[i] + plane.w < negative_radius)
+                {
+                    inside = false;
+                    break;
+                }
+            }
+
+            if (inside)
+            {
+                visible.push_back(static_cast<uint32_t>(begin + i));
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+namespace vulvox
+{
+    /// <summary>
+    /// Visible instances of a single cull, split in the batches the culling ran in.
+    /// Kept by the caller so multiple threads can cull at the same time, the vectors are reused between culls.
+    /// </summary>
+    struct CPU_Cull_Result
+    {
+        //Visible instances of a single batch and where they start in the output
+        struct Batch
+        {
+            std::vector<uint32_t> visible;
+            uint32_t offset = 0;
+        };
+
+        std::vector<Batch> batches;
+        uint32_t visible_count = 0;
+    };
+
+    /// <summary>
+    /// Frustum culling of instanced draws on the CPU, the alternative to Vulkan_Instance_Culler that also reduces the uploaded instance data.
+    /// The model matrices are split in batches over a thread pool, every batch gathers the bounding spheres into SoA arrays and tests them
+    /// against the six frustum planes with SSE (AVX when the library is compiled with it, scalar on other architectures).
+    /// The visible instances are then written directly into the mapped instance buffer with write_visible.
+    /// </summary>
+    class CPU_Instance_Culler
+    {
+    public:
+
+        CPU_Instance_Culler() = default;
+
+        void set_enabled(const bool enable);
+        bool is_enabled() const;
+
+        /// <summary>
+        /// Sets the frustum (normalized planes in the space before the instance transform) of the frame that is being recorded.
+        /// </summary>
+        void begin_frame(const std::array<glm::vec4, 6>& frustum_planes);
+
+        /// <summary>
+        /// Tests the bounding sphere (xyz center, w radius in model space) of every instance against the frustum.
+        /// Returns the number of visible instances, safe to call from multiple threads with their own result.
+        /// </summary>
+        uint32_t cull(Thread_Pool& thread_pool, std::span<const glm::mat4> model_matrices, const glm::vec4& bounding_sphere, CPU_Cull_Result& result) const;
+
+        /// <summary>
+        /// Copies the per-instance data of the visible instances of a cull to destination, in their original order.
+        /// The source is indexed like the culled model matrices and needs at least as many elements (checked by the callers), destination has to fit the visible instance count.
+        /// </summary>
+        template<typename T>
+        void write_visible(Thread_Pool& thread_pool, const CPU_Cull_Result& result, std::span<const T> source, T* destination) const
+        {
+            thread_pool.parallel_for(result.batches.size(), 1, [&](size_t begin, size_t end, uint32_t)
+                {
+                    for (size_t batch = begin; batch < end; batch++)
+                    {
+                        T* output = destination + result.batches[batch].offset;
+
+                        for (uint32_t index : result.batches[batch].visible)
+                        {
+                            *output++ = source[index];
+                        }
+                    }
+                });
+        }
+
+    private:
+
+        //Gathers the spheres of [begin, end) and appends the visible indices to visible
+        void cull_batch(std::span<const glm::mat4> model_matrices, const glm::vec4& bounding_sphere, const size_t begin, const size_t end, std::vector<uint32_t>& visible) const;
+
+        //Amount of instances a batch covers at least, smaller draws are culled on the calling thread
+        static constexpr size_t MIN_BATCH_SIZE = 4096;
+
+        bool enabled = false;
+        std::array<glm::vec4, 6> frustum_planes{};
+    };
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "pch.h"
+#include "cpu_profiler.h"
+
+namespace vulvox
+{
+    std::chrono::steady_clock::time_point CPU_Profiler::epoch = std::chrono::steady_clock::now();
+    std::array<CPU_Profile_Event, CPU_Profiler::EVENT_CAPACITY> CPU_Profiler::events{};
+    std::atomic<uint64_t> CPU_Profiler::event_count{ 0 };
+    std::atomic<uint32_t> CPU_Profiler::thread_count{ 0 };
+
+    void CPU_Profiler::record_event(const char* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+    {
+        //Claim a slot without locking, slots are reused once the ring buffer wraps around
+        uint64_t index = event_count.fetch_add(1, std::memory_order_relaxed);
+
+        CPU_Profile_Event& event = events[index % EVENT_CAPACITY];
+        event.name = name;
+        event.start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(start - epoch).count();
+        event.duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        event.thread_id = get_thread_id();
+    }
+
+    bool CPU_Profiler::write_chrome_trace(const std::filesystem::path& path)
+    {
+        std::ofstream output(path);
+        if (!output.is_open())
+        {
+            std::cout << "Failed to open trace file " << path.string() << std::endl;
+            return false;
+        }
+
+        uint64_t total_events = event_count.load(std::memory_order_acquire);
+        uint64_t stored_events = std::min<uint64_t>(total_events, EVENT_CAPACITY);
+        uint64_t first_event = total_events - stored_events;
+
+        output << std::fixed;
+        output.precision(3);
+
+        //Complete events ("ph": "X") with timestamps and durations in microseconds
+        output << "{\"traceEvents\":[\n";
+        for (uint64_t i = first_event; i < total_events; i++)
+        {
+            const CPU_Profile_Event& event = events[i % EVENT_CAPACITY];
+
+            output << "{\"name\":\"" << (event.name ? event.name : "unknown") << "\",\"cat\":\"vulvox\",\"ph\":\"X\""
+                << ",\"ts\":" << static_cast<double>(event.start_ns) / 1000.0
+                << ",\"dur\":" << static_cast<double>(event.duration_ns) / 1000.0
+                << ",\"pid\":0,\"tid\":" << event.thread_id << "}"
+                << (i + 1 < total_events ? ",\n" : "\n");
+        }
+        output << "],\"displayTimeUnit\":\"ms\"}\n";
+
+        return true;
+    }
+
+    void CPU_Profiler::clear()
+    {
+        event_count.store(0, std::memory_order_release);
+    }
+
+    bool CPU_Profiler::is_enabled()
+    {
+#ifdef ENABLE_CPU_PROFILING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    uint32_t CPU_Profiler::get_thread_id()
+    {
+        //Small sequential ids are easier to read in the trace viewer than native thread ids
+        thread_local uint32_t thread_id = thread_count.fetch_add(1, std::memory_order_relaxed);
+        return thread_id;
+    }
+}
\ No newline at end of file
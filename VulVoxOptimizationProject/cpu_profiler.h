@@ -0,0 +1,79 @@
+#pragma once
+
+namespace vulvox
+{
+    /// <summary>
+    /// A single timed scope, stored in the profiler ring buffer.
+    /// </summary>
+    struct CPU_Profile_Event
+    {
+        const char* name = nullptr; //Must be a string literal (or otherwise outlive the profiler)
+        uint64_t start_ns = 0; //Relative to the profiler epoch
+        uint64_t duration_ns = 0;
+        uint32_t thread_id = 0;
+    };
+
+    /// <summary>
+    /// Collects scoped CPU timings in a fixed size ring buffer, the oldest events are overwritten when it is full.
+    /// Use the VULVOX_PROFILE_SCOPE / VULVOX_PROFILE_FUNCTION macros instead of calling this directly,
+    /// they compile to nothing unless ENABLE_CPU_PROFILING is defined (CMake option VULVOX_ENABLE_CPU_PROFILING).
+    /// </summary>
+    class CPU_Profiler
+    {
+    public:
+
+        static constexpr size_t EVENT_CAPACITY = 1 << 16;
+
+        static void record_event(const char* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+        /// <summary>
+        /// Writes the events in the ring buffer as Chrome trace_event JSON (open with chrome://tracing or Perfetto).
+        /// Returns false if the file could not be written.
+        /// </summary>
+        static bool write_chrome_trace(const std::filesystem::path& path);
+
+        static void clear();
+
+        static bool is_enabled();
+
+    private:
+
+        static uint32_t get_thread_id();
+
+        static std::chrono::steady_clock::time_point epoch;
+
+        static std::array<CPU_Profile_Event, EVENT_CAPACITY> events;
+
+        //Total number of recorded events, the write position is event_count % EVENT_CAPACITY
+        static std::atomic<uint64_t> event_count;
+        static std::atomic<uint32_t> thread_count;
+    };
+
+    /// <summary>
+    /// Records the lifetime of this object as a profiler event.
+    /// </summary>
+    class CPU_Scoped_Timer
+    {
+    public:
+        explicit CPU_Scoped_Timer(const char* name) : name(name), start(std::chrono::steady_clock::now()) {}
+        ~CPU_Scoped_Timer() { CPU_Profiler::record_event(name, start, std::chrono::steady_clock::now()); }
+
+        CPU_Scoped_Timer(const CPU_Scoped_Timer&) = delete;
+        CPU_Scoped_Timer& operator=(const CPU_Scoped_Timer&) = delete;
+
+    private:
+        const char* name;
+        std::chrono::steady_clock::time_point start;
+    };
+}
+
+#define VULVOX_PROFILE_CONCAT_INNER(a, b) a##b
+#define VULVOX_PROFILE_CONCAT(a, b) VULVOX_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_CPU_PROFILING
+#define VULVOX_PROFILE_SCOPE(name) vulvox::CPU_Scoped_Timer VULVOX_PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#define VULVOX_PROFILE_FUNCTION() VULVOX_PROFILE_SCOPE(__func__)
+#else
+#define VULVOX_PROFILE_SCOPE(name) ((void)0)
+#define VULVOX_PROFILE_FUNCTION() ((void)0)
+#endif
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <span>
+
+namespace vulvox
+{
+    /// <summary>
+    /// A rendered frame that was copied back from the GPU.
+    /// Pixels are tightly packed 8-bit per channel with 4 channels, rows are row_pitch bytes apart.
+    /// The pixel span points directly into the readback buffer and is only valid during the capture callback, copy the data if it has to outlive the callback.
+    /// </summary>
+    struct Frame_Capture
+    {
+        uint64_t frame_number = 0; //Frame in which the capture was requested
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t row_pitch = 0; //In bytes
+        bool bgra = false; //Channel order is BGRA instead of RGBA (common for swap chain images)
+        bool srgb = false; //Pixel values are sRGB encoded
+
+        std::span<const uint8_t> pixels;
+    };
+
+    using Frame_Capture_Callback = std::function<void(const Frame_Capture&)>;
+}
\ No newline at end of file
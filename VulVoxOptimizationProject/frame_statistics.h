@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vulvox
+{
+    /// <summary>
+    /// Host side statistics of a single frame, collected between start_draw() and end_draw().
+    /// </summary>
+    struct Frame_Statistics
+    {
+        uint64_t frame_number = 0;
+
+        //Time start_draw() blocked on the fence of the frame in flight (GPU back pressure)
+        double fence_wait_ms = 0.0;
+
+        //Slot of the per-frame resources used by this frame, cycles through the frames in flight
+        uint32_t frame_in_flight_index = 0;
+
+        //The previous frame was still executing on the GPU when recording of this frame started (CPU/GPU overlap)
+        bool overlapped_previous_frame = false;
+
+        //Bytes copied into the per-frame instance and staging buffers by the draw calls and instance set updates
+        uint64_t instance_upload_bytes = 0;
+
+        //Amount of draw commands recorded into the command buffer
+        uint32_t draw_calls = 0;
+        uint64_t instance_count = 0;
+
+        //Instances rejected by the CPU frustum culling stage (not uploaded and not part of instance_count)
+        uint64_t cpu_culled_instances = 0;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vulvox
+{
+    /// <summary>
+    /// GPU execution time of a single profiled scope (e.g. a draw call).
+    /// </summary>
+    struct GPU_Timing
+    {
+        std::string name;
+        double duration_ms = 0.0;
+    };
+
+    /// <summary>
+    /// GPU timings of a completed frame, measured with timestamp queries.
+    /// </summary>
+    struct GPU_Frame_Timings
+    {
+        uint64_t frame_number = 0;
+
+        //False when GPU profiling is disabled, not supported by the device or no frame has completed yet
+        bool valid = false;
+
+        //Time between the start and the end of the render pass
+        double render_pass_ms = 0.0;
+
+        //Timings of the individual draw calls, in submission order
+        std::vector<GPU_Timing> draw_timings;
+    };
+}
\ No newline at end of file
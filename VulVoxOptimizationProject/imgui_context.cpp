@@ -87,4 +87,40 @@ namespace vulvox
     {
         ImGui::StyleColorsLight();
     }
+
+    void ImGui_Context::draw_gpu_timings(const GPU_Frame_Timings& gpu_timings)
+    {
+        ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f), ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowSize(ImVec2(360.0f, 300.0f), ImGuiCond_FirstUseEver);
+
+        ImGui::Begin("GPU Timings");
+
+        if (!gpu_timings.valid)
+        {
+            ImGui::Text("Waiting for the first profiled frame...");
+            ImGui::End();
+            return;
+        }
+
+        ImGui::Text("Frame %llu", static_cast<unsigned long long>(gpu_timings.frame_number));
+        ImGui::Text("Render pass: %.3f ms", gpu_timings.render_pass_ms);
+        ImGui::Text("Draw calls: %zu", gpu_timings.draw_timings.size());
+        ImGui::Separator();
+
+        //Clip the list, there can be thousands of draw calls
+        ImGui::BeginChild("draw_timings");
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(gpu_timings.draw_timings.size()));
+        while (clipper.Step())
+        {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+            {
+                const GPU_Timing& timing = gpu_timings.draw_timings[i];
+                ImGui::Text("%8.3f ms  %s", timing.duration_ms, timing.name.c_str());
+            }
+        }
+        ImGui::EndChild();
+
+        ImGui::End();
+    }
 }
\ No newline at end of file
@@ -17,6 +17,11 @@ namespace vulvox
         void start_imgui_frame();
         void render_and_end_imgui_frame(VkCommandBuffer current_command_buffer);
 
+        /// <summary>
+        /// Draws an overlay panel with the GPU timings of the render pass and the individual draw calls.
+        /// </summary>
+        void draw_gpu_timings(const GPU_Frame_Timings& gpu_timings);
+
 
     private:
 
@@ -3,28 +3,50 @@
 
 namespace vulvox
 {
-    VkVertexInputBindingDescription Instance_Data::get_binding_description(uint32_t binding)
+    VkVertexInputBindingDescription Instance_Data::get_binding_description(uint32_t binding, Instance_Format format)
     {
         VkVertexInputBindingDescription binding_description{};
         binding_description.binding = binding; //Array binding index
-        binding_description.stride = sizeof(glm::mat4);
+        binding_description.stride = get_instance_format_size(format);
         binding_description.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE; //Can be vertex or instance
 
         return binding_description;
     }
 
-    std::vector<VkVertexInputAttributeDescription> Instance_Data::get_attribute_descriptions(uint32_t binding)
+    std::vector<VkVertexInputAttributeDescription> Instance_Data::get_attribute_descriptions(uint32_t binding, Instance_Format format)
     {
         std::vector<VkVertexInputAttributeDescription> attribute_descriptions{};
-        attribute_descriptions.resize(4);
 
-        //A mat4 uses four locations
-        for (uint32_t i = 0; i < 4; i++)
+        //Every format is a number of vec4 attributes starting at location 3
+        uint32_t vec4_count = 4; //A mat4 uses four locations
+        VkFormat vec4_format = VK_FORMAT_R32G32B32A32_SFLOAT;
+        uint32_t vec4_size = sizeof(glm::vec4);
+
+        switch (format)
+        {
+        case Instance_Format::AFFINE_3X4:
+            vec4_count = 3; //Three rows
+            break;
+        case Instance_Format::QUAT_SCALE:
+            vec4_count = 2; //Position + scale, rotation
+            break;
+        case Instance_Format::HALF_QUAT_SCALE:
+            vec4_count = 2; //Same as QUAT_SCALE, the vertex fetch converts the halfs to floats
+            vec4_format = VK_FORMAT_R16G16B16A16_SFLOAT;
+            vec4_size = 4 * sizeof(uint16_t);
+            break;
+        default:
+            break;
+        }
+
+        attribute_descriptions.resize(vec4_count);
+
+        for (uint32_t i = 0; i < vec4_count; i++)
         {
             attribute_descriptions[i].binding = binding; //Source array binding index
             attribute_descriptions[i].location = 3 + i; //Location index in shader
-            attribute_descriptions[i].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-            attribute_descriptions[i].offset = i * sizeof(glm::vec4); //Byte offset relative to the start of the object
+            attribute_descriptions[i].format = vec4_format;
+            attribute_descriptions[i].offset = i * vec4_size; //Byte offset relative to the start of the object
         }
 
         return attribute_descriptions;
@@ -5,17 +5,17 @@ namespace vulvox
     struct Instance_Data
     {
         /// <summary>
-        /// Returns a description of the input buffer containing instances
+        /// Returns a description of the input buffer containing instances of the given format
         /// </summary>
         /// <returns></returns>
-        static VkVertexInputBindingDescription get_binding_description(uint32_t binding);
+        static VkVertexInputBindingDescription get_binding_description(uint32_t binding, Instance_Format format = Instance_Format::MAT4);
 
         /// <summary>
-        /// Defines an input attribute description for each of the member variables
-        /// Each descriptor contains the format and byte offset with respect to the vertex struct
+        /// Defines an input attribute description for each of the member variables of the given format
+        /// Each descriptor contains the format and byte offset with respect to the instance struct
         /// </summary>
         /// <returns></returns>
-        static std::vector<VkVertexInputAttributeDescription> get_attribute_descriptions(uint32_t binding);
+        static std::vector<VkVertexInputAttributeDescription> get_attribute_descriptions(uint32_t binding, Instance_Format format = Instance_Format::MAT4);
     };
 
     struct Plane_Instance_Data
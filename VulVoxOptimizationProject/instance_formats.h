@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include <glm/gtc/packing.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace vulvox
+{
+    /// <summary>
+    /// Per-instance transform layouts, selectable per draw call.
+    /// The compact formats cut the upload bandwidth and vertex fetch cost of instanced draws.
+    /// </summary>
+    enum class Instance_Format : uint32_t
+    {
+        MAT4,               //64 bytes, glm::mat4
+        AFFINE_3X4,         //48 bytes, Instance_Affine
+        QUAT_SCALE,         //32 bytes, Instance_Quat_Scale
+        HALF_QUAT_SCALE,    //16 bytes, Instance_Half_Quat_Scale
+        COUNT
+    };
+
+    /// <summary>
+    /// Upper three rows of an affine model matrix, the last row is always (0, 0, 0, 1).
+    /// </summary>
+    struct Instance_Affine
+    {
+        glm::vec4 rows[3];
+
+        Instance_Affine() = default;
+
+        explicit Instance_Affine(const glm::mat4& model_matrix)
+        {
+            //glm is column major, store the rows so the shader can use three dot products
+            glm::mat4 transposed = glm::transpose(model_matrix);
+            rows[0] = transposed[0];
+            rows[1] = transposed[1];
+            rows[2] = transposed[2];
+        }
+    };
+
+    /// <summary>
+    /// Position, rotation and uniform scale, for instances that don't need shearing or non-uniform scaling.
+    /// </summary>
+    struct Instance_Quat_Scale
+    {
+        glm::vec3 position;
+        float scale;
+        glm::vec4 rotation; //Unit quaternion (x, y, z, w)
+
+        Instance_Quat_Scale() = default;
+
+        Instance_Quat_Scale(const glm::vec3& position, const glm::quat& rotation, const float scale)
+            : position(position), scale(scale), rotation(rotation.x, rotation.y, rotation.z, rotation.w)
+        {
+        }
+    };
+
+    /// <summary>
+    /// Half precision variant of Instance_Quat_Scale.
+    /// Half floats have an 11 bit mantissa, so keep positions small (e.g. relative to a nearby origin).
+    /// </summary>
+    struct Instance_Half_Quat_Scale
+    {
+        uint16_t position_scale[4]; //Position (x, y, z) and uniform scale
+        uint16_t rotation[4]; //Unit quaternion (x, y, z, w)
+
+        Instance_Half_Quat_Scale() = default;
+
+        Instance_Half_Quat_Scale(const glm::vec3& position, const glm::quat& rotation, const float scale)
+        {
+            uint64_t packed_position_scale = glm::packHalf4x16(glm::vec4(position, scale));
+            uint64_t packed_rotation = glm::packHalf4x16(glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w));
+
+            memcpy(position_scale, &packed_position_scale, sizeof(position_scale));
+            memcpy(this->rotation, &packed_rotation, sizeof(this->rotation));
+        }
+    };
+
+    static_assert(sizeof(Instance_Affine) == 48, "Instance_Affine has to match the 3x4 vertex input layout.");
+    static_assert(sizeof(Instance_Quat_Scale) == 32, "Instance_Quat_Scale has to match the quaternion vertex input layout.");
+    static_assert(sizeof(Instance_Half_Quat_Scale) == 16, "Instance_Half_Quat_Scale has to match the half float vertex input layout.");
+
+    /// <summary>
+    /// Size of a single instance in bytes.
+    /// </summary>
+    constexpr uint32_t get_instance_format_size(const Instance_Format format)
+    {
+        switch (format)
+        {
+        case Instance_Format::AFFINE_3X4: return sizeof(Instance_Affine);
+        case Instance_Format::QUAT_SCALE: return sizeof(Instance_Quat_Scale);
+        case Instance_Format::HALF_QUAT_SCALE: return sizeof(Instance_Half_Quat_Scale);
+        default: return sizeof(glm::mat4);
+        }
+    }
+
+    /// <summary>
+    /// Maps an instance type to its format, used by the templated draw functions.
+    /// </summary>
+    template<typename T>
+    struct Instance_Format_Of;
+
+    template<> struct Instance_Format_Of<glm::mat4> { static constexpr Instance_Format format = Instance_Format::MAT4; };
+    template<> struct Instance_Format_Of<Instance_Affine> { static constexpr Instance_Format format = Instance_Format::AFFINE_3X4; };
+    template<> struct Instance_Format_Of<Instance_Quat_Scale> { static constexpr Instance_Format format = Instance_Format::QUAT_SCALE; };
+    template<> struct Instance_Format_Of<Instance_Half_Quat_Scale> { static constexpr Instance_Format format = Instance_Format::HALF_QUAT_SCALE; };
+}
\ No newline at end of file
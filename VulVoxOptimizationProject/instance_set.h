@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vulvox
+{
+    /// <summary>
+    /// Handle to a retained instance set, see Renderer::create_instance_set().
+    /// A handle becomes invalid when its set is destroyed, using it afterwards is ignored.
+    /// </summary>
+    struct Instance_Set_Handle
+    {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+
+        bool is_valid() const { return index != UINT32_MAX; }
+    };
+}
\ No newline at end of file
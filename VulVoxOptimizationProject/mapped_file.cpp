@@ -0,0 +1,110 @@
+#include "pch.h"
+#include "mapped_file.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vulvox
+{
+#if defined(_WIN32)
+    Mapped_File::Mapped_File(const std::filesystem::path& file_path)
+    {
+        file_handle = CreateFileW(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+        if (file_handle == INVALID_HANDLE_VALUE)
+        {
+            file_handle = nullptr;
+            throw std::runtime_error("Failed to open file for mapping! Path was: " + file_path.string());
+        }
+
+        LARGE_INTEGER file_size{};
+
+        if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0)
+        {
+            CloseHandle(file_handle);
+            throw std::runtime_error("Failed to map empty file! Path was: " + file_path.string());
+        }
+
+        mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* view = mapping_handle != nullptr ? MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+        if (view == nullptr)
+        {
+            if (mapping_handle != nullptr)
+            {
+                CloseHandle(mapping_handle);
+            }
+
+            CloseHandle(file_handle);
+            throw std::runtime_error("Failed to map file! Path was: " + file_path.string());
+        }
+
+        mapped_data = static_cast<const unsigned char*>(view);
+        mapped_size = static_cast<size_t>(file_size.QuadPart);
+    }
+
+    Mapped_File::~Mapped_File()
+    {
+        UnmapViewOfFile(mapped_data);
+        CloseHandle(mapping_handle);
+        CloseHandle(file_handle);
+    }
+#else
+    Mapped_File::Mapped_File(const std::filesystem::path& file_path)
+    {
+        int file_descriptor = open(file_path.c_str(), O_RDONLY);
+
+        if (file_descriptor < 0)
+        {
+            throw std::runtime_error("Failed to open file for mapping! Path was: " + file_path.string());
+        }
+
+        struct stat file_status {};
+
+        if (fstat(file_descriptor, &file_status) != 0 || file_status.st_size == 0)
+        {
+            close(file_descriptor);
+            throw std::runtime_error("Failed to map empty file! Path was: " + file_path.string());
+        }
+
+        void* view = mmap(nullptr, static_cast<size_t>(file_status.st_size), PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+
+        //The mapping keeps its own reference to the file
+        close(file_descriptor);
+
+        if (view == MAP_FAILED)
+        {
+            throw std::runtime_error("Failed to map file! Path was: " + file_path.string());
+        }
+
+        mapped_data = static_cast<const unsigned char*>(view);
+        mapped_size = static_cast<size_t>(file_status.st_size);
+
+        //The contents are read front to back once
+        madvise(view, mapped_size, MADV_SEQUENTIAL);
+    }
+
+    Mapped_File::~Mapped_File()
+    {
+        munmap(const_cast<unsigned char*>(mapped_data), mapped_size);
+    }
+#endif
+
+    const unsigned char* Mapped_File::data() const
+    {
+        return mapped_data;
+    }
+
+    size_t Mapped_File::size() const
+    {
+        return mapped_size;
+    }
+}
\ No newline at end of file
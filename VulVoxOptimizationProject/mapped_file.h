@@ -0,0 +1,36 @@
+#pragma once
+
+namespace vulvox
+{
+    /// <summary>
+    /// Read-only memory mapping of an entire file, pages are only read from disk when they are touched.
+    /// Uses mmap on Linux and MacOS and a file mapping object on Windows, the mapping is released on destruction.
+    /// </summary>
+    class Mapped_File
+    {
+    public:
+
+        /// <summary>
+        /// Maps the file, throws when it can't be opened or is empty.
+        /// </summary>
+        explicit Mapped_File(const std::filesystem::path& file_path);
+        ~Mapped_File();
+
+        Mapped_File(const Mapped_File&) = delete;
+        Mapped_File& operator=(const Mapped_File&) = delete;
+
+        const unsigned char* data() const;
+        size_t size() const;
+
+    private:
+
+        const unsigned char* mapped_data = nullptr;
+        size_t mapped_size = 0;
+
+#if defined(_WIN32)
+        //HANDLEs, kept as void* so windows.h stays out of the header
+        void* file_handle = nullptr;
+        void* mapping_handle = nullptr;
+#endif
+    };
+}
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "pch.h"
+#include "mesh_file.h"
+
+namespace vulvox
+{
+    std::filesystem::path Mesh_File::get_cache_path(const std::filesystem::path& model_path)
+    {
+        std::filesystem::path cache_path = model_path;
+        return cache_path.replace_extension(EXTENSION);
+    }
+
+    std::optional<Model_Data> Mesh_File::load(const std::filesystem::path& model_path)
+    {
+        std::filesystem::path cache_path = get_cache_path(model_path);
+
+        std::error_code error;
+
+        if (!std::filesystem::is_regular_file(cache_path, error))
+        {
+            return std::nullopt;
+        }
+
+        VULVOX_PROFILE_SCOPE("Mesh_File::load");
+
+        uint64_t source_size = 0;
+        int64_t source_write_time = 0;
+
+        if (!get_source_status(model_path, source_size, source_write_time))
+        {
+            return std::nullopt;
+        }
+
+        std::shared_ptr<const Mapped_File> mapped_file;
+
+        try
+        {
+            mapped_file = std::make_shared<const Mapped_File>(cache_path);
+        }
+        catch (const std::exception& exception)
+        {
+            std::cout << exception.what() << std::endl;
+            return std::nullopt;
+        }
+
+        if (mapped_file->size() < sizeof(Header))
+        {
+            return std::nullopt;
+        }
+
+        Header header;
+        memcpy(&header, mapped_file->data(), sizeof(Header));
+
+        if (header.magic != MAGIC || header.version != VERSION || header.vertex_size != sizeof(Vertex)
+            || header.source_size != source_size || header.source_write_time != source_write_time)
+        {
+            return std::nullopt;
+        }
+
+        //Counts are checked against the file size before the ranges are formed, a truncated cache is parsed again
+        uint64_t available_size = mapped_file->size() - sizeof(Header);
+
+        if (header.vertex_count > available_size / sizeof(Vertex)
+            || header.index_count > (available_size - header.vertex_count * sizeof(Vertex)) / sizeof(uint32_t))
+        {
+            return std::nullopt;
+        }
+
+        //The header size keeps the vertices and indices aligned
+        const unsigned char* vertex_data = mapped_file->data() + sizeof(Header);
+        const unsigned char* index_data = vertex_data + header.vertex_count * sizeof(Vertex);
+
+        Model_Data model_data{};
+        model_data.path = model_path;
+        model_data.face_count = static_cast<size_t>(header.face_count);
+        model_data.bounding_sphere = header.bounding_sphere;
+        model_data.mapped_vertices = { reinterpret_cast<const Vertex*>(vertex_data), static_cast<size_t>(header.vertex_count) };
+        model_data.mapped_indices = { reinterpret_cast<const uint32_t*>(index_data), static_cast<size_t>(header.index_count) };
+        model_data.mapped_file = std::move(mapped_file);
+
+        return model_data;
+    }
+
+    void Mesh_File::save(const std::filesystem::path& model_path, const Model_Data& model_data)
+    {
+        VULVOX_PROFILE_SCOPE("Mesh_File::save");
+
+        std::span<const Vertex> vertices = model_data.get_vertices();
+        std::span<const uint32_t> indices = model_data.get_indices();
+
+        Header header{};
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.vertex_size = sizeof(Vertex);
+        header.vertex_count = vertices.size();
+        header.index_count = indices.size();
+        header.face_count = model_data.face_count;
+        header.bounding_sphere = model_data.bounding_sphere;
+
+        if (!get_source_status(model_path, header.source_size, header.source_write_time))
+        {
+            throw std::runtime_error("Failed to write mesh cache, the model file can't be read! Path was: " + model_path.string());
+        }
+
+        std::filesystem::path cache_path = get_cache_path(model_path);
+
+        //Unique per thread, parallel loads of the same model each write their own file and the last rename wins
+        std::filesystem::path temporary_path = cache_path;
+        temporary_path += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+
+        {
+            std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+
+            if (!file.is_open())
+            {
+                throw std::runtime_error("Failed to open mesh cache for writing! Path was: " + temporary_path.string());
+            }
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+            file.write(reinterpret_cast<const char*>(vertices.data()), static_cast<std::streamsize>(vertices.size_bytes()));
+            file.write(reinterpret_cast<const char*>(indices.data()), static_cast<std::streamsize>(indices.size_bytes()));
+
+            if (!file)
+            {
+                file.close();
+                std::filesystem::remove(temporary_path);
+                throw std::runtime_error("Failed to write mesh cache! Path was: " + temporary_path.string());
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary_path, cache_path, error);
+
+        if (error)
+        {
+            //E.g. the cache is mapped by another load on Windows, the next load writes it again
+            std::filesystem::remove(temporary_path, error);
+            throw std::runtime_error("Failed to replace mesh cache! Path was: " + cache_path.string());
+        }
+    }
+
+    bool Mesh_File::get_source_status(const std::filesystem::path& model_path, uint64_t& source_size, int64_t& source_write_time)
+    {
+        std::error_code error;
+
+        source_size = std::filesystem::file_size(model_path, error);
+
+        if (error)
+        {
+            return false;
+        }
+
+        std::filesystem::file_time_type write_time = std::filesystem::last_write_time(model_path, error);
+
+        if (error)
+        {
+            return false;
+        }
+
+        source_write_time = static_cast<int64_t>(write_time.time_since_epoch().count());
+        return true;
+    }
+}
\ No newline at end of file
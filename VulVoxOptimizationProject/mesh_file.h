@@ -0,0 +1,60 @@
+#pragma once
+
+namespace vulvox
+{
+    /// <summary>
+    /// Binary cache (.vvmesh) of a parsed model: the deduplicated vertices and indices as they are uploaded plus the bounds,
+    /// stored next to the model file. Loading maps the file, so the geometry is copied from the mapping into the staging buffers without any parsing.
+    /// The header holds the size and write time of the model file, a cache of a changed model (or of an older format) is ignored and rewritten.
+    /// </summary>
+    class Mesh_File
+    {
+    public:
+
+        /// <summary>
+        /// The model path with the .vvmesh extension.
+        /// </summary>
+        static std::filesystem::path get_cache_path(const std::filesystem::path& model_path);
+
+        /// <summary>
+        /// Maps the cache of the model when it is up to date, the returned data references the mapping. Thread safe.
+        /// </summary>
+        static std::optional<Model_Data> load(const std::filesystem::path& model_path);
+
+        /// <summary>
+        /// Writes the cache of the model, through a temporary file so concurrent loads never map a partially written cache.
+        /// </summary>
+        static void save(const std::filesystem::path& model_path, const Model_Data& model_data);
+
+        static constexpr const char* EXTENSION = ".vvmesh";
+
+    private:
+
+        //Bumped whenever the layout changes, which includes changes to Vertex
+        static constexpr uint32_t VERSION = 1;
+
+        struct Header
+        {
+            std::array<char, 8> magic;
+            uint32_t version;
+            uint32_t vertex_size;
+
+            //Identify the model file contents the cache was made from
+            uint64_t source_size;
+            int64_t source_write_time;
+
+            uint64_t vertex_count;
+            uint64_t index_count;
+            uint64_t face_count;
+
+            glm::vec4 bounding_sphere;
+        };
+
+        static_assert(sizeof(Header) % alignof(Vertex) == 0 && sizeof(Header) % alignof(uint32_t) == 0, "The geometry following the header has to stay aligned");
+
+        static constexpr std::array<char, 8> MAGIC = { 'V', 'V', 'M', 'E', 'S', 'H', '\0', '\0' };
+
+        //Identification of the current model file, false when it can't be read
+        static bool get_source_status(const std::filesystem::path& model_path, uint64_t& source_size, int64_t& source_write_time);
+    };
+}
\ No newline at end of file
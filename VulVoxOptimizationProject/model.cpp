@@ -3,20 +3,47 @@
 
 namespace vulvox
 {
-    Model::Model(Vulkan_Instance* instance, Vulkan_Command_Pool& command_pool, const std::filesystem::path& path_to_model)
-        : vulkan_instance(instance)
+    Model::Model(Vulkan_Mesh_Buffer* mesh_buffer, Vulkan_Command_Pool& command_pool, const std::filesystem::path& path_to_model)
+        : Model(mesh_buffer, command_pool, parse(path_to_model))
     {
-        load_model(command_pool, path_to_model);
+    }
+
+    Model::Model(Vulkan_Mesh_Buffer* mesh_buffer, Vulkan_Command_Pool& command_pool, const Model_Data& model_data)
+        : mesh_buffer(mesh_buffer)
+    {
+        VULVOX_PROFILE_SCOPE("Model::upload");
+
+        std::span<const Vertex> vertices = model_data.get_vertices();
+        std::span<const uint32_t> indices = model_data.get_indices();
+
+        vertex_buffer_size = vertices.size_bytes();
+        index_buffer_size = indices.size_bytes();
+
+        vertex_count = static_cast<uint32_t>(vertices.size());
+        index_count = static_cast<uint32_t>(indices.size());
+
+        bounding_sphere = model_data.bounding_sphere;
+
+        //Copy the geometry into the shared vertex and index buffers, cached geometry is copied straight from the file mapping
+        mesh = mesh_buffer->allocate(command_pool, vertices, indices);
+
+        std::cout << "Model " << model_data.path.filename() << " loaded containing " << model_data.face_count << " triangles with " << vertex_count << " vertices and " << index_count << " indices." << std::endl;
     }
 
     void Model::destroy()
     {
-        index_buffer.destroy(vulkan_instance->allocator);
-        vertex_buffer.destroy(vulkan_instance->allocator);
+        mesh_buffer->free(mesh);
     }
 
-    void Model::load_model(Vulkan_Command_Pool& command_pool, const std::filesystem::path& path_to_model)
+    Model_Data Model::parse(const std::filesystem::path& path_to_model)
     {
+        VULVOX_PROFILE_SCOPE("Model::parse");
+
+        if (std::optional<Model_Data> cached_data = Mesh_File::load(path_to_model))
+        {
+            return std::move(*cached_data);
+        }
+
         tinyobj::attrib_t attrib;
         std::vector<tinyobj::shape_t> shapes;
         std::vector<tinyobj::material_t> materials;
@@ -29,12 +56,15 @@ namespace vulvox
             throw std::runtime_error(warn + err);
         }
 
-        std::vector<Vertex> vertices;
-        std::vector<uint32_t> indices;
+        Model_Data model_data{};
+        model_data.path = path_to_model;
+
+        std::vector<Vertex>& vertices = model_data.vertices;
+        std::vector<uint32_t>& indices = model_data.indices;
 
         std::unordered_map<Vertex, uint32_t> unique_vertices{};
 
-        size_t face_count = 0;
+        size_t& face_count = model_data.face_count;
 
         for (const auto& shape : shapes)
         {
@@ -72,55 +102,37 @@ namespace vulvox
             }
         }
 
-        vertex_buffer_size = sizeof(vertices[0]) * vertices.size();
-        index_buffer_size = sizeof(indices[0]) * indices.size();
-
-        vertex_count = static_cast<uint32_t>(vertices.size());
-        index_count = static_cast<uint32_t>(indices.size());
-
-        create_vertex_buffer(command_pool, vertices);
-        create_index_buffer(command_pool, indices);
-
-        std::cout << "Model " << path_to_model.filename() << " loaded containing " << face_count << " triangles with " << vertices.size() << " vertices and " << indices.size() << " indices." << std::endl;
-    }
-
-    void Model::create_vertex_buffer(Vulkan_Command_Pool& command_pool, const std::vector<Vertex>& vertices)
-    {
-        VkDeviceSize buffer_size = vertices.size() * sizeof(vertices[0]);
-
-        //Create staging buffer that transfers data between the host and device
-        Buffer staging_buffer;
-        staging_buffer.create(*vulkan_instance, buffer_size,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
-
-        memcpy(staging_buffer.allocation_info.pMappedData, vertices.data(), buffer_size);
-
-        //Create vertex buffer as device only buffer
-        vertex_buffer.create(*vulkan_instance, buffer_size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, 0);
+        //Bounding sphere around the center of the bounding box, used for culling
+        glm::vec3 min_position{ std::numeric_limits<float>::max() };
+        glm::vec3 max_position{ std::numeric_limits<float>::lowest() };
 
-        //Copy data from host to device
-        command_pool.copy_buffer(staging_buffer.buffer, vertex_buffer.buffer, buffer_size);
-
-        //Data on device, cleanup temp buffers
-        staging_buffer.destroy(vulkan_instance->allocator);
-    }
+        for (const auto& vertex : vertices)
+        {
+            min_position = glm::min(min_position, vertex.position);
+            max_position = glm::max(max_position, vertex.position);
+        }
 
-    void Model::create_index_buffer(Vulkan_Command_Pool& command_pool, const std::vector<uint32_t>& indices)
-    {
-        VkDeviceSize buffer_size = indices.size() * sizeof(indices[0]);
-        Buffer staging_buffer;
-        staging_buffer.create(*vulkan_instance, buffer_size,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+        glm::vec3 center = vertices.empty() ? glm::vec3{ 0.0f } : (min_position + max_position) * 0.5f;
+        float radius_squared = 0.0f;
 
-        memcpy(staging_buffer.allocation_info.pMappedData, indices.data(), buffer_size);
+        for (const auto& vertex : vertices)
+        {
+            glm::vec3 offset = vertex.position - center;
+            radius_squared = std::max(radius_squared, glm::dot(offset, offset));
+        }
 
-        //Create index buffer as device only buffer
-        index_buffer.create(*vulkan_instance, buffer_size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 0);
+        model_data.bounding_sphere = glm::vec4(center, std::sqrt(radius_squared));
 
-        //Copy data from host to device
-        command_pool.copy_buffer(staging_buffer.buffer, index_buffer.buffer, buffer_size);
+        //A cache that can't be written (e.g. a read-only model directory) only means the next load parses again
+        try
+        {
+            Mesh_File::save(path_to_model, model_data);
+        }
+        catch (const std::exception& exception)
+        {
+            std::cout << exception.what() << std::endl;
+        }
 
-        //Data on device, cleanup temp buffers
-        staging_buffer.destroy(vulkan_instance->allocator);
+        return model_data;
     }
 }
\ No newline at end of file
@@ -2,12 +2,46 @@
 
 namespace vulvox
 {
+    /// <summary>
+    /// Geometry parsed from a model file, no GPU resources involved so it can be created on a worker thread.
+    /// Geometry from a mesh cache stays in the mapped file instead of the vectors, use get_vertices and get_indices to read either.
+    /// </summary>
+    struct Model_Data
+    {
+        std::filesystem::path path;
+
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+
+        size_t face_count = 0;
+        glm::vec4 bounding_sphere{ 0.0f };
+
+        //Set when loaded from a mesh cache, the spans point into the mapping
+        std::shared_ptr<const Mapped_File> mapped_file;
+        std::span<const Vertex> mapped_vertices;
+        std::span<const uint32_t> mapped_indices;
+
+        std::span<const Vertex> get_vertices() const { return mapped_file ? mapped_vertices : std::span<const Vertex>(vertices); }
+        std::span<const uint32_t> get_indices() const { return mapped_file ? mapped_indices : std::span<const uint32_t>(indices); }
+    };
+
     class Model
     {
     public:
 
         Model() = default;
-        Model(Vulkan_Instance* instance, Vulkan_Command_Pool& command_pool, const std::filesystem::path& path_to_model);
+        Model(Vulkan_Mesh_Buffer* mesh_buffer, Vulkan_Command_Pool& command_pool, const std::filesystem::path& path_to_model);
+
+        /// <summary>
+        /// Uploads previously parsed geometry, only this step needs the render thread.
+        /// </summary>
+        Model(Vulkan_Mesh_Buffer* mesh_buffer, Vulkan_Command_Pool& command_pool, const Model_Data& model_data);
+
+        /// <summary>
+        /// Parses the OBJ file, thread safe.
+        /// An up to date mesh cache (.vvmesh) next to the file is mapped instead, otherwise the cache is written after parsing.
+        /// </summary>
+        static Model_Data parse(const std::filesystem::path& path_to_model);
 
         uint64_t vertex_buffer_size;
         uint64_t index_buffer_size;
@@ -15,24 +49,16 @@ namespace vulvox
         uint32_t vertex_count;
         uint32_t index_count;
 
-        Buffer vertex_buffer;
-        Buffer index_buffer;
+        //Sphere that encloses all vertices, xyz center and w radius (model space)
+        glm::vec4 bounding_sphere{ 0.0f };
+
+        //Vertex and index range in the shared buffers of the mesh buffer
+        Mesh_Allocation mesh;
 
         void destroy();
         
     private:
 
-        void load_model(Vulkan_Command_Pool& command_pool, const std::filesystem::path& path_to_model);
-
-        /// <summary>
-        /// Creates the memory buffer containing the vertex data
-        /// </summary>
-        void create_vertex_buffer(Vulkan_Command_Pool& command_pool, const std::vector<Vertex>& vertices);
-        /// <summary>
-        /// Creates the memory buffer containing the index data
-        /// </summary>
-        void create_index_buffer(Vulkan_Command_Pool& command_pool, const std::vector<uint32_t>& indices);
-
-        Vulkan_Instance* vulkan_instance;
+        Vulkan_Mesh_Buffer* mesh_buffer = nullptr;
     };
 }
\ No newline at end of file
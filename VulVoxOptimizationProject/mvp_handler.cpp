@@ -48,6 +48,35 @@ namespace vulvox
         return aspect_ratio;
     }
 
+    std::array<glm::vec4, 6> MVP_Handler::get_frustum_planes() const
+    {
+        glm::mat4 clip = model_view_projection.projection * model_view_projection.view * model_view_projection.model;
+
+        //Rows of the (column major) clip matrix
+        glm::vec4 row_x{ clip[0][0], clip[1][0], clip[2][0], clip[3][0] };
+        glm::vec4 row_y{ clip[0][1], clip[1][1], clip[2][1], clip[3][1] };
+        glm::vec4 row_z{ clip[0][2], clip[1][2], clip[2][2], clip[3][2] };
+        glm::vec4 row_w{ clip[0][3], clip[1][3], clip[2][3], clip[3][3] };
+
+        //Vulkan clip space has a depth range of 0 to w, so the near plane is just the z row
+        std::array<glm::vec4, 6> planes =
+        {
+            row_w + row_x,
+            row_w - row_x,
+            row_w + row_y,
+            row_w - row_y,
+            row_z,
+            row_w - row_z
+        };
+
+        for (auto& plane : planes)
+        {
+            plane /= glm::length(glm::vec3(plane));
+        }
+
+        return planes;
+    }
+
     void MVP_Handler::update_projection_matrix()
     {
         glm::mat4 projection_matrix = glm::perspective(field_of_view, aspect_ratio, near_plane, far_plane);
@@ -17,6 +17,12 @@ namespace vulvox
 
         float get_aspect_ratio() const;
 
+        /// <summary>
+        /// Returns the normalized frustum planes (left, right, bottom, top, near, far) of the model view projection matrix.
+        /// The planes are in the space before the model matrix, xyz is the inward facing normal and w the distance.
+        /// </summary>
+        std::array<glm::vec4, 6> get_frustum_planes() const;
+
         MVP model_view_projection;
 
     private:
@@ -20,6 +20,16 @@
 #include <fstream>
 #include <sstream>
 #include <filesystem>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <queue>
+#include <functional>
+#include <span>
+#include <tuple>
 
 //GLFW & Vulkan
 #define GLFW_INCLUDE_VULKAN
@@ -54,20 +64,46 @@
 #include "imgui/imgui_impl_vulkan.h"
 
 #include "utils.h"
+#include "cpu_profiler.h"
+#include "thread_pool.h"
+#include "resource_slots.h"
+
+//Public renderer types
+#include "frame_capture.h"
+#include "frame_statistics.h"
+#include "instance_set.h"
+#include "resource_handles.h"
+#include "batch_item.h"
+#include "instance_formats.h"
+#include "gpu_timings.h"
+#include "texture_cache.h"
+
 #include "vertex.h"
 #include "mvp.h"
 #include "mvp_handler.h"
 #include "instance_data.h"
 #include "texture_array_index_binding.h"
+#include "texture_file.h"
+#include "texture_compressor.h"
+#include "mapped_file.h"
 
 #include "vulkan_instance.h"
 #include "vulkan_buffer.h"
+#include "vulkan_linear_allocator.h"
 #include "vulkan_swap_chain.h"
 #include "vulkan_command_pool.h"
 #include "vulkan_buffer_manager.h"
+#include "vulkan_mesh_buffer.h"
+#include "vulkan_descriptor_allocator.h"
 #include "vulkan_image.h"
+#include "vulkan_bindless_table.h"
+#include "vulkan_offscreen_target.h"
+#include "vulkan_gpu_profiler.h"
+#include "vulkan_instance_culler.h"
+#include "cpu_instance_culler.h"
 
 #include "model.h"
+#include "mesh_file.h"
 #include "vulkan_shader.h"
 
 #include "imgui_context.h"
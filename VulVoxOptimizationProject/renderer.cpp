@@ -10,9 +10,17 @@ namespace vulvox
 
     Renderer::~Renderer() = default;
 
-    void Renderer::init(uint32_t width, uint32_t height, float field_of_view, float near_plane, float far_plane)
+    void Renderer::init(uint32_t width, uint32_t height, float field_of_view, float near_plane, float far_plane, const uint32_t frames_in_flight)
     {
-        vulkan_engine->init(width, height);
+        vulkan_engine->init(width, height, frames_in_flight);
+        vulkan_engine->get_mvp_handler().set_field_of_view(field_of_view);
+        vulkan_engine->get_mvp_handler().set_near_plane(near_plane);
+        vulkan_engine->get_mvp_handler().set_far_plane(far_plane);
+    }
+
+    void Renderer::init_headless(uint32_t width, uint32_t height, float field_of_view, float near_plane, float far_plane, const uint32_t frames_in_flight)
+    {
+        vulkan_engine->init_headless(width, height, frames_in_flight);
         vulkan_engine->get_mvp_handler().set_field_of_view(field_of_view);
         vulkan_engine->get_mvp_handler().set_near_plane(near_plane);
         vulkan_engine->get_mvp_handler().set_far_plane(far_plane);
@@ -68,7 +76,12 @@ namespace vulvox
 
     bool Renderer::should_close() const
     {
-        return glfwWindowShouldClose(vulkan_engine->get_glfw_window_ptr());
+        return vulkan_engine->should_close();
+    }
+
+    bool Renderer::is_headless() const
+    {
+        return vulkan_engine->is_headless();
     }
 
     void Renderer::start_draw()
@@ -81,44 +94,174 @@ namespace vulvox
         vulkan_engine->end_draw();
     }
 
+    void Renderer::draw_instanced(const std::string& model_name, const std::string& texture_name, const Instance_Format format, std::span<const std::byte> instance_data)
+    {
+        vulkan_engine->draw_instanced(model_name, texture_name, format, instance_data);
+    }
+
+    void Renderer::draw_instanced(const Model_Handle model, const Texture_Handle texture, const Instance_Format format, std::span<const std::byte> instance_data)
+    {
+        vulkan_engine->draw_instanced(model, texture, format, instance_data);
+    }
+
+    std::span<std::byte> Renderer::begin_instances(const std::string& model_name, const std::string& texture_name, const uint32_t instance_count, const Instance_Format format)
+    {
+        return vulkan_engine->begin_instances(model_name, texture_name, instance_count, format);
+    }
+
+    std::span<std::byte> Renderer::begin_instances(const Model_Handle model, const Texture_Handle texture, const uint32_t instance_count, const Instance_Format format)
+    {
+        return vulkan_engine->begin_instances(model, texture, instance_count, format);
+    }
+
+    void Renderer::end_instances()
+    {
+        vulkan_engine->end_instances();
+    }
+
+    Instance_Set_Handle Renderer::create_instance_set(const std::string& model_name, const std::string& texture_name, const uint32_t initial_capacity)
+    {
+        return vulkan_engine->create_instance_set(model_name, texture_name, initial_capacity);
+    }
+
+    Instance_Set_Handle Renderer::create_instance_set(const Model_Handle model, const Texture_Handle texture, const uint32_t initial_capacity)
+    {
+        return vulkan_engine->create_instance_set(model, texture, initial_capacity);
+    }
+
+    void Renderer::destroy_instance_set(const Instance_Set_Handle handle)
+    {
+        vulkan_engine->destroy_instance_set(handle);
+    }
+
+    void Renderer::update_instances(const Instance_Set_Handle handle, const uint32_t first, std::span<const glm::mat4> model_matrices)
+    {
+        vulkan_engine->update_instances(handle, first, model_matrices);
+    }
+
+    void Renderer::draw_instance_set(const Instance_Set_Handle handle)
+    {
+        vulkan_engine->draw_instance_set(handle);
+    }
+
+    void Renderer::request_frame_capture(Frame_Capture_Callback callback)
+    {
+        vulkan_engine->request_frame_capture(callback);
+    }
+
     void Renderer::draw_model(const std::string& model_name, const std::string& texture_name, const glm::mat4& model_matrix)
     {
         vulkan_engine->draw_model(model_name, texture_name, model_matrix);
     }
 
+    void Renderer::draw_model(const Model_Handle model, const Texture_Handle texture, const glm::mat4& model_matrix)
+    {
+        vulkan_engine->draw_model(model, texture, model_matrix);
+    }
+
     void Renderer::draw_model_with_texture_array(const std::string& model_name, const std::string& texture_array_name, const int texture_index, const glm::mat4& model_matrix)
     {
         vulkan_engine->draw_model_with_texture_array(model_name, texture_array_name, texture_index, model_matrix);
     }
 
+    void Renderer::draw_model_with_texture_array(const Model_Handle model, const Texture_Array_Handle texture_array, const int texture_index, const glm::mat4& model_matrix)
+    {
+        vulkan_engine->draw_model_with_texture_array(model, texture_array, texture_index, model_matrix);
+    }
+
     void Renderer::draw_instanced(const std::string& model_name, const std::string& texture_name, const std::vector<glm::mat4>& model_matrices)
     {
         vulkan_engine->draw_instanced(model_name, texture_name, model_matrices);
     }
 
+    void Renderer::draw_instanced(const Model_Handle model, const Texture_Handle texture, const std::vector<glm::mat4>& model_matrices)
+    {
+        vulkan_engine->draw_instanced(model, texture, model_matrices);
+    }
+
     void Renderer::draw_instanced_with_texture_array(const std::string& model_name, const std::string& texture_array_name, const std::vector<glm::mat4>& model_matrices, const std::vector<uint32_t>& texture_indices)
     {
         vulkan_engine->draw_instanced_with_texture_array(model_name, texture_array_name, model_matrices, texture_indices);
     }
 
+    void Renderer::draw_instanced_with_texture_array(const Model_Handle model, const Texture_Array_Handle texture_array, const std::vector<glm::mat4>& model_matrices, const std::vector<uint32_t>& texture_indices)
+    {
+        vulkan_engine->draw_instanced_with_texture_array(model, texture_array, model_matrices, texture_indices);
+    }
+
     void Renderer::draw_planes(const std::string& texture_array_name, const std::vector<glm::mat4>& model_matrices, const std::vector<uint32_t>& texture_indices, const std::vector<glm::vec4>& min_max_uvs)
     {
         vulkan_engine->draw_planes(texture_array_name, model_matrices, texture_indices, min_max_uvs);
     }
 
-    void Renderer::load_model(const std::string& model_name, const std::filesystem::path& path)
+    void Renderer::draw_planes(const Texture_Array_Handle texture_array, const std::vector<glm::mat4>& model_matrices, const std::vector<uint32_t>& texture_indices, const std::vector<glm::vec4>& min_max_uvs)
     {
-        vulkan_engine->load_model(model_name, path);
+        vulkan_engine->draw_planes(texture_array, model_matrices, texture_indices, min_max_uvs);
     }
 
-    void Renderer::load_texture(const std::string& texture_name, const std::filesystem::path& path)
+    void Renderer::draw_batch(const std::string& texture_array_name, std::span<const Batch_Item> items)
     {
-        vulkan_engine->load_texture(texture_name, path);
+        vulkan_engine->draw_batch(texture_array_name, items);
     }
 
-    void Renderer::load_texture_array(const std::string& texture_name, const std::vector<std::filesystem::path>& paths)
+    void Renderer::draw_batch(const Texture_Array_Handle texture_array, std::span<const Batch_Item> items)
     {
-        vulkan_engine->load_texture_array(texture_name, paths);
+        vulkan_engine->draw_batch(texture_array, items);
+    }
+
+    void Renderer::draw_batch(std::span<const Batch_Item> items)
+    {
+        vulkan_engine->draw_batch(items);
+    }
+
+    bool Renderer::has_bindless_textures() const
+    {
+        return vulkan_engine->has_bindless_textures();
+    }
+
+    Model_Handle Renderer::load_model(const std::string& model_name, const std::filesystem::path& path)
+    {
+        return vulkan_engine->load_model(model_name, path);
+    }
+
+    Texture_Handle Renderer::load_texture(const std::string& texture_name, const std::filesystem::path& path)
+    {
+        return vulkan_engine->load_texture(texture_name, path);
+    }
+
+    Texture_Array_Handle Renderer::load_texture_array(const std::string& texture_name, const std::vector<std::filesystem::path>& paths)
+    {
+        return vulkan_engine->load_texture_array(texture_name, paths);
+    }
+
+    std::shared_future<Model_Handle> Renderer::load_model_async(const std::string& model_name, const std::filesystem::path& path)
+    {
+        return vulkan_engine->load_model_async(model_name, path);
+    }
+
+    std::shared_future<Texture_Handle> Renderer::load_texture_async(const std::string& texture_name, const std::filesystem::path& path)
+    {
+        return vulkan_engine->load_texture_async(texture_name, path);
+    }
+
+    void Renderer::set_texture_cache_directory(const std::filesystem::path& directory)
+    {
+        vulkan_engine->set_texture_cache_directory(directory);
+    }
+
+    void Renderer::wait_for_async_loads()
+    {
+        vulkan_engine->wait_for_async_loads();
+    }
+
+    void Renderer::begin_upload_batch()
+    {
+        vulkan_engine->begin_upload_batch();
+    }
+
+    void Renderer::end_upload_batch()
+    {
+        vulkan_engine->end_upload_batch();
     }
 
     void Renderer::unload_model(const std::string& name)
@@ -126,16 +269,31 @@ namespace vulvox
         vulkan_engine->unload_model(name);
     }
 
+    void Renderer::unload_model(const Model_Handle model)
+    {
+        vulkan_engine->unload_model(model);
+    }
+
     void Renderer::unload_texture(const std::string& name)
     {
         vulkan_engine->unload_texture(name);
     }
 
+    void Renderer::unload_texture(const Texture_Handle texture)
+    {
+        vulkan_engine->unload_texture(texture);
+    }
+
     void Renderer::unload_texture_array(const std::string& name)
     {
         vulkan_engine->unload_texture_array(name);
     }
 
+    void Renderer::unload_texture_array(const Texture_Array_Handle texture_array)
+    {
+        vulkan_engine->unload_texture_array(texture_array);
+    }
+
     void Renderer::set_model_matrix(const glm::mat4& new_model_matrix)
     {
         vulkan_engine->get_mvp_handler().set_model_matrix(new_model_matrix);
@@ -183,4 +341,90 @@ namespace vulvox
     {
         return vulkan_engine->get_memory_statistics();
     }
+
+    Frame_Statistics Renderer::get_frame_statistics() const
+    {
+        return vulkan_engine->get_frame_statistics();
+    }
+
+    uint32_t Renderer::get_frames_in_flight() const
+    {
+        return vulkan_engine->get_frames_in_flight();
+    }
+
+    uint32_t Renderer::get_current_frame_index() const
+    {
+        return vulkan_engine->get_current_frame_index();
+    }
+
+    void Renderer::set_gpu_profiling(const bool enable)
+    {
+        vulkan_engine->set_gpu_profiling(enable);
+    }
+
+    void Renderer::set_gpu_culling(const bool enable)
+    {
+        vulkan_engine->set_gpu_culling(enable);
+    }
+
+    bool Renderer::is_gpu_culling_enabled() const
+    {
+        return vulkan_engine->is_gpu_culling_enabled();
+    }
+
+    void Renderer::set_cpu_culling(const bool enable)
+    {
+        vulkan_engine->set_cpu_culling(enable);
+    }
+
+    bool Renderer::is_cpu_culling_enabled() const
+    {
+        return vulkan_engine->is_cpu_culling_enabled();
+    }
+
+    void Renderer::set_auto_instancing(const bool enable)
+    {
+        vulkan_engine->set_auto_instancing(enable);
+    }
+
+    bool Renderer::is_auto_instancing_enabled() const
+    {
+        return vulkan_engine->is_auto_instancing_enabled();
+    }
+
+    void Renderer::set_recording_workers(const uint32_t worker_count)
+    {
+        vulkan_engine->set_recording_workers(worker_count);
+    }
+
+    uint32_t Renderer::get_recording_workers() const
+    {
+        return vulkan_engine->get_recording_workers();
+    }
+
+    void Renderer::begin_worker_recording(const uint32_t worker)
+    {
+        vulkan_engine->begin_worker_recording(worker);
+    }
+
+    void Renderer::end_worker_recording()
+    {
+        vulkan_engine->end_worker_recording();
+    }
+
+    GPU_Frame_Timings Renderer::get_gpu_timings() const
+    {
+        return vulkan_engine->get_gpu_timings();
+    }
+
+    bool Renderer::write_cpu_trace(const std::filesystem::path& path) const
+    {
+        if (!CPU_Profiler::is_enabled())
+        {
+            std::cout << "CPU profiling is disabled, build with ENABLE_CPU_PROFILING to record a trace." << std::endl;
+            return false;
+        }
+
+        return CPU_Profiler::write_chrome_trace(path);
+    }
 }
\ No newline at end of file
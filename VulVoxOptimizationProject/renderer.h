@@ -1,6 +1,19 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
+#include <future>
+#include <span>
+#include <type_traits>
+
+#include "frame_capture.h"
+#include "frame_statistics.h"
+#include "instance_set.h"
+#include "resource_handles.h"
+#include "batch_item.h"
+#include "instance_formats.h"
+#include "gpu_timings.h"
+#include "texture_cache.h"
 
 namespace vulvox
 {
@@ -12,9 +25,25 @@ namespace vulvox
         Renderer();
         ~Renderer();
 
-        void init(uint32_t width, uint32_t height, float field_of_view, float near_plane, float far_plane);
+        /// <summary>
+        /// frames_in_flight (1 to 4, default 2) is the amount of frames the CPU may record ahead of the GPU.
+        /// 1 has the lowest latency but the CPU waits for every frame to finish on the GPU, more frames give more CPU/GPU overlap and throughput.
+        /// </summary>
+        void init(uint32_t width, uint32_t height, float field_of_view, float near_plane, float far_plane, const uint32_t frames_in_flight = 2);
+
+        /// <summary>
+        /// Initializes the renderer without a window or swap chain (e.g. for benchmarks and CI machines without a display).
+        /// Frames are rendered into offscreen images of the given size, there is no presentation and no Dear ImGui support.
+        /// should_close() always returns false in this mode, the caller decides when to stop rendering.
+        /// </summary>
+        void init_headless(uint32_t width, uint32_t height, float field_of_view, float near_plane, float far_plane, const uint32_t frames_in_flight = 2);
         void destroy();
 
+        /// <summary>
+        /// Returns true if the renderer was initialized with init_headless().
+        /// </summary>
+        bool is_headless() const;
+
         /// <summary>
         /// For a basic (debugging) ui you can init Dear ImGui.
         /// This will start an imgui frame when calling start_draw() and render it when calling end_draw().
@@ -47,19 +76,167 @@ namespace vulvox
         void start_draw();
         void end_draw();
 
+        /// <summary>
+        /// Copies the frame that is currently being recorded (or the next frame when called outside start_draw/end_draw) into a host visible buffer.
+        /// The copy is part of the frame's command buffer, the callback is called from start_draw() once the GPU has finished that frame,
+        /// which is frames in flight frames later. Rendering is never stalled to wait for the pixels.
+        /// Pending captures are flushed when the renderer is destroyed.
+        /// </summary>
+        void request_frame_capture(Frame_Capture_Callback callback);
+
+        /// <summary>
+        /// Queues a single model draw, the queued draws are sorted by pipeline, texture and buffers and recorded at end_draw (or end_worker_recording),
+        /// so unchanged state is only bound once. They are recorded after the other draw calls of the same thread, rely on depth testing for their order.
+        /// Repeated draws of the same model and texture are merged into a single instanced draw, see set_auto_instancing.
+        /// </summary>
         void draw_model(const std::string& model_name, const std::string& texture_name, const glm::mat4& model_matrix);
+        void draw_model(const Model_Handle model, const Texture_Handle texture, const glm::mat4& model_matrix);
         void draw_model_with_texture_array(const std::string& model_name, const std::string& texture_array_name, const int texture_index, const glm::mat4& model_matrix);
+        void draw_model_with_texture_array(const Model_Handle model, const Texture_Array_Handle texture_array, const int texture_index, const glm::mat4& model_matrix);
         void draw_instanced(const std::string& model_name, const std::string& texture_name, const std::vector<glm::mat4>& model_matrices);
+        void draw_instanced(const Model_Handle model, const Texture_Handle texture, const std::vector<glm::mat4>& model_matrices);
+
+        /// <summary>
+        /// Instanced draw with a compact instance format (Instance_Affine, Instance_Quat_Scale or Instance_Half_Quat_Scale), see instance_formats.h.
+        /// Smaller instances reduce the upload bandwidth and vertex fetch cost compared to full model matrices.
+        /// </summary>
+        template<typename T>
+        void draw_instanced(const std::string& model_name, const std::string& texture_name, const std::vector<T>& instances)
+        {
+            draw_instanced(model_name, texture_name, Instance_Format_Of<T>::format, std::as_bytes(std::span<const T>(instances)));
+        }
+
+        template<typename T>
+        void draw_instanced(const Model_Handle model, const Texture_Handle texture, const std::vector<T>& instances)
+        {
+            draw_instanced(model, texture, Instance_Format_Of<T>::format, std::as_bytes(std::span<const T>(instances)));
+        }
+
         void draw_instanced_with_texture_array(const std::string& model_name, const std::string& texture_array_name, const std::vector<glm::mat4>& model_matrices, const std::vector<uint32_t>& texture_indices);
+        void draw_instanced_with_texture_array(const Model_Handle model, const Texture_Array_Handle texture_array, const std::vector<glm::mat4>& model_matrices, const std::vector<uint32_t>& texture_indices);
         void draw_planes(const std::string& texture_array_name, const std::vector<glm::mat4>& model_matrices, const std::vector<uint32_t>& texture_indices, const std::vector<glm::vec4>& min_max_uvs);
+        void draw_planes(const Texture_Array_Handle texture_array, const std::vector<glm::mat4>& model_matrices, const std::vector<uint32_t>& texture_indices, const std::vector<glm::vec4>& min_max_uvs);
+
+        /// <summary>
+        /// Draws a list of items that can each use a different model, all textured from the same texture array.
+        /// The geometry of all models lives in shared vertex and index buffers, so the batch is recorded without rebinding them:
+        /// the items are grouped by model and issued as a single multi-draw indirect call with one command per model
+        /// (one direct draw per model when the device lacks multiDrawIndirect). Items with an invalid model handle are skipped.
+        /// The batch is not frustum culled.
+        /// </summary>
+        void draw_batch(const std::string& texture_array_name, std::span<const Batch_Item> items);
+        void draw_batch(const Texture_Array_Handle texture_array, std::span<const Batch_Item> items);
+
+        /// <summary>
+        /// Bindless variant of draw_batch, every item samples its own texture (Batch_Item::texture) from a single descriptor set that holds all loaded textures.
+        /// Items of different models and textures are still issued as one multi-draw indirect call per mesh buffer page.
+        /// Requires descriptor indexing support and the compiled bindless shaders, check has_bindless_textures().
+        /// Items with an invalid model or texture handle are skipped.
+        /// </summary>
+        void draw_batch(std::span<const Batch_Item> items);
+        bool has_bindless_textures() const;
+
+        /// <summary>
+        /// Zero-copy alternative to draw_instanced, returns a span that points directly into the mapped instance buffer of this frame.
+        /// Write all instances into the span, then call end_instances() to record the draw call.
+        /// T selects the instance format: glm::mat4 or one of the compact formats in instance_formats.h.
+        /// The span is only valid until end_instances(), only one begin/end pair can be open at a time.
+        /// An empty span is returned when the draw call is skipped (e.g. unknown model or texture).
+        /// </summary>
+        template<typename T>
+        std::span<T> begin_instances(const std::string& model_name, const std::string& texture_name, const uint32_t instance_count)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Instance data is written directly to GPU memory and has to be trivially copyable.");
+
+            std::span<std::byte> instance_data = begin_instances(model_name, texture_name, instance_count, Instance_Format_Of<T>::format);
+            return std::span<T>(reinterpret_cast<T*>(instance_data.data()), instance_data.size() / sizeof(T));
+        }
+
+        template<typename T>
+        std::span<T> begin_instances(const Model_Handle model, const Texture_Handle texture, const uint32_t instance_count)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Instance data is written directly to GPU memory and has to be trivially copyable.");
+
+            std::span<std::byte> instance_data = begin_instances(model, texture, instance_count, Instance_Format_Of<T>::format);
+            return std::span<T>(reinterpret_cast<T*>(instance_data.data()), instance_data.size() / sizeof(T));
+        }
+
+        void end_instances();
+
+        /// <summary>
+        /// Creates a retained set of instances for static or mostly static scenery.
+        /// The model matrices are stored in GPU memory and stay there across frames, only ranges changed with update_instances() are uploaded.
+        /// Throws when the model or texture is not loaded.
+        /// </summary>
+        /// <param name="initial_capacity">Amount of instances to reserve GPU memory for, the set grows when more are written.</param>
+        Instance_Set_Handle create_instance_set(const std::string& model_name, const std::string& texture_name, const uint32_t initial_capacity = 0);
+        Instance_Set_Handle create_instance_set(const Model_Handle model, const Texture_Handle texture, const uint32_t initial_capacity = 0);
 
-        void load_model(const std::string& model_name, const std::filesystem::path& path);
-        void load_texture(const std::string& texture_name, const std::filesystem::path& path);
-        void load_texture_array(const std::string& texture_name, const std::vector<std::filesystem::path>& paths);
+        /// <summary>
+        /// Destroys the instance set, its GPU memory is released once the frames in flight are finished.
+        /// </summary>
+        void destroy_instance_set(const Instance_Set_Handle handle);
+
+        /// <summary>
+        /// Overwrite the model matrices of instances [first, first + model_matrices.size()), writing past the end adds instances to the set.
+        /// Call this between start_draw() and end_draw() to upload the range with the frame, calls outside a frame upload immediately (and block).
+        /// </summary>
+        void update_instances(const Instance_Set_Handle handle, const uint32_t first, std::span<const glm::mat4> model_matrices);
+
+        /// <summary>
+        /// Draws all instances of the set, without uploading any instance data.
+        /// </summary>
+        void draw_instance_set(const Instance_Set_Handle handle);
+
+        /// <summary>
+        /// Loading returns a handle that can be passed to the draw functions instead of the name, which avoids the name lookups.
+        /// Loading a name that is already loaded returns the handle of the loaded resource.
+        /// Textures are decoded to RGBA8 with a generated mip chain, KTX2 and DDS files with BC1, BC3 or BC7 data are uploaded as stored instead
+        /// (decompressed to RGBA8 when the device lacks BC support). Each array layer of such a file becomes a layer of a texture array.
+        /// </summary>
+        Model_Handle load_model(const std::string& model_name, const std::filesystem::path& path);
+        Texture_Handle load_texture(const std::string& texture_name, const std::filesystem::path& path);
+        Texture_Array_Handle load_texture_array(const std::string& texture_name, const std::vector<std::filesystem::path>& paths);
 
+        /// <summary>
+        /// Loads without stalling the calling thread: the file is parsed or decoded on a background thread and uploaded to the GPU in a later start_draw(),
+        /// at most a few loads per frame and without waiting for the copies. The future becomes ready in the first start_draw() that finds the upload finished,
+        /// once the resource can be drawn, and holds its handle (get() rethrows a failed load).
+        /// Call from the render thread, the same thread that calls start_draw().
+        /// </summary>
+        std::shared_future<Model_Handle> load_model_async(const std::string& model_name, const std::filesystem::path& path);
+        std::shared_future<Texture_Handle> load_texture_async(const std::string& texture_name, const std::filesystem::path& path);
+
+        /// <summary>
+        /// Directory of the compressed texture cache (default "texture_cache"), filled offline with vulvox_texture_compressor.
+        /// Texture loads of PNG/JPG files use the cached KTX2 version when the cache holds one for the current file contents. An empty path disables the cache.
+        /// </summary>
+        void set_texture_cache_directory(const std::filesystem::path& directory);
+
+        /// <summary>
+        /// Blocks until every async load is finished and uploaded, skipped between start_draw() and end_draw().
+        /// Loads uploaded into an open upload batch only become ready in its end_upload_batch().
+        /// </summary>
+        void wait_for_async_loads();
+
+        /// <summary>
+        /// Collects the GPU uploads of all loads between these calls and submits them at once with a single fence wait in end_upload_batch(),
+        /// e.g. around the loading of a level. Resources loaded in the batch can only be drawn after end_upload_batch(),
+        /// the futures of async loads uploaded while the batch is open become ready there as well.
+        /// The copies run on a dedicated transfer queue when the device has one.
+        /// </summary>
+        void begin_upload_batch();
+        void end_upload_batch();
+
+        /// <summary>
+        /// Unloading waits for the GPU to be idle and invalidates the handles to the resource, it is skipped between start_draw() and end_draw().
+        /// </summary>
         void unload_model(const std::string& name);
+        void unload_model(const Model_Handle model);
         void unload_texture(const std::string& name);
+        void unload_texture(const Texture_Handle texture);
         void unload_texture_array(const std::string& name);
+        void unload_texture_array(const Texture_Array_Handle texture_array);
 
         void set_model_matrix(const glm::mat4& new_model_matrix);
         void set_view_matrix(const glm::mat4& new_view_matrix);
@@ -75,8 +252,82 @@ namespace vulvox
 
         std::string get_memory_statistics() const;
 
+        /// <summary>
+        /// Returns the statistics of the last frame that was completed with end_draw().
+        /// </summary>
+        Frame_Statistics get_frame_statistics() const;
+
+        /// <summary>
+        /// Amount of frames in flight chosen at init, and the per-frame resource slot the current (or next) frame uses.
+        /// The slot advances by one every end_draw() and wraps at the frames in flight.
+        /// </summary>
+        uint32_t get_frames_in_flight() const;
+        uint32_t get_current_frame_index() const;
+
+        /// <summary>
+        /// Enables GPU timestamp queries around the render pass and every draw call.
+        /// When Dear ImGui is initialized the timings are also shown in an overlay panel.
+        /// </summary>
+        void set_gpu_profiling(const bool enable);
+
+        /// <summary>
+        /// Returns the GPU timings of the most recent frame that finished on the GPU (frames in flight frames behind the current frame).
+        /// </summary>
+        GPU_Frame_Timings get_gpu_timings() const;
+
+        /// <summary>
+        /// Enables frustum culling of instanced draws in a compute shader (draw_instanced, draw_instanced_with_texture_array, begin_instances and instance sets).
+        /// Only the visible instances reach the vertex shader, their draw order is no longer deterministic.
+        /// Compact instance formats are not culled. Ignored when the culling shader is not available.
+        /// </summary>
+        void set_gpu_culling(const bool enable);
+        bool is_gpu_culling_enabled() const;
+
+        /// <summary>
+        /// Enables frustum culling of draw_instanced, draw_instanced_with_texture_array and draw_planes on the CPU.
+        /// The instances are tested on a worker thread pool and only the visible ones are written to the instance buffer, which also reduces the upload.
+        /// Can be combined with GPU culling, the culled instance count is reported in the frame statistics.
+        /// </summary>
+        void set_cpu_culling(const bool enable);
+        bool is_cpu_culling_enabled() const;
+
+        /// <summary>
+        /// Enabled by default, draw_model calls of the same model and texture in a frame (at least 4 on the same thread) are merged into one instanced draw.
+        /// Their model matrices are gathered in the frame's instance buffer instead of being pushed as push constants one draw at a time.
+        /// </summary>
+        void set_auto_instancing(const bool enable);
+        bool is_auto_instancing_enabled() const;
+
+        /// <summary>
+        /// Enables recording draw calls from multiple threads, every worker records into its own secondary command buffer.
+        /// 0 (default) records single threaded into the primary command buffer. Only change the worker count outside of start_draw/end_draw.
+        /// The draws of the render thread are executed first, then those of the workers in worker order and the user interface last.
+        /// </summary>
+        void set_recording_workers(const uint32_t worker_count);
+        uint32_t get_recording_workers() const;
+
+        /// <summary>
+        /// Binds the calling thread to worker [0, worker_count), all draw_* calls of the thread are then recorded into that worker's command buffer.
+        /// Call between start_draw and end_draw and end every worker before end_draw, a worker can only be bound to one thread at a time.
+        /// Instance sets, assets and captures are still created, updated and requested on the render thread.
+        /// </summary>
+        void begin_worker_recording(const uint32_t worker);
+        void end_worker_recording();
+
+        /// <summary>
+        /// Writes the recorded CPU profiling events (start_draw, end_draw, buffer and asset functions) as Chrome trace_event JSON.
+        /// Only available when the library is built with the VULVOX_ENABLE_CPU_PROFILING CMake option (ENABLE_CPU_PROFILING define).
+        /// Returns false when profiling is disabled or the file could not be written.
+        /// </summary>
+        bool write_cpu_trace(const std::filesystem::path& path) const;
+
     private:
 
+        std::span<std::byte> begin_instances(const std::string& model_name, const std::string& texture_name, const uint32_t instance_count, const Instance_Format format);
+        std::span<std::byte> begin_instances(const Model_Handle model, const Texture_Handle texture, const uint32_t instance_count, const Instance_Format format);
+        void draw_instanced(const std::string& model_name, const std::string& texture_name, const Instance_Format format, std::span<const std::byte> instance_data);
+        void draw_instanced(const Model_Handle model, const Texture_Handle texture, const Instance_Format format, std::span<const std::byte> instance_data);
+
         //Uses Unique_Ptr to vulkan_engine to hide implementation details (pimpl pattern)
         std::unique_ptr<Vulkan_Engine> vulkan_engine;
     };
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vulvox
+{
+    /// <summary>
+    /// Handle to a loaded model, returned by Renderer::load_model().
+    /// Drawing with a handle skips the name lookups of the string based draw functions.
+    /// A handle becomes invalid when its model is unloaded, draw calls with an invalid handle are skipped.
+    /// </summary>
+    struct Model_Handle
+    {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+
+        bool is_valid() const { return index != UINT32_MAX; }
+    };
+
+    /// <summary>
+    /// Handle to a loaded texture, returned by Renderer::load_texture().
+    /// </summary>
+    struct Texture_Handle
+    {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+
+        bool is_valid() const { return index != UINT32_MAX; }
+    };
+
+    /// <summary>
+    /// Handle to a loaded texture array, returned by Renderer::load_texture_array().
+    /// </summary>
+    struct Texture_Array_Handle
+    {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+
+        bool is_valid() const { return index != UINT32_MAX; }
+    };
+}
\ No newline at end of file
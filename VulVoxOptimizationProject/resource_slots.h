@@ -0,0 +1,145 @@
+#pragma once
+
+namespace vulvox
+{
+    /// <summary>
+    /// Dense array of named resources that are addressed by a generational handle (index + generation).
+    /// A handle lookup is a bounds and generation check, only the name based functions hash strings.
+    /// Slots of erased resources are reused with a new generation, so handles to the old resource are rejected.
+    /// </summary>
+    template<typename Resource, typename Handle>
+    class Resource_Slots
+    {
+    public:
+
+        /// <summary>
+        /// Store a resource under a name that is not in use yet.
+        /// </summary>
+        Handle insert(const std::string& name, Resource resource)
+        {
+            uint32_t index = 0;
+
+            if (!free_slots.empty())
+            {
+                index = free_slots.back();
+                free_slots.pop_back();
+            }
+            else
+            {
+                index = static_cast<uint32_t>(slots.size());
+                slots.emplace_back();
+            }
+
+            Slot& slot = slots[index];
+            slot.resource = std::move(resource);
+            slot.name = name;
+            slot.in_use = true;
+
+            names.emplace(name, index);
+
+            return Handle{ index, slot.generation };
+        }
+
+        /// <summary>
+        /// Remove the resource, the caller destroys it first. Invalidates every handle to it.
+        /// </summary>
+        void erase(const Handle handle)
+        {
+            if (get(handle) == nullptr)
+            {
+                return;
+            }
+
+            Slot& slot = slots[handle.index];
+            names.erase(slot.name);
+
+            slot.resource = Resource{};
+            slot.name.clear();
+            slot.in_use = false;
+            slot.generation++;
+
+            free_slots.push_back(handle.index);
+        }
+
+        /// <summary>
+        /// Returns nullptr when the handle is invalid or refers to an erased resource.
+        /// </summary>
+        Resource* get(const Handle handle)
+        {
+            if (handle.index >= slots.size() || !slots[handle.index].in_use || slots[handle.index].generation != handle.generation)
+            {
+                return nullptr;
+            }
+
+            return &slots[handle.index].resource;
+        }
+
+        const Resource* get(const Handle handle) const
+        {
+            return const_cast<Resource_Slots*>(this)->get(handle);
+        }
+
+        /// <summary>
+        /// Returns an invalid handle when no resource with the name exists.
+        /// </summary>
+        Handle find(const std::string& name) const
+        {
+            auto it = names.find(name);
+
+            if (it == names.end())
+            {
+                return Handle{};
+            }
+
+            return Handle{ it->second, slots[it->second].generation };
+        }
+
+        bool contains(const std::string& name) const
+        {
+            return names.contains(name);
+        }
+
+        /// <summary>
+        /// Name the resource was stored under, only call with a valid handle.
+        /// </summary>
+        const std::string& get_name(const Handle handle) const
+        {
+            return slots[handle.index].name;
+        }
+
+        template<typename Function>
+        void for_each(Function function)
+        {
+            for (auto& slot : slots)
+            {
+                if (slot.in_use)
+                {
+                    function(slot.resource);
+                }
+            }
+        }
+
+        void clear()
+        {
+            slots.clear();
+            free_slots.clear();
+            names.clear();
+        }
+
+    private:
+
+        struct Slot
+        {
+            Resource resource{};
+            std::string name;
+            uint32_t generation = 0;
+            bool in_use = false;
+        };
+
+        std::vector<Slot> slots;
+        std::vector<uint32_t> free_slots;
+
+        //Only used by the string based functions
+        std::unordered_map<std::string, uint32_t> names;
+    };
+}
\ No newline at end of file
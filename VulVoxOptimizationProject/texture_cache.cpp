@@ -0,0 +1,171 @@
+#include "pch.h"
+#include "texture_cache.h"
+
+namespace vulvox
+{
+    Texture_Cache::Texture_Cache(const std::filesystem::path& directory) : directory(directory)
+    {
+    }
+
+    void Texture_Cache::set_directory(const std::filesystem::path& directory)
+    {
+        this->directory = directory;
+    }
+
+    const std::filesystem::path& Texture_Cache::get_directory() const
+    {
+        return directory;
+    }
+
+    std::filesystem::path Texture_Cache::resolve(const std::filesystem::path& texture_path) const
+    {
+        //Precompressed files are used as they are
+        if (directory.empty() || Texture_File::is_compressed_texture_path(texture_path))
+        {
+            return texture_path;
+        }
+
+        std::error_code error;
+
+        if (!std::filesystem::is_directory(directory, error))
+        {
+            return texture_path;
+        }
+
+        VULVOX_PROFILE_SCOPE("Texture_Cache::resolve");
+
+        try
+        {
+            std::filesystem::path entry_path = get_entry_path(texture_path);
+
+            if (std::filesystem::is_regular_file(entry_path, error))
+            {
+                return entry_path;
+            }
+        }
+        catch (const std::exception&)
+        {
+            //Unreadable source, the decode reports the error
+        }
+
+        return texture_path;
+    }
+
+    std::filesystem::path Texture_Cache::get_entry_path(const std::filesystem::path& texture_path) const
+    {
+        std::ostringstream file_name;
+        file_name << std::hex;
+        file_name.width(16);
+        file_name.fill('0');
+        file_name << hash_file(texture_path);
+
+        return directory / (file_name.str() + ".ktx2");
+    }
+
+    std::filesystem::path Texture_Cache::store(const std::filesystem::path& texture_path, const Texture_Compression compression) const
+    {
+        return store(texture_path, compression, nullptr);
+    }
+
+    std::filesystem::path Texture_Cache::store(const std::filesystem::path& texture_path, const Texture_Compression compression, Thread_Pool* thread_pool) const
+    {
+        if (directory.empty())
+        {
+            throw std::runtime_error("Failed to store texture, no texture cache directory set!");
+        }
+
+        if (Texture_File::is_compressed_texture_path(texture_path))
+        {
+            throw std::runtime_error("Failed to store texture, it is already compressed! Path was: " + texture_path.string());
+        }
+
+        Image_Data image_data = Image::decode_texture(texture_path);
+        Compressed_Image_Data compressed_data = Texture_Compressor::compress(image_data.pixels.get(), image_data.width, image_data.height, compression, thread_pool);
+
+        std::filesystem::create_directories(directory);
+
+        std::filesystem::path entry_path = get_entry_path(texture_path);
+        Texture_File::save_ktx2(entry_path, compressed_data);
+
+        return entry_path;
+    }
+
+    uint32_t Texture_Cache::store_all(std::span<const std::filesystem::path> texture_paths, const Texture_Compression compression, const uint32_t thread_count, const bool overwrite) const
+    {
+        VULVOX_PROFILE_SCOPE("Texture_Cache::store_all");
+
+        Thread_Pool thread_pool(thread_count);
+        std::atomic<uint32_t> stored_count = 0;
+        std::mutex output_mutex;
+
+        auto store_texture = [&](const std::filesystem::path& texture_path, Thread_Pool* texture_thread_pool)
+            {
+                try
+                {
+                    if (!overwrite && std::filesystem::is_regular_file(get_entry_path(texture_path)))
+                    {
+                        return;
+                    }
+
+                    std::filesystem::path entry_path = store(texture_path, compression, texture_thread_pool);
+                    stored_count++;
+
+                    std::scoped_lock lock(output_mutex);
+                    std::cout << texture_path.string() << " -> " << entry_path.string() << std::endl;
+                }
+                catch (const std::exception& exception)
+                {
+                    std::scoped_lock lock(output_mutex);
+                    std::cout << "Skipped texture: " << exception.what() << std::endl;
+                }
+            };
+
+        //Parallel over the textures when there are enough of them, otherwise over the block rows of each texture.
+        //Never both, a parallel_for inside a parallel_for batch can wait on workers that are all busy with the outer batches.
+        if (texture_paths.size() > thread_pool.get_thread_count())
+        {
+            thread_pool.parallel_for(texture_paths.size(), 1, [&](size_t begin, size_t end, uint32_t)
+                {
+                    for (size_t i = begin; i < end; i++)
+                    {
+                        store_texture(texture_paths[i], nullptr);
+                    }
+                });
+        }
+        else
+        {
+            for (const auto& texture_path : texture_paths)
+            {
+                store_texture(texture_path, &thread_pool);
+            }
+        }
+
+        return stored_count;
+    }
+
+    uint64_t Texture_Cache::hash_file(const std::filesystem::path& file_path)
+    {
+        std::ifstream file(file_path, std::ios::binary);
+
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Failed to open file! Path was: " + file_path.string());
+        }
+
+        uint64_t hash = 14695981039346656037ull;
+        std::array<char, 64 * 1024> buffer;
+
+        while (file)
+        {
+            file.read(buffer.data(), buffer.size());
+
+            for (std::streamsize i = 0; i < file.gcount(); i++)
+            {
+                hash ^= static_cast<unsigned char>(buffer[i]);
+                hash *= 1099511628211ull;
+            }
+        }
+
+        return hash;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace vulvox
+{
+    class Thread_Pool; //Forward declaration, only used internally
+
+    /// <summary>
+    /// Block compression used for the cached version of a texture.
+    /// BC1 (4 bits per texel) suits opaque textures or textures with cut-out alpha, BC7 (8 bits per texel) keeps smooth alpha and has fewer artifacts.
+    /// </summary>
+    enum class Texture_Compression
+    {
+        BC1,
+        BC7
+    };
+
+    /// <summary>
+    /// On-disk store of block compressed (KTX2) versions of PNG/JPG textures, keyed by a hash of the source file contents.
+    /// The entries are created offline (vulvox_texture_compressor or store_all), texture loads then use the entry of a source when it exists.
+    /// Editing a source changes its hash, so stale entries are never used. A cache that does not exist on disk is skipped without hashing anything.
+    /// </summary>
+    class Texture_Cache
+    {
+    public:
+
+        Texture_Cache() = default;
+        explicit Texture_Cache(const std::filesystem::path& directory);
+
+        /// <summary>
+        /// An empty directory disables the cache.
+        /// </summary>
+        void set_directory(const std::filesystem::path& directory);
+        const std::filesystem::path& get_directory() const;
+
+        /// <summary>
+        /// Returns the cache entry of the texture when there is one, the texture path itself otherwise. Thread safe.
+        /// </summary>
+        std::filesystem::path resolve(const std::filesystem::path& texture_path) const;
+
+        /// <summary>
+        /// Path of the entry for the current contents of the texture, whether it exists or not.
+        /// </summary>
+        std::filesystem::path get_entry_path(const std::filesystem::path& texture_path) const;
+
+        /// <summary>
+        /// Decodes the texture, compresses it including a full mip chain and writes the entry (overwriting an existing one).
+        /// Returns the entry path.
+        /// </summary>
+        std::filesystem::path store(const std::filesystem::path& texture_path, const Texture_Compression compression) const;
+
+        /// <summary>
+        /// Stores many textures at once on thread_count worker threads (0 uses all cores), small textures are compressed in parallel
+        /// and large ones are split into rows of blocks. Textures that already have an entry are skipped unless overwrite is set.
+        /// Textures that fail to load are reported and skipped, returns the amount of written entries.
+        /// </summary>
+        uint32_t store_all(std::span<const std::filesystem::path> texture_paths, const Texture_Compression compression, const uint32_t thread_count = 0, const bool overwrite = false) const;
+
+        /// <summary>
+        /// 64-bit FNV-1a hash of the file contents.
+        /// </summary>
+        static uint64_t hash_file(const std::filesystem::path& file_path);
+
+        //Relative to the working directory, the same directory the texture paths are usually relative to
+        static constexpr const char* DEFAULT_DIRECTORY = "texture_cache";
+
+    private:
+
+        std::filesystem::path store(const std::filesystem::path& texture_path, const Texture_Compression compression, Thread_Pool* thread_pool) const;
+
+        std::filesystem::path directory;
+    };
+}
\ No newline at end of file
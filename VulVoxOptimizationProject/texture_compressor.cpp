@@ -0,0 +1,583 @@
+#include "pch.h"
+#include "texture_compressor.h"
+
+//SSE is part of every x64 target, other architectures use the scalar projection
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VULVOX_COMPRESS_SSE
+#include <immintrin.h>
+#endif
+
+namespace vulvox
+{
+    //The 16 texels of a block as structure of arrays, channels in [0, 255]
+    struct Block_Texels
+    {
+        alignas(16) float channels[4][16];
+    };
+
+    static Block_Texels load_block_texels(const unsigned char* texels)
+    {
+        Block_Texels block_texels;
+
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                block_texels.channels[c][i] = static_cast<float>(texels[i * 4 + c]);
+            }
+        }
+
+        return block_texels;
+    }
+
+    //Line through the texel colors along their principal axis, the endpoints are the outermost texels projected onto it
+    static void fit_endpoints(const Block_Texels& block_texels, const uint32_t channel_count, std::array<float, 4>& endpoint_0, std::array<float, 4>& endpoint_1)
+    {
+        std::array<float, 4> mean{};
+        std::array<float, 4> minimum{ 255.0f, 255.0f, 255.0f, 255.0f };
+        std::array<float, 4> maximum{};
+
+        for (uint32_t c = 0; c < channel_count; c++)
+        {
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                float value = block_texels.channels[c][i];
+                mean[c] += value;
+                minimum[c] = std::min(minimum[c], value);
+                maximum[c] = std::max(maximum[c], value);
+            }
+
+            mean[c] /= 16.0f;
+        }
+
+        float covariance[4][4]{};
+
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            for (uint32_t a = 0; a < channel_count; a++)
+            {
+                for (uint32_t b = 0; b < channel_count; b++)
+                {
+                    covariance[a][b] += (block_texels.channels[a][i] - mean[a]) * (block_texels.channels[b][i] - mean[b]);
+                }
+            }
+        }
+
+        //Power iteration, starting along the bounding box diagonal
+        std::array<float, 4> axis{};
+
+        for (uint32_t c = 0; c < channel_count; c++)
+        {
+            axis[c] = maximum[c] - minimum[c];
+        }
+
+        for (uint32_t iteration = 0; iteration < 8; iteration++)
+        {
+            std::array<float, 4> next{};
+            float length_squared = 0.0f;
+
+            for (uint32_t a = 0; a < channel_count; a++)
+            {
+                for (uint32_t b = 0; b < channel_count; b++)
+                {
+                    next[a] += covariance[a][b] * axis[b];
+                }
+
+                length_squared += next[a] * next[a];
+            }
+
+            if (length_squared < 1e-12f)
+            {
+                break;
+            }
+
+            float inverse_length = 1.0f / std::sqrt(length_squared);
+
+            for (uint32_t c = 0; c < channel_count; c++)
+            {
+                axis[c] = next[c] * inverse_length;
+            }
+        }
+
+        float axis_length_squared = 0.0f;
+
+        for (uint32_t c = 0; c < channel_count; c++)
+        {
+            axis_length_squared += axis[c] * axis[c];
+        }
+
+        //A single color block
+        if (axis_length_squared < 1e-12f)
+        {
+            endpoint_0 = endpoint_1 = mean;
+            return;
+        }
+
+        float inverse_length = 1.0f / std::sqrt(axis_length_squared);
+        float minimum_projection = std::numeric_limits<float>::max();
+        float maximum_projection = std::numeric_limits<float>::lowest();
+
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            float projection = 0.0f;
+
+            for (uint32_t c = 0; c < channel_count; c++)
+            {
+                projection += (block_texels.channels[c][i] - mean[c]) * axis[c] * inverse_length;
+            }
+
+            minimum_projection = std::min(minimum_projection, projection);
+            maximum_projection = std::max(maximum_projection, projection);
+        }
+
+        for (uint32_t c = 0; c < 4; c++)
+        {
+            float direction = c < channel_count ? axis[c] * inverse_length : 0.0f;
+            endpoint_0[c] = std::clamp(mean[c] + direction * minimum_projection, 0.0f, 255.0f);
+            endpoint_1[c] = std::clamp(mean[c] + direction * maximum_projection, 0.0f, 255.0f);
+        }
+    }
+
+    //Projects every texel onto the line from endpoint_0 to endpoint_1 and rounds its position to an index in [0, max_index]
+    static void project_to_indices(const Block_Texels& block_texels, const uint32_t channel_count, const std::array<float, 4>& endpoint_0, const std::array<float, 4>& endpoint_1, const uint32_t max_index, std::array<int32_t, 16>& indices)
+    {
+        std::array<float, 4> direction{};
+        float length_squared = 0.0f;
+
+        for (uint32_t c = 0; c < channel_count; c++)
+        {
+            direction[c] = endpoint_1[c] - endpoint_0[c];
+            length_squared += direction[c] * direction[c];
+        }
+
+        if (length_squared < 1e-6f)
+        {
+            indices.fill(0);
+            return;
+        }
+
+        //Scaled so the projection is the index directly
+        float offset = 0.0f;
+
+        for (uint32_t c = 0; c < channel_count; c++)
+        {
+            direction[c] *= static_cast<float>(max_index) / length_squared;
+            offset -= endpoint_0[c] * direction[c];
+        }
+
+        uint32_t i = 0;
+
+#if defined(VULVOX_COMPRESS_SSE)
+        //4 texels per iteration, rounded to nearest by the conversion
+        __m128 max_value = _mm_set1_ps(static_cast<float>(max_index));
+
+        for (; i < 16; i += 4)
+        {
+            __m128 position = _mm_set1_ps(offset);
+
+            for (uint32_t c = 0; c < channel_count; c++)
+            {
+                position = _mm_add_ps(position, _mm_mul_ps(_mm_load_ps(block_texels.channels[c] + i), _mm_set1_ps(direction[c])));
+            }
+
+            position = _mm_min_ps(_mm_max_ps(position, _mm_setzero_ps()), max_value);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(indices.data() + i), _mm_cvtps_epi32(position));
+        }
+#endif
+
+        //All texels without SIMD support
+        for (; i < 16; i++)
+        {
+            float position = offset;
+
+            for (uint32_t c = 0; c < channel_count; c++)
+            {
+                position += block_texels.channels[c][i] * direction[c];
+            }
+
+            indices[i] = static_cast<int32_t>(std::nearbyint(std::clamp(position, 0.0f, static_cast<float>(max_index))));
+        }
+    }
+
+    static uint16_t to_rgb565(const std::array<float, 4>& color)
+    {
+        uint32_t r = static_cast<uint32_t>(std::lround(color[0] * 31.0f / 255.0f));
+        uint32_t g = static_cast<uint32_t>(std::lround(color[1] * 63.0f / 255.0f));
+        uint32_t b = static_cast<uint32_t>(std::lround(color[2] * 31.0f / 255.0f));
+
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    //Same bit replication as the decoder, so the indices are chosen against the colors that will be decoded
+    static std::array<float, 4> from_rgb565(const uint16_t color)
+    {
+        uint32_t r = (color >> 11) & 0x1F;
+        uint32_t g = (color >> 5) & 0x3F;
+        uint32_t b = color & 0x1F;
+
+        return { static_cast<float>((r << 3) | (r >> 2)), static_cast<float>((g << 2) | (g >> 4)), static_cast<float>((b << 3) | (b >> 2)), 255.0f };
+    }
+
+    void Texture_Compressor::encode_bc1_block(const unsigned char* texels, unsigned char* block)
+    {
+        Block_Texels block_texels = load_block_texels(texels);
+
+        std::array<bool, 16> transparent{};
+        std::array<float, 3> opaque_mean{};
+        uint32_t opaque_count = 0;
+
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            transparent[i] = texels[i * 4 + 3] < 128;
+
+            if (!transparent[i])
+            {
+                opaque_count++;
+
+                for (uint32_t c = 0; c < 3; c++)
+                {
+                    opaque_mean[c] += block_texels.channels[c][i];
+                }
+            }
+        }
+
+        std::array<int32_t, 16> indices{};
+        uint16_t color_0 = 0;
+        uint16_t color_1 = 0;
+
+        if (opaque_count == 0)
+        {
+            //Three color mode with every texel transparent black
+            indices.fill(3);
+        }
+        else
+        {
+            //Transparent texels are moved to the mean of the opaque ones, so they don't pull the endpoints
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                for (uint32_t c = 0; c < 3 && transparent[i]; c++)
+                {
+                    block_texels.channels[c][i] = opaque_mean[c] / static_cast<float>(opaque_count);
+                }
+            }
+
+            std::array<float, 4> endpoint_0;
+            std::array<float, 4> endpoint_1;
+            fit_endpoints(block_texels, 3, endpoint_0, endpoint_1);
+
+            color_0 = to_rgb565(endpoint_0);
+            color_1 = to_rgb565(endpoint_1);
+
+            if (opaque_count == 16)
+            {
+                //Four color mode needs color_0 > color_1, palette order is color_0, color_1, 1/3 and 2/3
+                if (color_0 < color_1)
+                {
+                    std::swap(color_0, color_1);
+                }
+
+                if (color_0 != color_1)
+                {
+                    project_to_indices(block_texels, 3, from_rgb565(color_0), from_rgb565(color_1), 3, indices);
+
+                    constexpr std::array<int32_t, 4> PALETTE_INDEX = { 0, 2, 3, 1 };
+
+                    for (auto& index : indices)
+                    {
+                        index = PALETTE_INDEX[index];
+                    }
+                }
+            }
+            else
+            {
+                //Three color mode needs color_0 <= color_1, palette order is color_0, color_1, 1/2 and transparent black
+                if (color_0 > color_1)
+                {
+                    std::swap(color_0, color_1);
+                }
+
+                project_to_indices(block_texels, 3, from_rgb565(color_0), from_rgb565(color_1), 2, indices);
+
+                constexpr std::array<int32_t, 3> PALETTE_INDEX = { 0, 2, 1 };
+
+                for (uint32_t i = 0; i < 16; i++)
+                {
+                    indices[i] = transparent[i] ? 3 : PALETTE_INDEX[indices[i]];
+                }
+            }
+        }
+
+        uint32_t packed_indices = 0;
+
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            packed_indices |= static_cast<uint32_t>(indices[i]) << (i * 2);
+        }
+
+        block[0] = static_cast<unsigned char>(color_0 & 0xFF);
+        block[1] = static_cast<unsigned char>(color_0 >> 8);
+        block[2] = static_cast<unsigned char>(color_1 & 0xFF);
+        block[3] = static_cast<unsigned char>(color_1 >> 8);
+
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            block[4 + i] = static_cast<unsigned char>(packed_indices >> (i * 8));
+        }
+    }
+
+    //Rounds a mode 6 endpoint to 7 bits per channel plus the shared p-bit that reconstructs it closest
+    static void quantize_bc7_endpoint(const std::array<float, 4>& endpoint, std::array<uint32_t, 4>& quantized, uint32_t& p_bit)
+    {
+        float best_error = std::numeric_limits<float>::max();
+
+        for (uint32_t p = 0; p < 2; p++)
+        {
+            std::array<uint32_t, 4> candidate{};
+            float error = 0.0f;
+
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                candidate[c] = static_cast<uint32_t>(std::clamp(std::lround((endpoint[c] - p) / 2.0f), 0l, 127l));
+
+                float difference = static_cast<float>((candidate[c] << 1) | p) - endpoint[c];
+                error += difference * difference;
+            }
+
+            if (error < best_error)
+            {
+                best_error = error;
+                quantized = candidate;
+                p_bit = p;
+            }
+        }
+    }
+
+    //Writes the 128 bit block from the least significant bit up
+    struct BC7_Bit_Writer
+    {
+        unsigned char* block;
+        uint32_t position = 0;
+
+        void write(const uint32_t value, const uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i++, position++)
+            {
+                block[position >> 3] |= static_cast<unsigned char>(((value >> i) & 1u) << (position & 7));
+            }
+        }
+    };
+
+    void Texture_Compressor::encode_bc7_block(const unsigned char* texels, unsigned char* block)
+    {
+        Block_Texels block_texels = load_block_texels(texels);
+
+        std::array<float, 4> endpoint_0;
+        std::array<float, 4> endpoint_1;
+        fit_endpoints(block_texels, 4, endpoint_0, endpoint_1);
+
+        std::array<uint32_t, 4> quantized_0{};
+        std::array<uint32_t, 4> quantized_1{};
+        uint32_t p_bit_0 = 0;
+        uint32_t p_bit_1 = 0;
+
+        quantize_bc7_endpoint(endpoint_0, quantized_0, p_bit_0);
+        quantize_bc7_endpoint(endpoint_1, quantized_1, p_bit_1);
+
+        //Indices against the endpoints as they will be decoded (7 bits and the p-bit make 8 bits, no expansion)
+        std::array<float, 4> decoded_0{};
+        std::array<float, 4> decoded_1{};
+
+        for (uint32_t c = 0; c < 4; c++)
+        {
+            decoded_0[c] = static_cast<float>((quantized_0[c] << 1) | p_bit_0);
+            decoded_1[c] = static_cast<float>((quantized_1[c] << 1) | p_bit_1);
+        }
+
+        std::array<int32_t, 16> indices{};
+        project_to_indices(block_texels, 4, decoded_0, decoded_1, 15, indices);
+
+        //The first texel stores its index without the highest bit, swapping the endpoints mirrors the (symmetric) weights
+        if (indices[0] >= 8)
+        {
+            std::swap(quantized_0, quantized_1);
+            std::swap(p_bit_0, p_bit_1);
+
+            for (auto& index : indices)
+            {
+                index = 15 - index;
+            }
+        }
+
+        memset(block, 0, 16);
+        BC7_Bit_Writer writer{ block };
+
+        writer.write(1u << 6, 7); //Mode 6
+
+        for (uint32_t c = 0; c < 4; c++)
+        {
+            writer.write(quantized_0[c], 7);
+            writer.write(quantized_1[c], 7);
+        }
+
+        writer.write(p_bit_0, 1);
+        writer.write(p_bit_1, 1);
+
+        writer.write(static_cast<uint32_t>(indices[0]), 3);
+
+        for (uint32_t i = 1; i < 16; i++)
+        {
+            writer.write(static_cast<uint32_t>(indices[i]), 4);
+        }
+    }
+
+    Compressed_Image_Data Texture_Compressor::compress(const unsigned char* rgba_pixels, const uint32_t width, const uint32_t height, const Texture_Compression compression, Thread_Pool* thread_pool)
+    {
+        VULVOX_PROFILE_SCOPE("Texture_Compressor::compress");
+
+        //sRGB like the uncompressed textures
+        Compressed_Image_Data image_data{};
+        image_data.format = compression == Texture_Compression::BC1 ? VK_FORMAT_BC1_RGBA_SRGB_BLOCK : VK_FORMAT_BC7_SRGB_BLOCK;
+        image_data.width = width;
+        image_data.height = height;
+        image_data.layer_count = 1;
+        image_data.mip_levels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+
+        std::vector<unsigned char> level_pixels(rgba_pixels, rgba_pixels + static_cast<size_t>(width) * height * 4);
+        uint32_t level_width = width;
+        uint32_t level_height = height;
+
+        for (uint32_t level = 0; level < image_data.mip_levels; level++)
+        {
+            VkDeviceSize offset = image_data.blocks.size();
+            image_data.blocks.resize(offset + Texture_File::get_level_size(image_data, level));
+
+            encode_level(level_pixels, level_width, level_height, compression, image_data.blocks.data() + offset, thread_pool);
+            Texture_File::add_region(image_data, offset, level, 0);
+
+            if (level + 1 < image_data.mip_levels)
+            {
+                level_pixels = downsample(level_pixels, level_width, level_height);
+                level_width = std::max(level_width / 2, 1u);
+                level_height = std::max(level_height / 2, 1u);
+            }
+        }
+
+        return image_data;
+    }
+
+    void Texture_Compressor::encode_level(const std::vector<unsigned char>& pixels, const uint32_t width, const uint32_t height, const Texture_Compression compression, unsigned char* blocks, Thread_Pool* thread_pool)
+    {
+        uint32_t blocks_x = (width + 3) / 4;
+        uint32_t blocks_y = (height + 3) / 4;
+        uint32_t block_size = compression == Texture_Compression::BC1 ? 8 : 16;
+
+        auto encode_rows = [&](size_t begin, size_t end, uint32_t)
+            {
+                std::array<unsigned char, 64> texels{};
+
+                for (size_t block_y = begin; block_y < end; block_y++)
+                {
+                    for (uint32_t block_x = 0; block_x < blocks_x; block_x++)
+                    {
+                        //Blocks past the right or bottom edge repeat the edge texels
+                        for (uint32_t y = 0; y < 4; y++)
+                        {
+                            for (uint32_t x = 0; x < 4; x++)
+                            {
+                                size_t pixel_x = std::min<size_t>(block_x * 4 + x, width - 1);
+                                size_t pixel_y = std::min<size_t>(block_y * 4 + y, height - 1);
+
+                                memcpy(texels.data() + (y * 4 + x) * 4, pixels.data() + (pixel_y * width + pixel_x) * 4, 4);
+                            }
+                        }
+
+                        unsigned char* block = blocks + (block_y * blocks_x + block_x) * block_size;
+
+                        if (compression == Texture_Compression::BC1)
+                        {
+                            encode_bc1_block(texels.data(), block);
+                        }
+                        else
+                        {
+                            encode_bc7_block(texels.data(), block);
+                        }
+                    }
+                }
+            };
+
+        if (thread_pool != nullptr)
+        {
+            thread_pool->parallel_for(blocks_y, MIN_BLOCK_ROWS_PER_BATCH, encode_rows);
+        }
+        else
+        {
+            encode_rows(0, blocks_y, 0);
+        }
+    }
+
+    std::vector<unsigned char> Texture_Compressor::downsample(const std::vector<unsigned char>& pixels, const uint32_t width, const uint32_t height)
+    {
+        //sRGB to linear lookup, averaging the encoded values would darken the smaller levels
+        static const std::array<float, 256> SRGB_TO_LINEAR = []()
+            {
+                std::array<float, 256> table{};
+
+                for (uint32_t i = 0; i < 256; i++)
+                {
+                    float value = i / 255.0f;
+                    table[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+                }
+
+                return table;
+            }();
+
+        auto linear_to_srgb = [](const float value) -> unsigned char
+            {
+                float srgb = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+                return static_cast<unsigned char>(std::lround(std::clamp(srgb, 0.0f, 1.0f) * 255.0f));
+            };
+
+        uint32_t next_width = std::max(width / 2, 1u);
+        uint32_t next_height = std::max(height / 2, 1u);
+
+        std::vector<unsigned char> next_pixels(static_cast<size_t>(next_width) * next_height * 4);
+
+        for (uint32_t y = 0; y < next_height; y++)
+        {
+            for (uint32_t x = 0; x < next_width; x++)
+            {
+                //2x2 box, clamped for odd sizes and single pixel rows or columns
+                size_t x_0 = std::min(x * 2, width - 1);
+                size_t x_1 = std::min(x * 2 + 1, width - 1);
+                size_t y_0 = std::min(y * 2, height - 1);
+                size_t y_1 = std::min(y * 2 + 1, height - 1);
+
+                const unsigned char* samples[4] = {
+                    pixels.data() + (y_0 * width + x_0) * 4,
+                    pixels.data() + (y_0 * width + x_1) * 4,
+                    pixels.data() + (y_1 * width + x_0) * 4,
+                    pixels.data() + (y_1 * width + x_1) * 4
+                };
+
+                unsigned char* output = next_pixels.data() + (static_cast<size_t>(y) * next_width + x) * 4;
+
+                for (uint32_t c = 0; c < 3; c++)
+                {
+                    float sum = 0.0f;
+
+                    for (const unsigned char* sample : samples)
+                    {
+                        sum += SRGB_TO_LINEAR[sample[c]];
+                    }
+
+                    output[c] = linear_to_srgb(sum * 0.25f);
+                }
+
+                //Alpha is linear
+                output[3] = static_cast<unsigned char>((samples[0][3] + samples[1][3] + samples[2][3] + samples[3][3] + 2) / 4);
+            }
+        }
+
+        return next_pixels;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+namespace vulvox
+{
+    /// <summary>
+    /// CPU encoder from RGBA8 pixels to BC1 or BC7 blocks, used to fill the texture cache offline.
+    /// The endpoints of a 4x4 block are fitted along the principal axis of its colors, the texels are then projected onto the endpoint line
+    /// with SSE (scalar on other architectures) to find their indices. BC7 only uses mode 6 (single subset, RGBA endpoints, 4 bit indices),
+    /// which encodes fast and keeps smooth alpha, at some quality loss on blocks with multiple distinct colors.
+    /// </summary>
+    class Texture_Compressor
+    {
+    public:
+
+        /// <summary>
+        /// Encodes the pixels (sRGB) and a full box filtered mip chain. With a thread pool the block rows of each level are spread over its threads.
+        /// </summary>
+        static Compressed_Image_Data compress(const unsigned char* rgba_pixels, const uint32_t width, const uint32_t height, const Texture_Compression compression, Thread_Pool* thread_pool = nullptr);
+
+        /// <summary>
+        /// Each encodes 16 RGBA8 texels (row order) into a single block, texels with alpha below 128 become transparent in BC1.
+        /// </summary>
+        static void encode_bc1_block(const unsigned char* texels, unsigned char* block);
+        static void encode_bc7_block(const unsigned char* texels, unsigned char* block);
+
+        //Block rows per parallel batch, small levels are encoded on the calling thread
+        static constexpr size_t MIN_BLOCK_ROWS_PER_BATCH = 4;
+
+    private:
+
+        static void encode_level(const std::vector<unsigned char>& pixels, const uint32_t width, const uint32_t height, const Texture_Compression compression, unsigned char* blocks, Thread_Pool* thread_pool);
+
+        //Half size level, averaged in linear space
+        static std::vector<unsigned char> downsample(const std::vector<unsigned char>& pixels, const uint32_t width, const uint32_t height);
+    };
+}
\ No newline at end of file
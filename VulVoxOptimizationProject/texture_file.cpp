@@ -0,0 +1,881 @@
+#include "pch.h"
+#include "texture_file.h"
+
+namespace vulvox
+{
+    //KTX2 file identifier, followed by the header fields (all little endian)
+    static constexpr std::array<unsigned char, 12> KTX2_IDENTIFIER = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+    static constexpr size_t KTX2_HEADER_SIZE = 80;
+    static constexpr size_t KTX2_LEVEL_INDEX_ENTRY_SIZE = 24;
+
+    static constexpr uint32_t DDS_MAGIC = 0x20534444; //"DDS "
+    static constexpr size_t DDS_HEADER_SIZE = 128; //Including the magic
+    static constexpr size_t DDS_DX10_HEADER_SIZE = 20;
+    static constexpr uint32_t DDS_FLAG_MIPMAPCOUNT = 0x20000;
+    static constexpr uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+    static constexpr uint32_t DDS_DIMENSION_TEXTURE2D = 3;
+
+    //Far above the image size limit of any device, keeps the level sizes from overflowing
+    static constexpr uint32_t MAX_TEXTURE_DIMENSION = 65536;
+
+    static constexpr uint32_t make_four_cc(const char a, const char b, const char c, const char d)
+    {
+        return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) | (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+    }
+
+    //Bounds checked little endian read from the file data
+    template <typename T>
+    static T read_value(const std::vector<char>& file_data, const size_t offset)
+    {
+        if (offset + sizeof(T) > file_data.size())
+        {
+            throw std::runtime_error("Failed to load compressed texture! File is truncated.");
+        }
+
+        T value;
+        memcpy(&value, file_data.data() + offset, sizeof(T));
+        return value;
+    }
+
+    //Levels down to 1x1, the most mip levels an image of the size can have
+    static uint32_t get_full_mip_level_count(const uint32_t width, const uint32_t height)
+    {
+        return static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+    }
+
+    static VkFormat dxgi_to_vk_format(const uint32_t dxgi_format)
+    {
+        switch (dxgi_format)
+        {
+        case 71: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK; //DXGI_FORMAT_BC1_UNORM
+        case 72: return VK_FORMAT_BC1_RGBA_SRGB_BLOCK; //DXGI_FORMAT_BC1_UNORM_SRGB
+        case 77: return VK_FORMAT_BC3_UNORM_BLOCK; //DXGI_FORMAT_BC3_UNORM
+        case 78: return VK_FORMAT_BC3_SRGB_BLOCK; //DXGI_FORMAT_BC3_UNORM_SRGB
+        case 98: return VK_FORMAT_BC7_UNORM_BLOCK; //DXGI_FORMAT_BC7_UNORM
+        case 99: return VK_FORMAT_BC7_SRGB_BLOCK; //DXGI_FORMAT_BC7_UNORM_SRGB
+        default: return VK_FORMAT_UNDEFINED;
+        }
+    }
+
+    bool Texture_File::is_compressed_texture_path(const std::filesystem::path& texture_path)
+    {
+        std::string extension = texture_path.extension().string();
+        std::ranges::transform(extension, extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        return extension == ".ktx2" || extension == ".dds";
+    }
+
+    Compressed_Image_Data Texture_File::load(const std::filesystem::path& texture_path)
+    {
+        VULVOX_PROFILE_SCOPE("Texture_File::load");
+
+        std::vector<char> file_data = read_file(texture_path);
+
+        try
+        {
+            if (file_data.size() >= KTX2_IDENTIFIER.size() && memcmp(file_data.data(), KTX2_IDENTIFIER.data(), KTX2_IDENTIFIER.size()) == 0)
+            {
+                return load_ktx2(file_data);
+            }
+
+            if (file_data.size() >= sizeof(uint32_t) && read_value<uint32_t>(file_data, 0) == DDS_MAGIC)
+            {
+                return load_dds(file_data);
+            }
+        }
+        catch (const std::runtime_error& error)
+        {
+            throw std::runtime_error(std::string(error.what()) + " Path was: " + texture_path.string());
+        }
+
+        throw std::runtime_error("Failed to load compressed texture! Not a KTX2 or DDS file. Path was: " + texture_path.string());
+    }
+
+    Compressed_Image_Data Texture_File::load_ktx2(const std::vector<char>& file_data)
+    {
+        Compressed_Image_Data image_data{};
+        image_data.format = static_cast<VkFormat>(read_value<uint32_t>(file_data, 12));
+        image_data.width = read_value<uint32_t>(file_data, 20);
+        image_data.height = read_value<uint32_t>(file_data, 24);
+
+        uint32_t depth = read_value<uint32_t>(file_data, 28);
+        uint32_t layer_count = read_value<uint32_t>(file_data, 32);
+        uint32_t face_count = read_value<uint32_t>(file_data, 36);
+        uint32_t level_count = read_value<uint32_t>(file_data, 40);
+        uint32_t supercompression_scheme = read_value<uint32_t>(file_data, 44);
+
+        if (get_block_size(image_data.format) == 0)
+        {
+            throw std::runtime_error("Failed to load compressed texture! Only BC1, BC3 and BC7 KTX2 files are supported.");
+        }
+
+        if (supercompression_scheme != 0)
+        {
+            throw std::runtime_error("Failed to load compressed texture! Supercompressed KTX2 files are not supported.");
+        }
+
+        if (depth > 1 || face_count != 1 || image_data.width == 0 || image_data.height == 0)
+        {
+            throw std::runtime_error("Failed to load compressed texture! Only 2d textures and texture arrays are supported.");
+        }
+
+        if (image_data.width > MAX_TEXTURE_DIMENSION || image_data.height > MAX_TEXTURE_DIMENSION)
+        {
+            throw std::runtime_error("Failed to load compressed texture! Image is too large.");
+        }
+
+        //0 means no array or a mip chain that should be generated at runtime, which is not possible for block compressed images.
+        //Levels past the full chain can't be created, they are ignored.
+        image_data.layer_count = std::max(layer_count, 1u);
+        image_data.mip_levels = std::clamp(level_count, 1u, get_full_mip_level_count(image_data.width, image_data.height));
+
+        //Levels are stored level by level (smallest first on disk), each level holds all layers, the blocks keep the largest level first
+        for (uint32_t level = 0; level < image_data.mip_levels; level++)
+        {
+            size_t index_offset = KTX2_HEADER_SIZE + level * KTX2_LEVEL_INDEX_ENTRY_SIZE;
+            uint64_t byte_offset = read_value<uint64_t>(file_data, index_offset);
+            uint64_t byte_length = read_value<uint64_t>(file_data, index_offset + 8);
+
+            VkDeviceSize level_size = get_level_size(image_data, level);
+
+            //The length bounds the layer count before any region is added, compared without overflowing
+            if (byte_offset > file_data.size() || byte_length > file_data.size() - byte_offset
+                || byte_length % level_size != 0 || byte_length / level_size != image_data.layer_count)
+            {
+                throw std::runtime_error("Failed to load compressed texture! KTX2 level index does not match the image size.");
+            }
+
+            VkDeviceSize offset = image_data.blocks.size();
+            image_data.blocks.insert(image_data.blocks.end(), file_data.begin() + byte_offset, file_data.begin() + byte_offset + byte_length);
+
+            for (uint32_t layer = 0; layer < image_data.layer_count; layer++)
+            {
+                add_region(image_data, offset + layer * level_size, level, layer);
+            }
+        }
+
+        return image_data;
+    }
+
+    Compressed_Image_Data Texture_File::load_dds(const std::vector<char>& file_data)
+    {
+        Compressed_Image_Data image_data{};
+
+        uint32_t flags = read_value<uint32_t>(file_data, 8);
+        image_data.height = read_value<uint32_t>(file_data, 12);
+        image_data.width = read_value<uint32_t>(file_data, 16);
+
+        uint32_t mip_map_count = read_value<uint32_t>(file_data, 28);
+        uint32_t stored_mip_levels = (flags & DDS_FLAG_MIPMAPCOUNT) ? std::max(mip_map_count, 1u) : 1;
+
+        uint32_t four_cc = read_value<uint32_t>(file_data, 84);
+        size_t data_offset = DDS_HEADER_SIZE;
+
+        //Legacy files carry no color space, they are treated as sRGB like the textures decoded by stb_image
+        if (four_cc == make_four_cc('D', 'X', 'T', '1'))
+        {
+            image_data.format = VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+        }
+        else if (four_cc == make_four_cc('D', 'X', 'T', '5'))
+        {
+            image_data.format = VK_FORMAT_BC3_SRGB_BLOCK;
+        }
+        else if (four_cc == make_four_cc('D', 'X', '1', '0'))
+        {
+            image_data.format = dxgi_to_vk_format(read_value<uint32_t>(file_data, DDS_HEADER_SIZE));
+            uint32_t resource_dimension = read_value<uint32_t>(file_data, DDS_HEADER_SIZE + 4);
+            uint32_t misc_flag = read_value<uint32_t>(file_data, DDS_HEADER_SIZE + 8);
+            uint32_t array_size = read_value<uint32_t>(file_data, DDS_HEADER_SIZE + 12);
+
+            if (resource_dimension != DDS_DIMENSION_TEXTURE2D || (misc_flag & DDS_RESOURCE_MISC_TEXTURECUBE))
+            {
+                throw std::runtime_error("Failed to load compressed texture! Only 2d textures and texture arrays are supported.");
+            }
+
+            image_data.layer_count = std::max(array_size, 1u);
+            data_offset += DDS_DX10_HEADER_SIZE;
+        }
+
+        if (get_block_size(image_data.format) == 0)
+        {
+            throw std::runtime_error("Failed to load compressed texture! Only BC1, BC3 and BC7 DDS files are supported.");
+        }
+
+        if (image_data.width == 0 || image_data.height == 0)
+        {
+            throw std::runtime_error("Failed to load compressed texture! Image has no size.");
+        }
+
+        if (image_data.width > MAX_TEXTURE_DIMENSION || image_data.height > MAX_TEXTURE_DIMENSION)
+        {
+            throw std::runtime_error("Failed to load compressed texture! Image is too large.");
+        }
+
+        //Levels past the full chain can't be created, they are skipped (each is a single block)
+        image_data.mip_levels = std::min(stored_mip_levels, get_full_mip_level_count(image_data.width, image_data.height));
+        VkDeviceSize skipped_levels_size = static_cast<VkDeviceSize>(stored_mip_levels - image_data.mip_levels) * get_block_size(image_data.format);
+
+        if (data_offset > file_data.size())
+        {
+            throw std::runtime_error("Failed to load compressed texture! File is truncated.");
+        }
+
+        //Layers are stored one after the other, each with its full mip chain.
+        //The size is checked per layer, so a layer or level count from a broken header can't add more regions than the file holds.
+        VkDeviceSize available_size = file_data.size() - data_offset;
+        VkDeviceSize offset = 0;
+
+        for (uint32_t layer = 0; layer < image_data.layer_count; layer++)
+        {
+            for (uint32_t level = 0; level < image_data.mip_levels; level++)
+            {
+                add_region(image_data, offset, level, layer);
+                offset += get_level_size(image_data, level);
+            }
+
+            offset += skipped_levels_size;
+
+            if (offset > available_size)
+            {
+                throw std::runtime_error("Failed to load compressed texture! File is truncated.");
+            }
+        }
+
+        image_data.blocks.assign(file_data.begin() + data_offset, file_data.begin() + data_offset + offset);
+
+        return image_data;
+    }
+
+    void Texture_File::save_ktx2(const std::filesystem::path& texture_path, const Compressed_Image_Data& image_data)
+    {
+        VULVOX_PROFILE_SCOPE("Texture_File::save_ktx2");
+
+        uint32_t block_size = get_block_size(image_data.format);
+
+        if (block_size == 0)
+        {
+            throw std::runtime_error("Failed to save compressed texture! Only BC1, BC3 and BC7 data can be written.");
+        }
+
+        std::vector<uint32_t> data_format_descriptor = create_data_format_descriptor(image_data.format);
+        size_t descriptor_size = data_format_descriptor.size() * sizeof(uint32_t);
+
+        std::vector<char> file_data;
+
+        auto append = [&file_data](const auto value)
+            {
+                const char* bytes = reinterpret_cast<const char*>(&value);
+                file_data.insert(file_data.end(), bytes, bytes + sizeof(value));
+            };
+
+        file_data.insert(file_data.end(), KTX2_IDENTIFIER.begin(), KTX2_IDENTIFIER.end());
+        append(static_cast<uint32_t>(image_data.format));
+        append(uint32_t{ 1 }); //Type size of block compressed formats
+        append(image_data.width);
+        append(image_data.height);
+        append(uint32_t{ 0 }); //Depth, 2d only
+        append(image_data.layer_count > 1 ? image_data.layer_count : 0); //0 for a non array texture
+        append(uint32_t{ 1 }); //Faces
+        append(image_data.mip_levels);
+        append(uint32_t{ 0 }); //No supercompression
+
+        //Index: data format descriptor, no key/value data and no supercompression global data
+        size_t level_index_offset = KTX2_HEADER_SIZE;
+        size_t descriptor_offset = level_index_offset + image_data.mip_levels * KTX2_LEVEL_INDEX_ENTRY_SIZE;
+
+        append(static_cast<uint32_t>(descriptor_offset));
+        append(static_cast<uint32_t>(descriptor_size));
+        append(uint32_t{ 0 });
+        append(uint32_t{ 0 });
+        append(uint64_t{ 0 });
+        append(uint64_t{ 0 });
+
+        //Level index is filled in once the level offsets are known
+        file_data.resize(descriptor_offset, 0);
+
+        for (uint32_t value : data_format_descriptor)
+        {
+            append(value);
+        }
+
+        //Levels are stored smallest first, each aligned to the block size, with the layers of a level next to each other
+        for (uint32_t level = image_data.mip_levels; level-- > 0;)
+        {
+            file_data.resize((file_data.size() + block_size - 1) / block_size * block_size, 0);
+
+            uint64_t level_offset = file_data.size();
+            VkDeviceSize level_size = get_level_size(image_data, level);
+
+            for (uint32_t layer = 0; layer < image_data.layer_count; layer++)
+            {
+                auto region = std::ranges::find_if(image_data.regions, [level, layer](const VkBufferImageCopy& region)
+                    {
+                        return region.imageSubresource.mipLevel == level && region.imageSubresource.baseArrayLayer == layer;
+                    });
+
+                if (region == image_data.regions.end() || region->bufferOffset + level_size > image_data.blocks.size())
+                {
+                    throw std::runtime_error("Failed to save compressed texture! Missing mip level or layer.");
+                }
+
+                const unsigned char* blocks = image_data.blocks.data() + region->bufferOffset;
+                file_data.insert(file_data.end(), blocks, blocks + level_size);
+            }
+
+            uint64_t level_length = file_data.size() - level_offset;
+            uint64_t index_entry[3] = { level_offset, level_length, level_length }; //Uncompressed length equals the length without supercompression
+            memcpy(file_data.data() + level_index_offset + level * KTX2_LEVEL_INDEX_ENTRY_SIZE, index_entry, sizeof(index_entry));
+        }
+
+        std::ofstream file(texture_path, std::ios::binary | std::ios::trunc);
+
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Failed to open file " + texture_path.generic_string());
+        }
+
+        file.write(file_data.data(), file_data.size());
+    }
+
+    std::vector<uint32_t> Texture_File::create_data_format_descriptor(const VkFormat format)
+    {
+        //Khronos data format constants for the basic descriptor block
+        constexpr uint32_t MODEL_BC1A = 128;
+        constexpr uint32_t MODEL_BC3 = 130;
+        constexpr uint32_t MODEL_BC7 = 134;
+        constexpr uint32_t CHANNEL_COLOR = 0;
+        constexpr uint32_t CHANNEL_BC1A_ALPHAPRESENT = 1;
+        constexpr uint32_t CHANNEL_BC3_ALPHA = 15;
+        constexpr uint32_t SAMPLE_LINEAR = 1 << 4; //Alpha is never sRGB encoded
+        constexpr uint32_t PRIMARIES_BT709 = 1;
+        constexpr uint32_t TRANSFER_LINEAR = 1;
+        constexpr uint32_t TRANSFER_SRGB = 2;
+
+        bool srgb = format == VK_FORMAT_BC1_RGB_SRGB_BLOCK || format == VK_FORMAT_BC1_RGBA_SRGB_BLOCK || format == VK_FORMAT_BC3_SRGB_BLOCK || format == VK_FORMAT_BC7_SRGB_BLOCK;
+        uint32_t block_size = get_block_size(format);
+
+        uint32_t color_model = MODEL_BC7;
+        std::vector<std::pair<uint32_t, uint32_t>> samples; //Channel (with qualifiers) and bit offset, every sample is 64 or 128 bits
+
+        switch (format)
+        {
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            color_model = MODEL_BC1A;
+            samples.push_back({ CHANNEL_COLOR, 0 });
+            break;
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+            color_model = MODEL_BC1A;
+            samples.push_back({ CHANNEL_BC1A_ALPHAPRESENT, 0 });
+            break;
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+            color_model = MODEL_BC3;
+            samples.push_back({ CHANNEL_BC3_ALPHA | (srgb ? SAMPLE_LINEAR : 0), 0 });
+            samples.push_back({ CHANNEL_COLOR, 64 });
+            break;
+        default:
+            samples.push_back({ CHANNEL_COLOR, 0 });
+            break;
+        }
+
+        uint32_t sample_bits = samples.size() == 1 ? block_size * 8 : 64;
+        uint32_t block_length = 24 + 16 * static_cast<uint32_t>(samples.size());
+
+        std::vector<uint32_t> descriptor;
+        descriptor.push_back(4 + block_length); //Total size
+        descriptor.push_back(0); //Khronos vendor, basic descriptor type
+        descriptor.push_back(2 | (block_length << 16)); //Version 1.3 and block size
+        descriptor.push_back(color_model | (PRIMARIES_BT709 << 8) | ((srgb ? TRANSFER_SRGB : TRANSFER_LINEAR) << 16));
+        descriptor.push_back(3 | (3 << 8)); //4x4x1x1 texel block, stored minus one
+        descriptor.push_back(block_size); //Bytes in plane 0
+        descriptor.push_back(0);
+
+        for (const auto& [channel, bit_offset] : samples)
+        {
+            descriptor.push_back(bit_offset | ((sample_bits - 1) << 16) | (channel << 24));
+            descriptor.push_back(0); //Sample position
+            descriptor.push_back(0); //Lower
+            descriptor.push_back(UINT32_MAX); //Upper
+        }
+
+        return descriptor;
+    }
+
+    void Texture_File::add_region(Compressed_Image_Data& image_data, const VkDeviceSize offset, const uint32_t mip_level, const uint32_t layer)
+    {
+        VkBufferImageCopy region{};
+        region.bufferOffset = offset;
+        region.bufferRowLength = 0; //Tightly packed blocks
+        region.bufferImageHeight = 0;
+
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = mip_level;
+        region.imageSubresource.baseArrayLayer = layer;
+        region.imageSubresource.layerCount = 1;
+
+        region.imageOffset = { 0, 0, 0 };
+        region.imageExtent = { std::max(image_data.width >> mip_level, 1u), std::max(image_data.height >> mip_level, 1u), 1 };
+
+        image_data.regions.push_back(region);
+    }
+
+    VkDeviceSize Texture_File::get_level_size(const Compressed_Image_Data& image_data, const uint32_t mip_level)
+    {
+        //Shifts of 32 or more are undefined, every level past the full chain is a single pixel
+        uint32_t shift = std::min(mip_level, 31u);
+
+        VkDeviceSize blocks_x = (std::max(image_data.width >> shift, 1u) + 3) / 4;
+        VkDeviceSize blocks_y = (std::max(image_data.height >> shift, 1u) + 3) / 4;
+
+        return blocks_x * blocks_y * get_block_size(image_data.format);
+    }
+
+    uint32_t Texture_File::get_block_size(const VkFormat format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+            return 8;
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            return 16;
+        default:
+            return 0;
+        }
+    }
+
+    void Texture_File::decompress(const Compressed_Image_Data& image_data, const uint32_t layer, unsigned char* rgba_pixels)
+    {
+        VULVOX_PROFILE_SCOPE("Texture_File::decompress");
+
+        auto region = std::ranges::find_if(image_data.regions, [layer](const VkBufferImageCopy& region)
+            {
+                return region.imageSubresource.mipLevel == 0 && region.imageSubresource.baseArrayLayer == layer;
+            });
+
+        if (region == image_data.regions.end())
+        {
+            throw std::runtime_error("Failed to decompress texture! Layer does not exist.");
+        }
+
+        uint32_t block_size = get_block_size(image_data.format);
+        uint32_t blocks_x = (image_data.width + 3) / 4;
+        uint32_t blocks_y = (image_data.height + 3) / 4;
+
+        const unsigned char* block = image_data.blocks.data() + region->bufferOffset;
+        std::array<unsigned char, 64> texels{};
+
+        for (uint32_t block_y = 0; block_y < blocks_y; block_y++)
+        {
+            for (uint32_t block_x = 0; block_x < blocks_x; block_x++, block += block_size)
+            {
+                switch (image_data.format)
+                {
+                case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+                case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+                case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+                case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+                    decode_bc1_block(block, texels.data(), false);
+                    break;
+                case VK_FORMAT_BC3_UNORM_BLOCK:
+                case VK_FORMAT_BC3_SRGB_BLOCK:
+                    decode_bc3_block(block, texels.data());
+                    break;
+                default:
+                    decode_bc7_block(block, texels.data());
+                    break;
+                }
+
+                //Blocks on the right and bottom edge can extend past the image
+                for (uint32_t y = 0; y < 4 && block_y * 4 + y < image_data.height; y++)
+                {
+                    uint32_t columns = std::min(4u, image_data.width - block_x * 4);
+                    size_t pixel_offset = (static_cast<size_t>(block_y * 4 + y) * image_data.width + block_x * 4) * 4;
+
+                    memcpy(rgba_pixels + pixel_offset, texels.data() + y * 16, columns * 4);
+                }
+            }
+        }
+    }
+
+    void Texture_File::decode_bc1_block(const unsigned char* block, unsigned char* texels, const bool four_color_mode)
+    {
+        uint16_t color_0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+        uint16_t color_1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+        uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<uint32_t>(block[7]) << 24);
+
+        //Expand the 5:6:5 endpoints to 8 bits per channel
+        std::array<std::array<int, 4>, 4> palette{};
+
+        for (int i = 0; i < 2; i++)
+        {
+            uint16_t color = i == 0 ? color_0 : color_1;
+            int r = (color >> 11) & 0x1F;
+            int g = (color >> 5) & 0x3F;
+            int b = color & 0x1F;
+
+            palette[i] = { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255 };
+        }
+
+        //BC3 color blocks always use four colors, BC1 switches to three colors and transparent black when the endpoints are ordered low to high
+        if (four_color_mode || color_0 > color_1)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+
+            palette[2][3] = palette[3][3] = 255;
+        }
+        else
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            }
+
+            palette[2][3] = 255;
+            palette[3] = { 0, 0, 0, 0 };
+        }
+
+        for (int i = 0; i < 16; i++)
+        {
+            const auto& color = palette[(indices >> (i * 2)) & 0x3];
+
+            for (int c = 0; c < 4; c++)
+            {
+                texels[i * 4 + c] = static_cast<unsigned char>(color[c]);
+            }
+        }
+    }
+
+    void Texture_File::decode_bc3_block(const unsigned char* block, unsigned char* texels)
+    {
+        //Color in the second half, alpha in the first
+        decode_bc1_block(block + 8, texels, true);
+
+        std::array<int, 8> alphas{};
+        alphas[0] = block[0];
+        alphas[1] = block[1];
+
+        if (alphas[0] > alphas[1])
+        {
+            for (int i = 1; i < 7; i++)
+            {
+                alphas[i + 1] = ((7 - i) * alphas[0] + i * alphas[1]) / 7;
+            }
+        }
+        else
+        {
+            for (int i = 1; i < 5; i++)
+            {
+                alphas[i + 1] = ((5 - i) * alphas[0] + i * alphas[1]) / 5;
+            }
+
+            alphas[6] = 0;
+            alphas[7] = 255;
+        }
+
+        //48 bits of 3 bit indices
+        uint64_t indices = 0;
+
+        for (int i = 0; i < 6; i++)
+        {
+            indices |= static_cast<uint64_t>(block[2 + i]) << (i * 8);
+        }
+
+        for (int i = 0; i < 16; i++)
+        {
+            texels[i * 4 + 3] = static_cast<unsigned char>(alphas[(indices >> (i * 3)) & 0x7]);
+        }
+    }
+
+    //BC7 partition of the 16 texels over the subsets, for 2 and 3 subsets
+    static constexpr uint8_t BC7_PARTITIONS_2[64][16] = {
+        {0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1}, {0,0,0,1,0,0,0,1,0,0,0,1,0,0,0,1}, {0,1,1,1,0,1,1,1,0,1,1,1,0,1,1,1}, {0,0,0,1,0,0,1,1,0,0,1,1,0,1,1,1},
+        {0,0,0,0,0,0,0,1,0,0,0,1,0,0,1,1}, {0,0,1,1,0,1,1,1,0,1,1,1,1,1,1,1}, {0,0,0,1,0,0,1,1,0,1,1,1,1,1,1,1}, {0,0,0,0,0,0,0,1,0,0,1,1,0,1,1,1},
+        {0,0,0,0,0,0,0,0,0,0,0,1,0,0,1,1}, {0,0,1,1,0,1,1,1,1,1,1,1,1,1,1,1}, {0,0,0,0,0,0,0,1,0,1,1,1,1,1,1,1}, {0,0,0,0,0,0,0,0,0,0,0,1,0,1,1,1},
+        {0,0,0,1,0,1,1,1,1,1,1,1,1,1,1,1}, {0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1}, {0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1}, {0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1},
+        {0,0,0,0,1,0,0,0,1,1,1,0,1,1,1,1}, {0,1,1,1,0,0,0,1,0,0,0,0,0,0,0,0}, {0,0,0,0,0,0,0,0,1,0,0,0,1,1,1,0}, {0,1,1,1,0,0,1,1,0,0,0,1,0,0,0,0},
+        {0,0,1,1,0,0,0,1,0,0,0,0,0,0,0,0}, {0,0,0,0,1,0,0,0,1,1,0,0,1,1,1,0}, {0,0,0,0,0,0,0,0,1,0,0,0,1,1,0,0}, {0,1,1,1,0,0,1,1,0,0,1,1,0,0,0,1},
+        {0,0,1,1,0,0,0,1,0,0,0,1,0,0,0,0}, {0,0,0,0,1,0,0,0,1,0,0,0,1,1,0,0}, {0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0}, {0,0,1,1,0,1,1,0,0,1,1,0,1,1,0,0},
+        {0,0,0,1,0,1,1,1,1,1,1,0,1,0,0,0}, {0,0,0,0,1,1,1,1,1,1,1,1,0,0,0,0}, {0,1,1,1,0,0,0,1,1,0,0,0,1,1,1,0}, {0,0,1,1,1,0,0,1,1,0,0,1,1,1,0,0},
+        {0,1,0,1,0,1,0,1,0,1,0,1,0,1,0,1}, {0,0,0,0,1,1,1,1,0,0,0,0,1,1,1,1}, {0,1,0,1,1,0,1,0,0,1,0,1,1,0,1,0}, {0,0,1,1,0,0,1,1,1,1,0,0,1,1,0,0},
+        {0,0,1,1,1,1,0,0,0,0,1,1,1,1,0,0}, {0,1,0,1,0,1,0,1,1,0,1,0,1,0,1,0}, {0,1,1,0,1,0,0,1,0,1,1,0,1,0,0,1}, {0,1,0,1,1,0,1,0,1,0,1,0,0,1,0,1},
+        {0,1,1,1,0,0,1,1,1,1,0,0,1,1,1,0}, {0,0,0,1,0,0,1,1,1,1,0,0,1,0,0,0}, {0,0,1,1,0,0,1,0,0,1,0,0,1,1,0,0}, {0,0,1,1,1,0,1,1,1,1,0,1,1,1,0,0},
+        {0,1,1,0,1,0,0,1,1,0,0,1,0,1,1,0}, {0,0,1,1,1,1,0,0,1,1,0,0,0,0,1,1}, {0,1,1,0,0,1,1,0,1,0,0,1,1,0,0,1}, {0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0},
+        {0,1,0,0,1,1,1,0,0,1,0,0,0,0,0,0}, {0,0,1,0,0,1,1,1,0,0,1,0,0,0,0,0}, {0,0,0,0,0,0,1,0,0,1,1,1,0,0,1,0}, {0,0,0,0,0,1,0,0,1,1,1,0,0,1,0,0},
+        {0,1,1,0,1,1,0,0,1,0,0,1,0,0,1,1}, {0,0,1,1,0,1,1,0,1,1,0,0,1,0,0,1}, {0,1,1,0,0,0,1,1,1,0,0,1,1,1,0,0}, {0,0,1,1,1,0,0,1,1,1,0,0,0,1,1,0},
+        {0,1,1,0,1,1,0,0,1,1,0,0,1,0,0,1}, {0,1,1,0,0,0,1,1,0,0,1,1,1,0,0,1}, {0,1,1,1,1,1,1,0,1,0,0,0,0,0,0,1}, {0,0,0,1,1,0,0,0,1,1,1,0,0,1,1,1},
+        {0,0,0,0,1,1,1,1,0,0,1,1,0,0,1,1}, {0,0,1,1,0,0,1,1,1,1,1,1,0,0,0,0}, {0,0,1,0,0,0,1,0,1,1,1,0,1,1,1,0}, {0,1,0,0,0,1,0,0,0,1,1,1,0,1,1,1}
+    };
+
+    static constexpr uint8_t BC7_PARTITIONS_3[64][16] = {
+        {0,0,1,1,0,0,1,1,0,2,2,1,2,2,2,2}, {0,0,0,1,0,0,1,1,2,2,1,1,2,2,2,1}, {0,0,0,0,2,0,0,1,2,2,1,1,2,2,1,1}, {0,2,2,2,0,0,2,2,0,0,1,1,0,1,1,1},
+        {0,0,0,0,0,0,0,0,1,1,2,2,1,1,2,2}, {0,0,1,1,0,0,1,1,0,0,2,2,0,0,2,2}, {0,0,2,2,0,0,2,2,1,1,1,1,1,1,1,1}, {0,0,1,1,0,0,1,1,2,2,1,1,2,2,1,1},
+        {0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2}, {0,0,0,0,1,1,1,1,1,1,1,1,2,2,2,2}, {0,0,0,0,1,1,1,1,2,2,2,2,2,2,2,2}, {0,0,1,2,0,0,1,2,0,0,1,2,0,0,1,2},
+        {0,1,1,2,0,1,1,2,0,1,1,2,0,1,1,2}, {0,1,2,2,0,1,2,2,0,1,2,2,0,1,2,2}, {0,0,1,1,0,1,1,2,1,1,2,2,1,2,2,2}, {0,0,1,1,2,0,0,1,2,2,0,0,2,2,2,0},
+        {0,0,0,1,0,0,1,1,0,1,1,2,1,1,2,2}, {0,1,1,1,0,0,1,1,2,0,0,1,2,2,0,0}, {0,0,0,0,1,1,2,2,1,1,2,2,1,1,2,2}, {0,0,2,2,0,0,2,2,0,0,2,2,1,1,1,1},
+        {0,1,1,1,0,1,1,1,0,2,2,2,0,2,2,2}, {0,0,0,1,0,0,0,1,2,2,2,1,2,2,2,1}, {0,0,0,0,0,0,1,1,0,1,2,2,0,1,2,2}, {0,0,0,0,1,1,0,0,2,2,1,0,2,2,1,0},
+        {0,1,2,2,0,1,2,2,0,0,1,1,0,0,0,0}, {0,0,1,2,0,0,1,2,1,1,2,2,2,2,2,2}, {0,1,1,0,1,2,2,1,1,2,2,1,0,1,1,0}, {0,0,0,0,0,1,1,0,1,2,2,1,1,2,2,1},
+        {0,0,2,2,1,1,0,2,1,1,0,2,0,0,2,2}, {0,1,1,0,0,1,1,0,2,0,0,2,2,2,2,2}, {0,0,1,1,0,1,2,2,0,1,2,2,0,0,1,1}, {0,0,0,0,2,0,0,0,2,2,1,1,2,2,2,1},
+        {0,0,0,0,0,0,0,2,1,1,2,2,1,2,2,2}, {0,2,2,2,0,0,2,2,0,0,1,2,0,0,1,1}, {0,0,1,1,0,0,1,2,0,0,2,2,0,2,2,2}, {0,1,2,0,0,1,2,0,0,1,2,0,0,1,2,0},
+        {0,0,0,0,1,1,1,1,2,2,2,2,0,0,0,0}, {0,1,2,0,1,2,0,1,2,0,1,2,0,1,2,0}, {0,1,2,0,2,0,1,2,1,2,0,1,0,1,2,0}, {0,0,1,1,2,2,0,0,1,1,2,2,0,0,1,1},
+        {0,0,1,1,1,1,2,2,2,2,0,0,0,0,1,1}, {0,1,0,1,0,1,0,1,2,2,2,2,2,2,2,2}, {0,0,0,0,0,0,0,0,2,1,2,1,2,1,2,1}, {0,0,2,2,1,1,2,2,0,0,2,2,1,1,2,2},
+        {0,0,2,2,0,0,1,1,0,0,2,2,0,0,1,1}, {0,2,2,0,1,2,2,1,0,2,2,0,1,2,2,1}, {0,1,0,1,2,2,2,2,2,2,2,2,0,1,0,1}, {0,0,0,0,2,1,2,1,2,1,2,1,2,1,2,1},
+        {0,1,0,1,0,1,0,1,0,1,0,1,2,2,2,2}, {0,2,2,2,0,1,1,1,0,2,2,2,0,1,1,1}, {0,0,0,2,1,1,1,2,0,0,0,2,1,1,1,2}, {0,0,0,0,2,1,1,2,2,1,1,2,2,1,1,2},
+        {0,2,2,2,0,1,1,1,0,1,1,1,0,2,2,2}, {0,0,0,2,1,1,1,2,1,1,1,2,0,0,0,2}, {0,1,1,0,0,1,1,0,0,1,1,0,2,2,2,2}, {0,0,0,0,0,0,0,0,2,1,1,2,2,1,1,2},
+        {0,1,1,0,0,1,1,0,2,2,2,2,2,2,2,2}, {0,0,2,2,0,0,1,1,0,0,1,1,0,0,2,2}, {0,0,2,2,1,1,2,2,1,1,2,2,0,0,2,2}, {0,0,0,0,0,0,0,0,0,0,0,0,2,1,1,2},
+        {0,0,0,2,0,0,0,1,0,0,0,2,0,0,0,1}, {0,2,2,2,1,2,2,2,0,2,2,2,1,2,2,2}, {0,1,0,1,2,2,2,2,2,2,2,2,2,2,2,2}, {0,1,1,1,2,0,1,1,2,2,0,1,2,2,2,0}
+    };
+
+    //Texel of each subset (after the first) whose index is stored with one bit less
+    static constexpr uint8_t BC7_ANCHORS_2[64] = {
+        15,15,15,15,15,15,15,15, 15,15,15,15,15,15,15,15, 15, 2, 8, 2, 2, 8, 8,15, 2, 8, 2, 2, 8, 8, 2, 2,
+        15,15, 6, 8, 2, 8,15,15, 2, 8, 2, 2, 2,15,15, 6, 6, 2, 6, 8,15,15, 2, 2, 15,15,15,15,15, 2, 2,15
+    };
+
+    static constexpr uint8_t BC7_ANCHORS_3_SECOND[64] = {
+        3, 3,15,15, 8, 3,15,15, 8, 8, 6, 6, 6, 5, 3, 3, 3, 3, 8,15, 3, 3, 6,10, 5, 8, 8, 6, 8, 5,15,15,
+        8,15, 3, 5, 6,10, 8,15, 15, 3,15, 5,15,15,15,15, 3,15, 5, 5, 5, 8, 5,10, 5,10, 8,13,15,12, 3, 3
+    };
+
+    static constexpr uint8_t BC7_ANCHORS_3_THIRD[64] = {
+        15, 8, 8, 3,15,15, 3, 8, 15,15,15,15,15,15,15, 8, 15, 8,15, 3,15, 8,15, 8, 3,15, 6,10,15,15,10, 8,
+        15, 3,15,10,10, 8, 9,10, 6,15, 8,15, 3, 6, 6, 8, 15, 3,15,15,15,15,15,15, 15,15,15,15, 3,15,15, 8
+    };
+
+    static constexpr uint8_t BC7_WEIGHTS_2[4] = { 0, 21, 43, 64 };
+    static constexpr uint8_t BC7_WEIGHTS_3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+    static constexpr uint8_t BC7_WEIGHTS_4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    struct BC7_Mode_Info
+    {
+        uint32_t subset_count;
+        uint32_t partition_bits;
+        uint32_t rotation_bits;
+        uint32_t index_selection_bits;
+        uint32_t color_bits;
+        uint32_t alpha_bits;
+        uint32_t endpoint_p_bits; //One per endpoint
+        uint32_t shared_p_bits; //One per subset
+        uint32_t index_bits;
+        uint32_t secondary_index_bits;
+    };
+
+    static constexpr BC7_Mode_Info BC7_MODES[8] = {
+        { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+        { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+        { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+        { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+        { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+        { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+        { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+        { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 }
+    };
+
+    //Reads the 128 bit block from the least significant bit up
+    struct BC7_Bit_Reader
+    {
+        const unsigned char* block;
+        uint32_t position = 0;
+
+        uint32_t read(const uint32_t count)
+        {
+            uint32_t value = 0;
+
+            for (uint32_t i = 0; i < count; i++, position++)
+            {
+                value |= ((block[position >> 3] >> (position & 7)) & 1u) << i;
+            }
+
+            return value;
+        }
+    };
+
+    static int bc7_interpolate(const int endpoint_0, const int endpoint_1, const uint32_t index, const uint32_t index_bits)
+    {
+        const uint8_t* weights = index_bits == 2 ? BC7_WEIGHTS_2 : index_bits == 3 ? BC7_WEIGHTS_3 : BC7_WEIGHTS_4;
+        return ((64 - weights[index]) * endpoint_0 + weights[index] * endpoint_1 + 32) >> 6;
+    }
+
+    void Texture_File::decode_bc7_block(const unsigned char* block, unsigned char* texels)
+    {
+        //The mode is the position of the lowest set bit
+        uint32_t mode = 0;
+
+        while (mode < 8 && !(block[0] & (1u << mode)))
+        {
+            mode++;
+        }
+
+        //Reserved mode, decodes to transparent black
+        if (mode == 8)
+        {
+            memset(texels, 0, 64);
+            return;
+        }
+
+        const BC7_Mode_Info& info = BC7_MODES[mode];
+        BC7_Bit_Reader reader{ block };
+        reader.read(mode + 1);
+
+        uint32_t partition = reader.read(info.partition_bits);
+        uint32_t rotation = reader.read(info.rotation_bits);
+        uint32_t index_selection = reader.read(info.index_selection_bits);
+
+        //Endpoints are stored channel by channel: all red values, then green, blue and alpha
+        uint32_t endpoint_count = info.subset_count * 2;
+        std::array<std::array<int, 4>, 6> endpoints{};
+
+        for (uint32_t c = 0; c < 3; c++)
+        {
+            for (uint32_t e = 0; e < endpoint_count; e++)
+            {
+                endpoints[e][c] = reader.read(info.color_bits);
+            }
+        }
+
+        for (uint32_t e = 0; e < endpoint_count; e++)
+        {
+            endpoints[e][3] = info.alpha_bits > 0 ? reader.read(info.alpha_bits) : 255;
+        }
+
+        //P-bits add a shared least significant bit to all channels of an endpoint
+        uint32_t color_bits = info.color_bits;
+        uint32_t alpha_bits = info.alpha_bits;
+
+        if (info.endpoint_p_bits || info.shared_p_bits)
+        {
+            std::array<uint32_t, 6> p_bits{};
+
+            for (uint32_t e = 0; e < endpoint_count; e++)
+            {
+                p_bits[e] = info.endpoint_p_bits ? reader.read(1) : 0;
+            }
+
+            if (info.shared_p_bits)
+            {
+                for (uint32_t s = 0; s < info.subset_count; s++)
+                {
+                    p_bits[s * 2] = p_bits[s * 2 + 1] = reader.read(1);
+                }
+            }
+
+            for (uint32_t e = 0; e < endpoint_count; e++)
+            {
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    if (c < 3 || info.alpha_bits > 0)
+                    {
+                        endpoints[e][c] = (endpoints[e][c] << 1) | p_bits[e];
+                    }
+                }
+            }
+
+            color_bits++;
+            alpha_bits = info.alpha_bits > 0 ? alpha_bits + 1 : 0;
+        }
+
+        //Expand to 8 bits by replicating the high bits
+        for (uint32_t e = 0; e < endpoint_count; e++)
+        {
+            for (uint32_t c = 0; c < 3; c++)
+            {
+                endpoints[e][c] = (endpoints[e][c] << (8 - color_bits)) | (endpoints[e][c] >> (2 * color_bits - 8));
+            }
+
+            if (alpha_bits > 0)
+            {
+                endpoints[e][3] = (endpoints[e][3] << (8 - alpha_bits)) | (endpoints[e][3] >> (2 * alpha_bits - 8));
+            }
+        }
+
+        auto get_subset = [&info, partition](const uint32_t texel) -> uint32_t
+            {
+                return info.subset_count == 1 ? 0 : info.subset_count == 2 ? BC7_PARTITIONS_2[partition][texel] : BC7_PARTITIONS_3[partition][texel];
+            };
+
+        auto is_anchor = [&info, partition](const uint32_t texel)
+            {
+                if (texel == 0)
+                {
+                    return true;
+                }
+
+                if (info.subset_count == 2)
+                {
+                    return texel == BC7_ANCHORS_2[partition];
+                }
+
+                return info.subset_count == 3 && (texel == BC7_ANCHORS_3_SECOND[partition] || texel == BC7_ANCHORS_3_THIRD[partition]);
+            };
+
+        std::array<uint32_t, 16> indices{};
+        std::array<uint32_t, 16> secondary_indices{};
+
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            indices[i] = reader.read(is_anchor(i) ? info.index_bits - 1 : info.index_bits);
+        }
+
+        if (info.secondary_index_bits > 0)
+        {
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                secondary_indices[i] = reader.read(i == 0 ? info.secondary_index_bits - 1 : info.secondary_index_bits);
+            }
+        }
+
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            uint32_t subset = get_subset(i);
+            const auto& endpoint_0 = endpoints[subset * 2];
+            const auto& endpoint_1 = endpoints[subset * 2 + 1];
+
+            std::array<int, 4> color{};
+
+            if (info.secondary_index_bits == 0)
+            {
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    color[c] = bc7_interpolate(endpoint_0[c], endpoint_1[c], indices[i], info.index_bits);
+                }
+            }
+            else
+            {
+                //Separate color and alpha indices, the index selection bit swaps which set is used for color
+                uint32_t color_index = index_selection ? secondary_indices[i] : indices[i];
+                uint32_t color_index_bits = index_selection ? info.secondary_index_bits : info.index_bits;
+                uint32_t alpha_index = index_selection ? indices[i] : secondary_indices[i];
+                uint32_t alpha_index_bits = index_selection ? info.index_bits : info.secondary_index_bits;
+
+                for (uint32_t c = 0; c < 3; c++)
+                {
+                    color[c] = bc7_interpolate(endpoint_0[c], endpoint_1[c], color_index, color_index_bits);
+                }
+
+                color[3] = bc7_interpolate(endpoint_0[3], endpoint_1[3], alpha_index, alpha_index_bits);
+            }
+
+            //Rotation swaps alpha with one of the color channels
+            if (rotation > 0)
+            {
+                std::swap(color[3], color[rotation - 1]);
+            }
+
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                texels[i * 4 + c] = static_cast<unsigned char>(color[c]);
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+namespace vulvox
+{
+    /// <summary>
+    /// Block compressed texture as stored in a KTX2 or DDS file, every mip level of every layer ready to be copied to an image as is.
+    /// </summary>
+    struct Compressed_Image_Data
+    {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t layer_count = 1;
+        uint32_t mip_levels = 1;
+
+        std::vector<unsigned char> blocks;
+
+        //One copy per mip level and layer, buffer offsets are relative to the start of the blocks
+        std::vector<VkBufferImageCopy> regions;
+    };
+
+    /// <summary>
+    /// Reader for precompressed 2d textures and texture arrays in KTX2 (without supercompression) and DDS files.
+    /// Only BC1, BC3 and BC7 data is accepted, for devices without BC support the blocks can be decompressed to RGBA8 on the CPU.
+    /// </summary>
+    class Texture_File
+    {
+    public:
+
+        /// <summary>
+        /// True for the .ktx2 and .dds extensions, other files are decoded with stb_image.
+        /// </summary>
+        static bool is_compressed_texture_path(const std::filesystem::path& texture_path);
+
+        /// <summary>
+        /// Reads all mip levels and layers of the file without decoding them, thread safe.
+        /// </summary>
+        static Compressed_Image_Data load(const std::filesystem::path& texture_path);
+
+        /// <summary>
+        /// Writes all mip levels and layers to a KTX2 file without supercompression, which load reads back.
+        /// </summary>
+        static void save_ktx2(const std::filesystem::path& texture_path, const Compressed_Image_Data& image_data);
+
+        /// <summary>
+        /// Decodes the first mip level of a layer to RGBA8, rgba_pixels needs room for width * height * 4 bytes.
+        /// </summary>
+        static void decompress(const Compressed_Image_Data& image_data, const uint32_t layer, unsigned char* rgba_pixels);
+
+        /// <summary>
+        /// Bytes per 4x4 block, 0 for formats the loader does not accept.
+        /// </summary>
+        static uint32_t get_block_size(const VkFormat format);
+
+        /// <summary>
+        /// Adds the copy region of a mip level of a layer whose blocks start at offset.
+        /// </summary>
+        static void add_region(Compressed_Image_Data& image_data, const VkDeviceSize offset, const uint32_t mip_level, const uint32_t layer);
+
+        /// <summary>
+        /// Size of the blocks of a single layer of the mip level.
+        /// </summary>
+        static VkDeviceSize get_level_size(const Compressed_Image_Data& image_data, const uint32_t mip_level);
+
+    private:
+
+        static Compressed_Image_Data load_ktx2(const std::vector<char>& file_data);
+        static Compressed_Image_Data load_dds(const std::vector<char>& file_data);
+
+        //Basic data format descriptor block of the format, required by KTX2 readers other than load
+        static std::vector<uint32_t> create_data_format_descriptor(const VkFormat format);
+
+        //Each decodes a single 4x4 block to 16 RGBA8 texels in row order
+        static void decode_bc1_block(const unsigned char* block, unsigned char* texels, const bool four_color_mode);
+        static void decode_bc3_block(const unsigned char* block, unsigned char* texels);
+        static void decode_bc7_block(const unsigned char* block, unsigned char* texels);
+    };
+}
\ No newline at end of file
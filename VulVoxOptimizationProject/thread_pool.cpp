@@ -0,0 +1,128 @@
+#include "pch.h"
+#include "thread_pool.h"
+
+namespace vulvox
+{
+    Thread_Pool::Thread_Pool(const uint32_t thread_count)
+    {
+        uint32_t worker_count = thread_count;
+
+        if (worker_count == 0)
+        {
+            //hardware_concurrency may return 0 when it is unknown
+            uint32_t hardware_threads = std::thread::hardware_concurrency();
+            worker_count = hardware_threads > 1 ? hardware_threads - 1 : 1;
+        }
+
+        workers.reserve(worker_count);
+        for (uint32_t i = 0; i < worker_count; i++)
+        {
+            workers.emplace_back(&Thread_Pool::worker_loop, this);
+        }
+    }
+
+    Thread_Pool::~Thread_Pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+
+        condition.notify_all();
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    uint32_t Thread_Pool::parallel_for(const size_t count, const size_t min_batch_size, const std::function<void(size_t, size_t, uint32_t)>& function)
+    {
+        uint32_t batch_count = get_batch_count(count, min_batch_size);
+
+        if (batch_count == 0)
+        {
+            return 0;
+        }
+
+        size_t batch_size = (count + batch_count - 1) / batch_count;
+
+        //Small workloads are not worth the hand-off to the workers
+        if (batch_count == 1)
+        {
+            function(0, count, 0);
+            return 1;
+        }
+
+        //Batches are claimed through a shared counter, the calling thread helps out instead of idling
+        std::atomic<uint32_t> next_batch{ 0 };
+
+        auto run_batches = [&]()
+            {
+                for (uint32_t batch = next_batch.fetch_add(1); batch < batch_count; batch = next_batch.fetch_add(1))
+                {
+                    size_t begin = batch * batch_size;
+                    size_t end = std::min(count, begin + batch_size);
+                    function(begin, end, batch);
+                }
+            };
+
+        std::vector<std::future<void>> helpers;
+        helpers.reserve(batch_count - 1);
+        for (uint32_t i = 0; i < batch_count - 1; i++)
+        {
+            helpers.push_back(submit(run_batches));
+        }
+
+        run_batches();
+
+        //Rethrows exceptions of the workers
+        for (auto& helper : helpers)
+        {
+            helper.get();
+        }
+
+        return batch_count;
+    }
+
+    uint32_t Thread_Pool::get_batch_count(const size_t count, const size_t min_batch_size) const
+    {
+        if (count == 0)
+        {
+            return 0;
+        }
+
+        size_t max_batches = workers.size() + 1;
+        size_t batches = std::max<size_t>(1, count / std::max<size_t>(1, min_batch_size));
+
+        return static_cast<uint32_t>(std::min(batches, max_batches));
+    }
+
+    uint32_t Thread_Pool::get_thread_count() const
+    {
+        return static_cast<uint32_t>(workers.size());
+    }
+
+    void Thread_Pool::worker_loop()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+                if (stopping && tasks.empty())
+                {
+                    return;
+                }
+
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+
+            task();
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+namespace vulvox
+{
+    /// <summary>
+    /// Fixed set of worker threads that execute queued tasks.
+    /// Used to spread CPU heavy per-frame work (e.g. culling) over multiple cores, parallel_for also runs work on the calling thread.
+    /// </summary>
+    class Thread_Pool
+    {
+    public:
+
+        /// <summary>
+        /// Starts thread_count workers, 0 uses the hardware concurrency minus the calling thread.
+        /// </summary>
+        explicit Thread_Pool(const uint32_t thread_count = 0);
+        ~Thread_Pool();
+
+        Thread_Pool(const Thread_Pool&) = delete;
+        Thread_Pool& operator=(const Thread_Pool&) = delete;
+
+        /// <summary>
+        /// Queue a task, the returned future holds its result (or exception).
+        /// </summary>
+        template<typename Function>
+        auto submit(Function&& function) -> std::future<std::invoke_result_t<std::decay_t<Function>>>
+        {
+            using Result = std::invoke_result_t<std::decay_t<Function>>;
+
+            //packaged_task is move-only, std::function needs a copyable target
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+            std::future<Result> result = task->get_future();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                tasks.emplace([task]() { (*task)(); });
+            }
+
+            condition.notify_one();
+            return result;
+        }
+
+        /// <summary>
+        /// Splits [0, count) into batches of at least min_batch_size elements and calls function(begin, end, batch_index) for each batch.
+        /// The calling thread executes batches as well, returns once every batch is done. Returns the number of batches.
+        /// </summary>
+        uint32_t parallel_for(const size_t count, const size_t min_batch_size, const std::function<void(size_t, size_t, uint32_t)>& function);
+
+        /// <summary>
+        /// Number of batches parallel_for uses for the given count.
+        /// </summary>
+        uint32_t get_batch_count(const size_t count, const size_t min_batch_size) const;
+
+        uint32_t get_thread_count() const;
+
+    private:
+
+        void worker_loop();
+
+        std::vector<std::thread> workers;
+
+        std::queue<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool stopping = false;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "pch.h"
+#include "vulkan_bindless_table.h"
+
+namespace vulvox
+{
+    void Vulkan_Bindless_Table::init(Vulkan_Instance* vulkan_instance)
+    {
+        this->vulkan_instance = vulkan_instance;
+
+        if (!vulkan_instance->supports_descriptor_indexing())
+        {
+            std::cout << "Descriptor indexing is not supported by the device, bindless textures are unavailable." << std::endl;
+            return;
+        }
+
+        capacity = std::min(MAX_TEXTURES, vulkan_instance->get_max_update_after_bind_samplers());
+
+        VkDescriptorSetLayoutBinding textures_binding{};
+        textures_binding.binding = 0; //Same as in shader
+        textures_binding.descriptorCount = capacity;
+        textures_binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        textures_binding.pImmutableSamplers = nullptr;
+        textures_binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+        //Unused elements don't need a valid texture, elements can be written while the set is bound or in use by the GPU
+        VkDescriptorBindingFlagsEXT binding_flags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfoEXT binding_flags_info{};
+        binding_flags_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+        binding_flags_info.bindingCount = 1;
+        binding_flags_info.pBindingFlags = &binding_flags;
+
+        VkDescriptorSetLayoutCreateInfo layout_info{};
+        layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layout_info.pNext = &binding_flags_info;
+        layout_info.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+        layout_info.bindingCount = 1;
+        layout_info.pBindings = &textures_binding;
+
+        if (vkCreateDescriptorSetLayout(vulkan_instance->device, &layout_info, nullptr, &layout) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create bindless texture descriptor set layout!");
+        }
+
+        VkDescriptorPoolSize pool_size{};
+        pool_size.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        pool_size.descriptorCount = capacity;
+
+        VkDescriptorPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+        pool_info.poolSizeCount = 1;
+        pool_info.pPoolSizes = &pool_size;
+        pool_info.maxSets = 1;
+
+        if (vkCreateDescriptorPool(vulkan_instance->device, &pool_info, nullptr, &pool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create bindless texture descriptor pool!");
+        }
+
+        VkDescriptorSetAllocateInfo allocate_info{};
+        allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocate_info.descriptorPool = pool;
+        allocate_info.descriptorSetCount = 1;
+        allocate_info.pSetLayouts = &layout;
+
+        if (vkAllocateDescriptorSets(vulkan_instance->device, &allocate_info, &descriptor_set) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to allocate bindless texture descriptor set!");
+        }
+
+        std::cout << "Bindless texture table created with " << capacity << " texture slots." << std::endl;
+    }
+
+    void Vulkan_Bindless_Table::destroy()
+    {
+        if (vulkan_instance == nullptr)
+        {
+            return;
+        }
+
+        //The set is freed with the pool
+        vkDestroyDescriptorPool(vulkan_instance->device, pool, nullptr);
+        vkDestroyDescriptorSetLayout(vulkan_instance->device, layout, nullptr);
+
+        pool = VK_NULL_HANDLE;
+        layout = VK_NULL_HANDLE;
+        descriptor_set = VK_NULL_HANDLE;
+        capacity = 0;
+    }
+
+    bool Vulkan_Bindless_Table::is_available() const
+    {
+        return descriptor_set != VK_NULL_HANDLE;
+    }
+
+    bool Vulkan_Bindless_Table::set_texture(const uint32_t slot, const Image& texture)
+    {
+        if (!contains_slot(slot))
+        {
+            return false;
+        }
+
+        VkDescriptorImageInfo image_info{};
+        image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        image_info.imageView = texture.image_view;
+        image_info.sampler = texture.sampler;
+
+        VkWriteDescriptorSet descriptor_write{};
+        descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_write.dstSet = descriptor_set;
+        descriptor_write.dstBinding = 0;
+        descriptor_write.dstArrayElement = slot;
+        descriptor_write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        descriptor_write.descriptorCount = 1;
+        descriptor_write.pImageInfo = &image_info;
+
+        vkUpdateDescriptorSets(vulkan_instance->device, 1, &descriptor_write, 0, nullptr);
+
+        return true;
+    }
+
+    bool Vulkan_Bindless_Table::contains_slot(const uint32_t slot) const
+    {
+        return is_available() && slot < capacity;
+    }
+
+    VkDescriptorSetLayout Vulkan_Bindless_Table::get_layout() const
+    {
+        return layout;
+    }
+
+    VkDescriptorSet Vulkan_Bindless_Table::get_descriptor_set() const
+    {
+        return descriptor_set;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+namespace vulvox
+{
+    /// <summary>
+    /// Single descriptor set with one large, partially bound sampler array that holds every loaded texture (VK_EXT_descriptor_indexing).
+    /// Draws select their texture with a per-instance index, so draws with different textures share one pipeline and one descriptor set.
+    /// The array is update after bind and update unused while pending, so textures can be added while frames using the set are in flight.
+    /// </summary>
+    class Vulkan_Bindless_Table
+    {
+    public:
+
+        Vulkan_Bindless_Table() = default;
+
+        /// <summary>
+        /// Creates the layout, pool and set, does nothing when the device does not support descriptor indexing.
+        /// </summary>
+        void init(Vulkan_Instance* vulkan_instance);
+        void destroy();
+
+        bool is_available() const;
+
+        /// <summary>
+        /// Write the texture to an element of the array, returns false when the slot does not fit in the array.
+        /// </summary>
+        bool set_texture(const uint32_t slot, const Image& texture);
+
+        bool contains_slot(const uint32_t slot) const;
+
+        VkDescriptorSetLayout get_layout() const;
+        VkDescriptorSet get_descriptor_set() const;
+
+        //Upper bound of the array size, lowered to the device limit
+        static constexpr uint32_t MAX_TEXTURES = 4096;
+
+    private:
+
+        Vulkan_Instance* vulkan_instance = nullptr;
+
+        uint32_t capacity = 0;
+
+        VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+        VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+    };
+}
\ No newline at end of file
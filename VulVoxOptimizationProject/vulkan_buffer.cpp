@@ -37,6 +37,8 @@ namespace vulvox
     /// <param name="new_size">The new buffer size in bytes.</param>
     void Buffer::recreate(Vulkan_Instance& instance, VkDeviceSize new_size)
     {
+        VULVOX_PROFILE_SCOPE("Buffer::recreate");
+
         destroy(instance.allocator);
 
         create(instance, new_size, usage_flags, alloc_flags);
@@ -3,18 +3,26 @@
 
 namespace vulvox
 {
-    void Vulkan_Buffer_Manager::init(Vulkan_Instance* vulkan_instance, const uint32_t swap_chain_image_count, const uint32_t growth_factor)
+    void Vulkan_Buffer_Manager::init(Vulkan_Instance* vulkan_instance, const uint32_t swap_chain_image_count, const VkDeviceSize initial_instance_buffer_size, const VkDeviceSize initial_staging_buffer_size)
     {
         this->vulkan_instance = vulkan_instance;
         this->swap_chain_image_count = swap_chain_image_count;
-        this->growth_factor = growth_factor;
 
         create_uniform_buffers();
-    }
 
-    void Vulkan_Buffer_Manager::set_growth_factor(const uint32_t growth_factor)
-    {
-        this->growth_factor = growth_factor;
+        //16 byte alignment covers every vertex attribute format we use (up to vec4/mat4 columns)
+        VkDeviceSize storage_alignment = vulkan_instance->get_physical_device_properties().limits.minStorageBufferOffsetAlignment;
+        allocation_alignment = std::max<VkDeviceSize>(16, storage_alignment);
+
+        instance_allocator.init(vulkan_instance, swap_chain_image_count, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, initial_instance_buffer_size);
+        staging_allocator.init(vulkan_instance, swap_chain_image_count, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, initial_staging_buffer_size);
+
+        //Device local, starts at the staging size and grows with the peak usage of a frame
+        device_allocator.init(vulkan_instance, swap_chain_image_count, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, initial_staging_buffer_size, 0);
+
+        retired_buffers.resize(swap_chain_image_count);
+
+        readback_buffers.resize(swap_chain_image_count);
     }
 
     void Vulkan_Buffer_Manager::destroy()
@@ -26,17 +34,53 @@ namespace vulvox
         }
         uniform_buffers.clear();
 
-        for (auto& buffer : instance_buffers)
+        instance_allocator.destroy();
+        staging_allocator.destroy();
+        device_allocator.destroy();
+
+        for (auto& frame_buffers : retired_buffers)
         {
-            buffer.destroy(vulkan_instance->allocator);
+            for (auto& buffer : frame_buffers)
+            {
+                buffer.destroy(vulkan_instance->allocator);
+            }
+        }
+        retired_buffers.clear();
+
+        for (auto& buffer : readback_buffers)
+        {
+            if (buffer.buffer != VK_NULL_HANDLE)
+            {
+                buffer.destroy(vulkan_instance->allocator);
+            }
+        }
+        readback_buffers.clear();
+    }
+
+    void Vulkan_Buffer_Manager::begin_frame(const uint32_t current_frame)
+    {
+        instance_allocator.begin_frame(current_frame);
+        staging_allocator.begin_frame(current_frame);
+        device_allocator.begin_frame(current_frame);
+        instance_upload_bytes = 0;
 
+        //The fence of this frame slot signaled, so the GPU no longer uses the buffers retired by it
+        for (auto& buffer : retired_buffers[current_frame])
+        {
+            buffer.destroy(vulkan_instance->allocator);
         }
-        instance_buffers.clear();
+        retired_buffers[current_frame].clear();
     }
 
-    void Vulkan_Buffer_Manager::begin_frame()
+    void Vulkan_Buffer_Manager::end_frame()
     {
-        instance_buffer_requests = 0;
+        instance_allocator.flush();
+        staging_allocator.flush();
+    }
+
+    VkDeviceSize Vulkan_Buffer_Manager::get_instance_upload_bytes() const
+    {
+        return instance_upload_bytes;
     }
 
     Buffer& Vulkan_Buffer_Manager::get_uniform_buffer(const uint32_t current_frame)
@@ -45,38 +89,66 @@ namespace vulvox
         return uniform_buffers[current_frame];
     }
 
-    /// <summary>
-    /// Get an instance buffer with at least instance_size * instance_count capacity.
-    /// </summary>
-    /// <param name="current_frame">Index of the current swap_chain image.</param>
-    /// <returns>Reference to an available buffer with at least instance_size * instance_count capacity.</returns>
-    size_t Vulkan_Buffer_Manager::get_instance_buffer(const uint32_t current_frame, const VkDeviceSize instance_size, const VkDeviceSize instance_count)
+    Buffer_Allocation Vulkan_Buffer_Manager::allocate_instance_data(const VkDeviceSize size)
     {
-        //Check if there are buffers left or if we need to create a new set
-        uint32_t buffers_per_frame = static_cast<uint32_t>(instance_buffers.size()) / swap_chain_image_count;
+        VULVOX_PROFILE_SCOPE("Vulkan_Buffer_Manager::allocate_instance_data");
 
-        if (uint32_t current_buffer_usage = instance_buffer_requests + 1; current_buffer_usage > buffers_per_frame)
-        {
-            expand_instance_buffers(current_buffer_usage, instance_size * instance_count);
-        }
+        std::lock_guard<std::mutex> lock(allocation_mutex);
+
+        instance_upload_bytes += size;
+
+        return instance_allocator.allocate(size, allocation_alignment);
+    }
+
+    Buffer_Allocation Vulkan_Buffer_Manager::allocate_device_data(const VkDeviceSize size)
+    {
+        std::lock_guard<std::mutex> lock(allocation_mutex);
+
+        return device_allocator.allocate(size, allocation_alignment);
+    }
+
+    Buffer_Allocation Vulkan_Buffer_Manager::allocate_staging_data(const VkDeviceSize size)
+    {
+        VULVOX_PROFILE_SCOPE("Vulkan_Buffer_Manager::allocate_staging_data");
+
+        std::lock_guard<std::mutex> lock(allocation_mutex);
+
+        instance_upload_bytes += size;
+
+        //vkCmdCopyBuffer has no alignment requirements, 16 bytes keeps the mapped pointer aligned for matrices
+        return staging_allocator.allocate(size, 16);
+    }
 
-        uint32_t buffer_index = (instance_buffer_requests * swap_chain_image_count) + current_frame;
-        instance_buffer_requests++;
-        assert(buffer_index < instance_buffers.size());
+    void Vulkan_Buffer_Manager::retire_buffer(const uint32_t frame, Buffer buffer)
+    {
+        assert(frame < retired_buffers.size());
+        retired_buffers[frame].push_back(buffer);
+    }
+
+    Buffer& Vulkan_Buffer_Manager::get_readback_buffer(const uint32_t current_frame, const VkDeviceSize size)
+    {
+        assert(current_frame < readback_buffers.size());
+        Buffer& readback_buffer = readback_buffers[current_frame];
 
-        //Check if the buffer size has enough capacity 
-        if (VkDeviceSize buffer_size = instance_size * instance_count; buffer_size > instance_buffers[buffer_index].size)
+        if (readback_buffer.buffer == VK_NULL_HANDLE)
         {
-            //If not, resize it. Create a few extra so we reduce the chance we have to resize again next frame.
-            instance_buffers[buffer_index].recreate(*vulkan_instance, buffer_size + instance_size * growth_factor);
+            //Random access so the host can read back the data, mapped for the lifetime of the buffer
+            readback_buffer.create(*vulkan_instance, size,
+                VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+        }
+        else if (size > readback_buffer.size)
+        {
+            readback_buffer.recreate(*vulkan_instance, size);
         }
 
-        return buffer_index;
+        return readback_buffer;
     }
 
-    Buffer& Vulkan_Buffer_Manager::get_instance_buffer(const size_t buffer_index)
+    Buffer& Vulkan_Buffer_Manager::get_readback_buffer(const uint32_t current_frame)
     {
-        return instance_buffers[buffer_index];
+        assert(current_frame < readback_buffers.size());
+        return readback_buffers[current_frame];
     }
 
     //Create an instance buffer thats accessable from both the host and device
@@ -94,35 +166,4 @@ namespace vulvox
                 VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
         }
     }
-
-    Buffer Vulkan_Buffer_Manager::create_instance_buffer(const VkDeviceSize instance_buffer_size)
-    {
-        VkDeviceSize instance_data_buffer_size = instance_buffer_size;
-
-        Buffer instance_buffer;
-        instance_buffer.create(*vulkan_instance, instance_data_buffer_size,
-            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
-
-        return instance_buffer;
-    }
-
-    void Vulkan_Buffer_Manager::expand_instance_buffers(uint32_t required_buffers_per_frame, VkDeviceSize instance_buffer_size)
-    {
-        uint32_t required_buffer_count = required_buffers_per_frame * swap_chain_image_count;
-
-        if (instance_buffers.size() >= required_buffer_count)
-        {
-            return;
-        }
-
-        //Allocate additional buffers
-        uint32_t to_allocate = required_buffer_count - static_cast<uint32_t>(instance_buffers.size());
-
-        instance_buffers.reserve(required_buffer_count);
-        for (uint32_t i = 0; i < to_allocate; i++)
-        {
-            instance_buffers.emplace_back(create_instance_buffer(instance_buffer_size));
-        }
-    }
 }
\ No newline at end of file
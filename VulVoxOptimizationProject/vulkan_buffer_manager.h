@@ -8,18 +8,24 @@ namespace vulvox
 
         Vulkan_Buffer_Manager() = default;
 
-        void init(Vulkan_Instance* vulkan_instance, const uint32_t swap_chain_image_count, const uint32_t growth_factor = 10);
+        void init(Vulkan_Instance* vulkan_instance, const uint32_t swap_chain_image_count, const VkDeviceSize initial_instance_buffer_size = 4 * 1024 * 1024, const VkDeviceSize initial_staging_buffer_size = 1024 * 1024);
         void destroy();
 
         /// <summary>
-        /// Set the amount of extra memory (in instance sizes) that is allocated when resizing a buffer.
+        /// Call this at the start of every frame (after the frame's fence has signaled) to reset the instance and staging buffers of this frame.
+        /// Also destroys the buffers that were retired by the previous use of this frame slot.
         /// </summary>
-        void set_growth_factor(const uint32_t growth_factor);
+        void begin_frame(const uint32_t current_frame);
 
         /// <summary>
-        /// Call this at the start of every frame to reset the instance buffer usage counter.
+        /// Call this before submitting the frame, makes the instance data written by the host visible to the device.
         /// </summary>
-        void begin_frame();
+        void end_frame();
+
+        /// <summary>
+        /// Amount of bytes allocated from the instance and staging buffers since the last begin_frame().
+        /// </summary>
+        VkDeviceSize get_instance_upload_bytes() const;
 
         /// <summary>
         /// Retrieve the uniform buffer for the current swap chain image.
@@ -27,52 +33,87 @@ namespace vulvox
         Buffer& get_uniform_buffer(const uint32_t current_frame);
 
         /// <summary>
-        /// Get index of an instance buffer with at least instance_size * instance_count capacity.
+        /// Sub-allocate an aligned range from the persistently mapped instance buffer of the current frame.
+        /// Bind the returned buffer with the returned offset, the range is valid until the frame slot is started again.
+        /// The range can be used as vertex, storage or indirect buffer. The allocate functions can be called from multiple recording threads.
+        /// </summary>
+        Buffer_Allocation allocate_instance_data(const VkDeviceSize size);
+
+        /// <summary>
+        /// Sub-allocate a range of device local memory for the current frame, written by the GPU (e.g. culling output).
+        /// The range can be used as vertex or storage buffer and is valid until the frame slot is started again.
         /// </summary>
-        /// <param name="current_frame">Index of the current swap_chain image.</param>
-        /// <returns>Reference to an available buffer with at least instance_size * instance_count capacity.</returns>
-        size_t get_instance_buffer(const uint32_t current_frame, const VkDeviceSize instance_size, const VkDeviceSize instance_count);
+        Buffer_Allocation allocate_device_data(const VkDeviceSize size);
 
-        Buffer& get_instance_buffer(const size_t buffer_index);
+        /// <summary>
+        /// Sub-allocate a range from the persistently mapped staging buffer of the current frame, used as transfer source for device local buffers.
+        /// The range is valid until the frame slot is started again.
+        /// </summary>
+        Buffer_Allocation allocate_staging_data(const VkDeviceSize size);
 
         /// <summary>
-        /// Copy data to a instance buffer and returns the index of the buffer.
+        /// Destroy the buffer once the given frame slot is started again, use this for buffers that may still be used by a frame in flight.
+        /// </summary>
+        void retire_buffer(const uint32_t frame, Buffer buffer);
+
+        /// <summary>
+        /// Copy data to the instance buffer of the current frame and returns the range it was written to.
         /// </summary>
         template<typename T>
-        size_t copy_to_instance_buffer(Vulkan_Instance& instance, const uint32_t current_frame, const std::vector<T>& data)
+        Buffer_Allocation copy_to_instance_buffer(const std::vector<T>& data)
         {
-            size_t buffer_index = get_instance_buffer(current_frame, sizeof(T), data.size());
-            instance_buffers[buffer_index].copy_to_buffer(*vulkan_instance, data);
+            VkDeviceSize data_size = data.size() * sizeof(T);
 
-            return buffer_index;
-        }
+            Buffer_Allocation allocation = allocate_instance_data(data_size);
+            if (data_size > 0)
+            {
+                memcpy(allocation.mapped_data, data.data(), data_size);
+            }
 
-    private:
-
-        void create_uniform_buffers();
+            return allocation;
+        }
 
         /// <summary>
-        ///Create an instance buffer thats accessable from both the host and device.
+        /// Retrieve the host visible readback buffer of the current frame, (re)created when smaller than the requested size.
+        /// Only reuse the buffer after the frame that wrote to it has finished on the GPU.
         /// </summary>
-        /// <param name="instance_buffer_size">Size in sizeof(instance_type) * instance_count.</param>
-        Buffer create_instance_buffer(const VkDeviceSize instance_buffer_size);
+        Buffer& get_readback_buffer(const uint32_t current_frame, const VkDeviceSize size);
 
-        /// <summary>
-        /// Create extra instance buffers with given buffer size if current amount of instance buffers is less than the requested amount.
-        /// </summary>
-        void expand_instance_buffers(uint32_t required_buffers_per_frame, VkDeviceSize instance_buffer_size);
+        Buffer& get_readback_buffer(const uint32_t current_frame);
+
+    private:
+
+        void create_uniform_buffers();
 
         Vulkan_Instance* vulkan_instance = nullptr;
 
         uint32_t swap_chain_image_count = 0;
-        uint32_t instance_buffer_requests = 0;
-        uint32_t growth_factor = 10;
+
+        VkDeviceSize instance_upload_bytes = 0;
+
+        //Guards the per-frame allocators when draws are recorded on multiple threads
+        std::mutex allocation_mutex;
 
         //Uniform buffers, data available across shaders
         std::vector<Buffer> uniform_buffers;
 
-        //Instance buffers, stores data that is part of specific draw calls
-        std::vector<Buffer> instance_buffers;
+        //Instance data of specific draw calls, one linear allocator region per frame in flight
+        Vulkan_Linear_Allocator instance_allocator;
+
+        //Transfer sources for device local buffers, one linear allocator region per frame in flight
+        Vulkan_Linear_Allocator staging_allocator;
+
+        //GPU written per-frame data, one linear allocator region per frame in flight
+        Vulkan_Linear_Allocator device_allocator;
+
+        //Allocations can be bound as storage buffers, so they respect minStorageBufferOffsetAlignment
+        VkDeviceSize allocation_alignment = 16;
+
+        //Buffers that are destroyed when their frame slot is started again
+        std::vector<std::vector<Buffer>> retired_buffers;
+
+        //Readback buffers, GPU to host copies of rendered frames (created on first use)
+        std::vector<Buffer> readback_buffers;
     };
 
 }
\ No newline at end of file
@@ -26,6 +26,9 @@ namespace vulvox
         {
             throw std::runtime_error("Failed to create command pool!");
         }
+
+        graphics_family = queue_family_indices.graphics_family.value();
+        transfer_family = queue_family_indices.transfer_family.value_or(graphics_family);
     }
 
     void Vulkan_Command_Pool::create_command_buffers(int frames_in_flight)
@@ -47,48 +50,439 @@ namespace vulvox
 
     /// <summary>
     /// Begins a single-use command buffer for short-lived operations.
-    /// Allocates a primary command buffer from the specified command pool, 
-    /// begins recording with the VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT flag, 
-    /// and returns the command buffer.
+    /// The command buffer is part of an implicit upload batch, so it is submitted by end_single_time_commands
+    /// or together with the other uploads when an upload batch is open.
     /// </summary>
     /// <returns>
-    /// The allocated and ready-to-record VkCommandBuffer.
+    /// The ready-to-record VkCommandBuffer, executed on the graphics queue.
     /// </returns>
     VkCommandBuffer Vulkan_Command_Pool::begin_single_time_commands()
     {
-        VkCommandBufferAllocateInfo allocate_info{};
-        allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocate_info.commandPool = command_pool;
-        allocate_info.commandBufferCount = 1;
+        begin_upload_batch();
+        return get_upload_graphics_commands();
+    }
+
+    void Vulkan_Command_Pool::end_single_time_commands()
+    {
+        end_upload_batch();
+    }
+
+    VkCommandBuffer Vulkan_Command_Pool::begin_transfer_commands()
+    {
+        begin_upload_batch();
+        return get_upload_transfer_commands();
+    }
+
+    void Vulkan_Command_Pool::end_transfer_commands()
+    {
+        end_upload_batch();
+    }
+
+    void Vulkan_Command_Pool::begin_upload_batch()
+    {
+        if (upload_batch.depth == 0)
+        {
+            upload_batch.ticket = next_upload_ticket++;
+        }
+
+        upload_batch.depth++;
+    }
+
+    void Vulkan_Command_Pool::end_upload_batch()
+    {
+        close_upload_batch(true);
+    }
+
+    void Vulkan_Command_Pool::end_upload_batch_async()
+    {
+        close_upload_batch(false);
+    }
+
+    void Vulkan_Command_Pool::close_upload_batch(const bool wait)
+    {
+        if (upload_batch.depth == 0)
+        {
+            std::cout << "end_upload_batch called without an open upload batch, ignoring call." << std::endl;
+            return;
+        }
+
+        upload_batch.depth--;
+
+        if (upload_batch.depth == 0)
+        {
+            submit_upload_batch(wait);
+        }
+    }
+
+    uint64_t Vulkan_Command_Pool::get_upload_batch_ticket() const
+    {
+        return upload_batch.depth > 0 ? upload_batch.ticket : 0;
+    }
+
+    bool Vulkan_Command_Pool::is_upload_finished(const uint64_t ticket) const
+    {
+        if (ticket >= next_upload_ticket || ticket == get_upload_batch_ticket())
+        {
+            return false;
+        }
+
+        //Closed batches are either waited on by end_upload_batch or in flight until collected
+        return std::ranges::none_of(in_flight_uploads, [ticket](const In_Flight_Upload& upload) { return upload.ticket == ticket; });
+    }
+
+    void Vulkan_Command_Pool::collect_finished_uploads()
+    {
+        std::erase_if(in_flight_uploads, [this](In_Flight_Upload& upload)
+            {
+                if (vkGetFenceStatus(vulkan_instance->device, upload.fence) != VK_SUCCESS)
+                {
+                    return false;
+                }
+
+                release_upload(upload);
+
+                free_upload_fences.push_back(upload.fence);
+
+                //The graphics submit that waited on the semaphore is finished, so it is unsignaled again
+                if (upload.semaphore != VK_NULL_HANDLE)
+                {
+                    free_upload_semaphores.push_back(upload.semaphore);
+                }
+
+                return true;
+            });
+    }
+
+    void Vulkan_Command_Pool::wait_for_uploads()
+    {
+        for (const auto& upload : in_flight_uploads)
+        {
+            vkWaitForFences(vulkan_instance->device, 1, &upload.fence, VK_TRUE, UINT64_MAX);
+        }
+
+        collect_finished_uploads();
+    }
+
+    VkCommandBuffer Vulkan_Command_Pool::get_upload_graphics_commands()
+    {
+        if (upload_batch.graphics_commands == VK_NULL_HANDLE)
+        {
+            VkCommandBufferAllocateInfo allocate_info{};
+            allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocate_info.commandPool = command_pool;
+            allocate_info.commandBufferCount = 1;
+
+            vkAllocateCommandBuffers(vulkan_instance->device, &allocate_info, &upload_batch.graphics_commands);
+
+            //Start recording command buffer
+            VkCommandBufferBeginInfo begin_info{};
+            begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT; //We only use this buffer once
+
+            vkBeginCommandBuffer(upload_batch.graphics_commands, &begin_info);
+        }
+
+        return upload_batch.graphics_commands;
+    }
+
+    VkCommandBuffer Vulkan_Command_Pool::get_upload_transfer_commands()
+    {
+        //Without a transfer queue the copies simply go to the graphics queue
+        if (!vulkan_instance->has_dedicated_transfer_queue())
+        {
+            return get_upload_graphics_commands();
+        }
+
+        if (upload_batch.transfer_commands == VK_NULL_HANDLE)
+        {
+            create_upload_sync_objects();
 
-        VkCommandBuffer command_buffer;
-        vkAllocateCommandBuffers(vulkan_instance->device, &allocate_info, &command_buffer);
+            VkCommandBufferAllocateInfo allocate_info{};
+            allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocate_info.commandPool = transfer_command_pool;
+            allocate_info.commandBufferCount = 1;
 
-        //Start recording command buffer
-        VkCommandBufferBeginInfo begin_info{};
-        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT; //We only use this buffer once
+            vkAllocateCommandBuffers(vulkan_instance->device, &allocate_info, &upload_batch.transfer_commands);
 
-        vkBeginCommandBuffer(command_buffer, &begin_info);
+            VkCommandBufferBeginInfo begin_info{};
+            begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
-        return command_buffer;
+            vkBeginCommandBuffer(upload_batch.transfer_commands, &begin_info);
+        }
+
+        return upload_batch.transfer_commands;
     }
 
-    void Vulkan_Command_Pool::end_single_time_commands(VkCommandBuffer command_buffer)
+    void Vulkan_Command_Pool::create_upload_sync_objects()
     {
-        vkEndCommandBuffer(command_buffer);
+        if (upload_fence != VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        VkFenceCreateInfo fence_info{};
+        fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        if (vkCreateFence(vulkan_instance->device, &fence_info, nullptr, &upload_fence) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create upload fence!");
+        }
+
+        if (!vulkan_instance->has_dedicated_transfer_queue())
+        {
+            return;
+        }
 
-        //Execute copy command buffer instantly and wait until transfer is complete
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &command_buffer;
+        VkSemaphoreCreateInfo semaphore_info{};
+        semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-        vkQueueSubmit(vulkan_instance->graphics_queue, 1, &submitInfo, nullptr);
-        vkQueueWaitIdle(vulkan_instance->graphics_queue);
+        if (vkCreateSemaphore(vulkan_instance->device, &semaphore_info, nullptr, &upload_semaphore) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create upload semaphore!");
+        }
 
-        vkFreeCommandBuffers(vulkan_instance->device, command_pool, 1, &command_buffer);
+        VkCommandPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        pool_info.queueFamilyIndex = transfer_family;
+
+        if (vkCreateCommandPool(vulkan_instance->device, &pool_info, nullptr, &transfer_command_pool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create transfer command pool!");
+        }
+    }
+
+    void Vulkan_Command_Pool::acquire_async_sync_objects(const bool with_semaphore, VkFence& fence, VkSemaphore& semaphore)
+    {
+        fence = VK_NULL_HANDLE;
+        semaphore = VK_NULL_HANDLE;
+
+        if (!free_upload_fences.empty())
+        {
+            fence = free_upload_fences.back();
+            free_upload_fences.pop_back();
+        }
+        else
+        {
+            VkFenceCreateInfo fence_info{};
+            fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+            if (vkCreateFence(vulkan_instance->device, &fence_info, nullptr, &fence) != VK_SUCCESS)
+            {
+                throw std::runtime_error("Failed to create upload fence!");
+            }
+        }
+
+        if (!with_semaphore)
+        {
+            return;
+        }
+
+        if (!free_upload_semaphores.empty())
+        {
+            semaphore = free_upload_semaphores.back();
+            free_upload_semaphores.pop_back();
+        }
+        else
+        {
+            VkSemaphoreCreateInfo semaphore_info{};
+            semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+            if (vkCreateSemaphore(vulkan_instance->device, &semaphore_info, nullptr, &semaphore) != VK_SUCCESS)
+            {
+                throw std::runtime_error("Failed to create upload semaphore!");
+            }
+        }
+    }
+
+    void Vulkan_Command_Pool::submit_upload_batch(const bool wait)
+    {
+        VULVOX_PROFILE_SCOPE("Vulkan_Command_Pool::submit_upload_batch");
+
+        VkCommandBuffer transfer_commands = upload_batch.transfer_commands;
+        VkCommandBuffer graphics_commands = upload_batch.graphics_commands;
+
+        if (transfer_commands != VK_NULL_HANDLE || graphics_commands != VK_NULL_HANDLE)
+        {
+            create_upload_sync_objects();
+
+            //Waited on batches share a fence, async batches need their own until they are collected
+            VkFence fence = upload_fence;
+            VkSemaphore semaphore = upload_semaphore;
+
+            if (!wait)
+            {
+                acquire_async_sync_objects(transfer_commands != VK_NULL_HANDLE && graphics_commands != VK_NULL_HANDLE, fence, semaphore);
+            }
+
+            //The copies run first on the transfer queue, the graphics commands (ownership acquires, layout transitions) wait for them
+            if (transfer_commands != VK_NULL_HANDLE)
+            {
+                vkEndCommandBuffer(transfer_commands);
+
+                VkSubmitInfo submit_info{};
+                submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+                submit_info.commandBufferCount = 1;
+                submit_info.pCommandBuffers = &transfer_commands;
+
+                if (graphics_commands != VK_NULL_HANDLE)
+                {
+                    submit_info.signalSemaphoreCount = 1;
+                    submit_info.pSignalSemaphores = &semaphore;
+                }
+
+                if (vkQueueSubmit(vulkan_instance->transfer_queue, 1, &submit_info, graphics_commands != VK_NULL_HANDLE ? VK_NULL_HANDLE : fence) != VK_SUCCESS)
+                {
+                    throw std::runtime_error("Failed to submit upload transfer command buffer!");
+                }
+            }
+
+            if (graphics_commands != VK_NULL_HANDLE)
+            {
+                vkEndCommandBuffer(graphics_commands);
+
+                VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+                VkSubmitInfo submit_info{};
+                submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+                submit_info.commandBufferCount = 1;
+                submit_info.pCommandBuffers = &graphics_commands;
+
+                if (transfer_commands != VK_NULL_HANDLE)
+                {
+                    submit_info.waitSemaphoreCount = 1;
+                    submit_info.pWaitSemaphores = &semaphore;
+                    submit_info.pWaitDstStageMask = &wait_stage;
+                }
+
+                if (vkQueueSubmit(vulkan_instance->graphics_queue, 1, &submit_info, fence) != VK_SUCCESS)
+                {
+                    throw std::runtime_error("Failed to submit upload command buffer!");
+                }
+            }
+
+            In_Flight_Upload upload{ upload_batch.ticket, fence, semaphore, graphics_commands, transfer_commands, std::move(upload_batch.staging_buffers) };
+
+            if (!wait)
+            {
+                //The staging buffers stay alive until the copies that read them are finished
+                in_flight_uploads.push_back(std::move(upload));
+                upload_batch = Upload_Batch{};
+                return;
+            }
+
+            //Only wait for the uploads, unlike vkQueueWaitIdle this doesn't wait for the frames in flight on the graphics queue
+            vkWaitForFences(vulkan_instance->device, 1, &fence, VK_TRUE, UINT64_MAX);
+            release_upload(upload);
+        }
+
+        for (auto& staging_buffer : upload_batch.staging_buffers)
+        {
+            staging_buffer.destroy(vulkan_instance->allocator);
+        }
+
+        upload_batch = Upload_Batch{};
+    }
+
+    void Vulkan_Command_Pool::release_upload(In_Flight_Upload& upload)
+    {
+        vkResetFences(vulkan_instance->device, 1, &upload.fence);
+
+        if (upload.transfer_commands != VK_NULL_HANDLE)
+        {
+            vkFreeCommandBuffers(vulkan_instance->device, transfer_command_pool, 1, &upload.transfer_commands);
+        }
+
+        if (upload.graphics_commands != VK_NULL_HANDLE)
+        {
+            vkFreeCommandBuffers(vulkan_instance->device, command_pool, 1, &upload.graphics_commands);
+        }
+
+        for (auto& staging_buffer : upload.staging_buffers)
+        {
+            staging_buffer.destroy(vulkan_instance->allocator);
+        }
+
+        upload.staging_buffers.clear();
+    }
+
+    void Vulkan_Command_Pool::record_upload_barrier(const VkBufferMemoryBarrier& barrier, const VkPipelineStageFlags destination_stage)
+    {
+        record_upload_barrier(&barrier, nullptr, destination_stage);
+    }
+
+    void Vulkan_Command_Pool::record_upload_barrier(const VkImageMemoryBarrier& barrier, const VkPipelineStageFlags destination_stage)
+    {
+        record_upload_barrier(nullptr, &barrier, destination_stage);
+    }
+
+    void Vulkan_Command_Pool::record_upload_barrier(const VkBufferMemoryBarrier* buffer_barrier, const VkImageMemoryBarrier* image_barrier, const VkPipelineStageFlags destination_stage)
+    {
+        begin_upload_batch();
+
+        VkBufferMemoryBarrier buffer_barriers[2]{};
+        VkImageMemoryBarrier image_barriers[2]{};
+
+        if (buffer_barrier != nullptr)
+        {
+            buffer_barriers[0] = buffer_barriers[1] = *buffer_barrier;
+        }
+
+        if (image_barrier != nullptr)
+        {
+            image_barriers[0] = image_barriers[1] = *image_barrier;
+        }
+
+        uint32_t buffer_barrier_count = buffer_barrier != nullptr ? 1 : 0;
+        uint32_t image_barrier_count = image_barrier != nullptr ? 1 : 0;
+
+        if (!vulkan_instance->has_dedicated_transfer_queue())
+        {
+            //Same queue, a regular barrier after the copies
+            buffer_barriers[0].srcQueueFamilyIndex = buffer_barriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            image_barriers[0].srcQueueFamilyIndex = image_barriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+            vkCmdPipelineBarrier(get_upload_graphics_commands(), VK_PIPELINE_STAGE_TRANSFER_BIT, destination_stage, 0,
+                0, nullptr, buffer_barrier_count, buffer_barriers, image_barrier_count, image_barriers);
+        }
+        else
+        {
+            //Release on the transfer queue, the destination access is ignored there
+            for (uint32_t i = 0; i < 2; i++)
+            {
+                buffer_barriers[i].srcQueueFamilyIndex = image_barriers[i].srcQueueFamilyIndex = transfer_family;
+                buffer_barriers[i].dstQueueFamilyIndex = image_barriers[i].dstQueueFamilyIndex = graphics_family;
+            }
+
+            buffer_barriers[0].dstAccessMask = 0;
+            image_barriers[0].dstAccessMask = 0;
+
+            vkCmdPipelineBarrier(get_upload_transfer_commands(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+                0, nullptr, buffer_barrier_count, buffer_barriers, image_barrier_count, image_barriers);
+
+            //Acquire on the graphics queue with an identical barrier, the source access is already made available by the release
+            buffer_barriers[1].srcAccessMask = 0;
+            image_barriers[1].srcAccessMask = 0;
+
+            vkCmdPipelineBarrier(get_upload_graphics_commands(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, destination_stage, 0,
+                0, nullptr, buffer_barrier_count, &buffer_barriers[1], image_barrier_count, &image_barriers[1]);
+        }
+
+        end_upload_batch();
+    }
+
+    void Vulkan_Command_Pool::release_staging_buffer(Buffer& staging_buffer)
+    {
+        if (upload_batch.depth == 0)
+        {
+            staging_buffer.destroy(vulkan_instance->allocator);
+            return;
+        }
+
+        upload_batch.staging_buffers.push_back(staging_buffer);
     }
 
     VkCommandBuffer Vulkan_Command_Pool::reset_command_buffer(int current_frame)
@@ -97,23 +491,139 @@ namespace vulvox
         return command_buffers[current_frame];
     }
 
-    void Vulkan_Command_Pool::copy_buffer(VkBuffer src_buffer, VkBuffer dst_buffer, VkDeviceSize size)
+    void Vulkan_Command_Pool::copy_buffer(VkBuffer src_buffer, VkBuffer dst_buffer, VkDeviceSize size, VkDeviceSize dst_offset)
     {
-        VkCommandBuffer command_buffer = begin_single_time_commands();
+        begin_upload_batch();
+
+        VkCommandBuffer command_buffer = begin_transfer_commands();
 
         //Record copy
         VkBufferCopy copy_region{};
         copy_region.srcOffset = 0; // Optional
-        copy_region.dstOffset = 0; // Optional
+        copy_region.dstOffset = dst_offset;
         copy_region.size = size;
 
         vkCmdCopyBuffer(command_buffer, src_buffer, dst_buffer, 1, &copy_region);
 
-        end_single_time_commands(command_buffer);
+        end_transfer_commands();
+
+        //Hand the copied range to the graphics queue, any later use of the buffer waits for the copy
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+        barrier.buffer = dst_buffer;
+        barrier.offset = dst_offset;
+        barrier.size = size;
+
+        record_upload_barrier(barrier, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+
+        end_upload_batch();
+    }
+
+    void Vulkan_Command_Pool::create_worker_command_buffers(const int frames_in_flight, const uint32_t worker_count)
+    {
+        destroy_worker_command_buffers();
+
+        if (worker_count == 0)
+        {
+            return;
+        }
+
+        Queue_Family_Indices queue_family_indices = vulkan_instance->get_queue_families(vulkan_instance->surface);
+
+        worker_command_pools.resize(frames_in_flight);
+
+        for (auto& frame_pools : worker_command_pools)
+        {
+            frame_pools.resize(worker_count);
+
+            for (auto& worker_pool : frame_pools)
+            {
+                //No reset flag, the whole pool is reset once per frame which is cheaper than resetting buffers one by one
+                VkCommandPoolCreateInfo pool_info{};
+                pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+                pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+                pool_info.queueFamilyIndex = queue_family_indices.graphics_family.value();
+
+                if (vkCreateCommandPool(vulkan_instance->device, &pool_info, nullptr, &worker_pool.command_pool) != VK_SUCCESS)
+                {
+                    throw std::runtime_error("Failed to create worker command pool!");
+                }
+
+                VkCommandBufferAllocateInfo alloc_info{};
+                alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+                alloc_info.commandPool = worker_pool.command_pool;
+                alloc_info.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY; //Executed by the primary command buffer of the frame
+                alloc_info.commandBufferCount = 1;
+
+                if (vkAllocateCommandBuffers(vulkan_instance->device, &alloc_info, &worker_pool.command_buffer) != VK_SUCCESS)
+                {
+                    throw std::runtime_error("Failed to allocate worker command buffer!");
+                }
+            }
+        }
+    }
+
+    void Vulkan_Command_Pool::destroy_worker_command_buffers()
+    {
+        for (auto& frame_pools : worker_command_pools)
+        {
+            for (auto& worker_pool : frame_pools)
+            {
+                vkDestroyCommandPool(vulkan_instance->device, worker_pool.command_pool, nullptr);
+            }
+        }
+
+        worker_command_pools.clear();
+    }
+
+    void Vulkan_Command_Pool::reset_worker_command_buffers(const int current_frame)
+    {
+        if (worker_command_pools.empty())
+        {
+            return;
+        }
+
+        for (auto& worker_pool : worker_command_pools[current_frame])
+        {
+            vkResetCommandPool(vulkan_instance->device, worker_pool.command_pool, 0);
+        }
+    }
+
+    VkCommandBuffer Vulkan_Command_Pool::get_worker_command_buffer(const int current_frame, const uint32_t worker) const
+    {
+        return worker_command_pools[current_frame][worker].command_buffer;
+    }
+
+    uint32_t Vulkan_Command_Pool::get_worker_count() const
+    {
+        return worker_command_pools.empty() ? 0 : static_cast<uint32_t>(worker_command_pools.front().size());
     }
 
     void Vulkan_Command_Pool::destroy()
     {
+        destroy_worker_command_buffers();
+
+        wait_for_uploads();
+
+        for (VkFence fence : free_upload_fences)
+        {
+            vkDestroyFence(vulkan_instance->device, fence, nullptr);
+        }
+
+        for (VkSemaphore semaphore : free_upload_semaphores)
+        {
+            vkDestroySemaphore(vulkan_instance->device, semaphore, nullptr);
+        }
+
+        free_upload_fences.clear();
+        free_upload_semaphores.clear();
+
+        vkDestroyFence(vulkan_instance->device, upload_fence, nullptr);
+        vkDestroySemaphore(vulkan_instance->device, upload_semaphore, nullptr);
+        vkDestroyCommandPool(vulkan_instance->device, transfer_command_pool, nullptr);
+
         //Also destroys the command buffers
         vkDestroyCommandPool(vulkan_instance->device, command_pool, nullptr);
     }
@@ -11,24 +11,168 @@ namespace vulvox
         void create_command_pool();
         void create_command_buffers(int frames_in_flight);
 
+        /// <summary>
+        /// Graphics queue commands, submitted at the end unless an upload batch is open, then they are part of the batch.
+        /// </summary>
         VkCommandBuffer begin_single_time_commands();
-        void end_single_time_commands(VkCommandBuffer command_buffer);
+        void end_single_time_commands();
+
+        /// <summary>
+        /// Same as the single time commands, but recorded for the dedicated transfer queue when the device has one.
+        /// Only use these for copies and transfer stage barriers, hand resources over with record_upload_barrier afterwards.
+        /// </summary>
+        VkCommandBuffer begin_transfer_commands();
+        void end_transfer_commands();
 
         VkCommandBuffer reset_command_buffer(int current_frame);
 
         /// <summary>
-        /// Creates a temporary command buffer that transfers data between scr and dst buffers, executed immediately
+        /// Copies between the src and dst buffers on the transfer queue and makes the result visible to the graphics queue.
+        /// Executed immediately, or at the end of the upload batch when one is open.
+        /// </summary>
+        void copy_buffer(VkBuffer src_buffer, VkBuffer dst_buffer, VkDeviceSize size, VkDeviceSize dst_offset = 0);
+
+        /// <summary>
+        /// Starts collecting uploads, until the matching end_upload_batch all copies, layout transitions and single time commands
+        /// are recorded into one command buffer per queue and submitted together with a single fence, instead of a submit and wait per operation.
+        /// Batches nest, only the outermost end submits. Resources uploaded in a batch can only be used after it ended.
+        /// </summary>
+        void begin_upload_batch();
+        void end_upload_batch();
+
+        /// <summary>
+        /// Identifies the open upload batch, 0 when no batch is open. Uploads recorded now are only finished once this batch is.
+        /// </summary>
+        uint64_t get_upload_batch_ticket() const;
+
+        /// <summary>
+        /// Ends the upload batch like end_upload_batch, but the outermost end submits without waiting for the GPU.
+        /// The batch is tracked by its fence, is_upload_finished reports it once collect_finished_uploads has seen the fence signal.
         /// </summary>
-        void copy_buffer(VkBuffer src_buffer, VkBuffer dst_buffer, VkDeviceSize size);
+        void end_upload_batch_async();
+
+        /// <summary>
+        /// True once the batch of the ticket has been submitted and finished on the GPU, false while it is still open (e.g. nested in an outer batch)
+        /// or submitted by end_upload_batch_async and not collected yet.
+        /// </summary>
+        bool is_upload_finished(const uint64_t ticket) const;
+
+        /// <summary>
+        /// Releases the command buffers and staging buffers of the async batches whose fence signaled, without waiting for the others.
+        /// </summary>
+        void collect_finished_uploads();
+
+        /// <summary>
+        /// Blocks until every async batch finished and releases them.
+        /// </summary>
+        void wait_for_uploads();
+
+        /// <summary>
+        /// Makes the transfer writes covered by the barrier visible to destination_stage on the graphics queue.
+        /// With a dedicated transfer queue this is a queue family ownership transfer, released in the transfer commands and acquired in the graphics commands.
+        /// The barrier holds the resource, range, access masks and (for images) the layout transition, the queue family indices are filled in here.
+        /// </summary>
+        void record_upload_barrier(const VkBufferMemoryBarrier& barrier, const VkPipelineStageFlags destination_stage);
+        void record_upload_barrier(const VkImageMemoryBarrier& barrier, const VkPipelineStageFlags destination_stage);
+
+        /// <summary>
+        /// Destroys the staging buffer once the uploads that read it are finished, immediately when no upload batch is open.
+        /// </summary>
+        void release_staging_buffer(Buffer& staging_buffer);
+
+        /// <summary>
+        /// Creates a command pool with a single secondary command buffer for every worker in every frame in flight.
+        /// Command pools are externally synchronized, so every worker thread records into its own pool without locking.
+        /// Replaces the previous worker pools, 0 workers only destroys them.
+        /// </summary>
+        void create_worker_command_buffers(const int frames_in_flight, const uint32_t worker_count);
+        void destroy_worker_command_buffers();
+
+        /// <summary>
+        /// Resets all worker pools of the frame at once, only call this after the frame's fence has signaled.
+        /// </summary>
+        void reset_worker_command_buffers(const int current_frame);
+        VkCommandBuffer get_worker_command_buffer(const int current_frame, const uint32_t worker) const;
+        uint32_t get_worker_count() const;
 
 
         void destroy();
 
     private:
 
+        //Batch submitted by end_upload_batch_async, kept until its fence signals
+        struct In_Flight_Upload
+        {
+            uint64_t ticket = 0;
+
+            VkFence fence = VK_NULL_HANDLE;
+            VkSemaphore semaphore = VK_NULL_HANDLE; //Only with a dedicated transfer queue
+
+            VkCommandBuffer graphics_commands = VK_NULL_HANDLE;
+            VkCommandBuffer transfer_commands = VK_NULL_HANDLE;
+
+            std::vector<Buffer> staging_buffers;
+        };
+
+        //Command buffers of the open batch are begun on first use, so a batch without transfer work doesn't submit to the transfer queue
+        VkCommandBuffer get_upload_graphics_commands();
+        VkCommandBuffer get_upload_transfer_commands();
+
+        void create_upload_sync_objects();
+
+        //Fence and (with a dedicated transfer queue) semaphore for an async batch, reused from finished batches when possible
+        void acquire_async_sync_objects(const bool with_semaphore, VkFence& fence, VkSemaphore& semaphore);
+
+        //Shared by both ends, the outermost end submits and waits for the fence unless wait is false
+        void close_upload_batch(const bool wait);
+        void submit_upload_batch(const bool wait);
+
+        //Frees the command buffers and staging buffers of a finished batch and resets its fence
+        void release_upload(In_Flight_Upload& upload);
+
+        //Shared by both barrier overloads, one of the barriers is nullptr
+        void record_upload_barrier(const VkBufferMemoryBarrier* buffer_barrier, const VkImageMemoryBarrier* image_barrier, const VkPipelineStageFlags destination_stage);
+
         Vulkan_Instance* vulkan_instance;
 
         VkCommandPool command_pool;
         std::vector<VkCommandBuffer> command_buffers;
+
+        uint32_t graphics_family = 0;
+
+        struct Upload_Batch
+        {
+            uint32_t depth = 0;
+            uint64_t ticket = 0;
+
+            VkCommandBuffer graphics_commands = VK_NULL_HANDLE;
+            VkCommandBuffer transfer_commands = VK_NULL_HANDLE; //Only used with a dedicated transfer queue
+
+            std::vector<Buffer> staging_buffers;
+        };
+
+        Upload_Batch upload_batch;
+        uint64_t next_upload_ticket = 1;
+
+        std::vector<In_Flight_Upload> in_flight_uploads;
+
+        //Sync objects of collected async batches
+        std::vector<VkFence> free_upload_fences;
+        std::vector<VkSemaphore> free_upload_semaphores;
+
+        //Created on the first upload, the frame command buffers of the pool don't need them
+        VkFence upload_fence = VK_NULL_HANDLE;
+        VkSemaphore upload_semaphore = VK_NULL_HANDLE; //Transfer to graphics submit, only with a dedicated transfer queue
+        VkCommandPool transfer_command_pool = VK_NULL_HANDLE;
+        uint32_t transfer_family = 0;
+
+        struct Worker_Command_Pool
+        {
+            VkCommandPool command_pool = VK_NULL_HANDLE;
+            VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+        };
+
+        //Indexed by [frame][worker]
+        std::vector<std::vector<Worker_Command_Pool>> worker_command_pools;
     };
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "pch.h"
+#include "vulkan_descriptor_allocator.h"
+
+namespace vulvox
+{
+    void Vulkan_Descriptor_Allocator::init(Vulkan_Instance* vulkan_instance, const uint32_t initial_sets_per_pool, std::span<const Pool_Size_Ratio> pool_size_ratios)
+    {
+        this->vulkan_instance = vulkan_instance;
+        this->pool_size_ratios.assign(pool_size_ratios.begin(), pool_size_ratios.end());
+
+        sets_per_pool = std::max(initial_sets_per_pool, 1u);
+        pools.push_back(create_pool(sets_per_pool));
+    }
+
+    void Vulkan_Descriptor_Allocator::destroy()
+    {
+        //Descriptor sets are destroyed with their pool
+        for (auto& pool : pools)
+        {
+            vkDestroyDescriptorPool(vulkan_instance->device, pool, nullptr);
+        }
+
+        pools.clear();
+        free_sets.clear();
+    }
+
+    VkDescriptorSet Vulkan_Descriptor_Allocator::allocate(VkDescriptorSetLayout layout)
+    {
+        //Reuse a freed set of the same layout before taking new memory from the pools
+        if (auto it = free_sets.find(layout); it != free_sets.end() && !it->second.empty())
+        {
+            VkDescriptorSet descriptor_set = it->second.back();
+            it->second.pop_back();
+            return descriptor_set;
+        }
+
+        VkDescriptorSetAllocateInfo allocate_info{};
+        allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocate_info.descriptorPool = pools.back();
+        allocate_info.descriptorSetCount = 1;
+        allocate_info.pSetLayouts = &layout;
+
+        VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+        VkResult result = vkAllocateDescriptorSets(vulkan_instance->device, &allocate_info, &descriptor_set);
+
+        //The current pool is full, continue in a new (larger) pool
+        if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)
+        {
+            sets_per_pool = std::min(static_cast<uint32_t>(sets_per_pool * POOL_GROWTH_FACTOR), MAX_SETS_PER_POOL);
+            pools.push_back(create_pool(sets_per_pool));
+
+            allocate_info.descriptorPool = pools.back();
+            result = vkAllocateDescriptorSets(vulkan_instance->device, &allocate_info, &descriptor_set);
+        }
+
+        if (result != VK_SUCCESS)
+        {
+            std::string error_string{ string_VkResult(result) };
+            throw std::runtime_error("Failed to allocate descriptor set! " + error_string);
+        }
+
+        return descriptor_set;
+    }
+
+    void Vulkan_Descriptor_Allocator::free(VkDescriptorSetLayout layout, VkDescriptorSet descriptor_set)
+    {
+        if (descriptor_set == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        free_sets[layout].push_back(descriptor_set);
+    }
+
+    uint32_t Vulkan_Descriptor_Allocator::get_pool_count() const
+    {
+        return static_cast<uint32_t>(pools.size());
+    }
+
+    VkDescriptorPool Vulkan_Descriptor_Allocator::create_pool(const uint32_t set_count)
+    {
+        std::vector<VkDescriptorPoolSize> pool_sizes;
+
+        for (const auto& pool_size_ratio : pool_size_ratios)
+        {
+            uint32_t descriptor_count = std::max(static_cast<uint32_t>(pool_size_ratio.ratio * set_count), 1u);
+            pool_sizes.push_back({ pool_size_ratio.type, descriptor_count });
+        }
+
+        VkDescriptorPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        pool_info.poolSizeCount = static_cast<uint32_t>(pool_sizes.size());
+        pool_info.pPoolSizes = pool_sizes.data();
+        pool_info.maxSets = set_count;
+        pool_info.flags = 0; //Sets are recycled through the free lists instead of freed individually
+
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+
+        if (vkCreateDescriptorPool(vulkan_instance->device, &pool_info, nullptr, &pool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create descriptor pool!");
+        }
+
+        return pool;
+    }
+}
\ No newline at end of file
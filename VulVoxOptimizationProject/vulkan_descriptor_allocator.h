@@ -0,0 +1,60 @@
+#pragma once
+
+namespace vulvox
+{
+    /// <summary>
+    /// Growable pool of descriptor pools for descriptor sets that live as long as the resource they describe (textures, uniform buffers).
+    /// A new pool is created when the current ones run out of memory, so the amount of loaded textures is not limited by a fixed pool size.
+    /// Freed sets are kept in a free list per set layout and handed out again by the next allocation with the same layout,
+    /// this avoids VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT and the fragmentation that comes with it.
+    /// </summary>
+    class Vulkan_Descriptor_Allocator
+    {
+    public:
+
+        Vulkan_Descriptor_Allocator() = default;
+
+        /// <summary>
+        /// Descriptor count of a type per set, every pool gets room for this many descriptors times its set count.
+        /// </summary>
+        struct Pool_Size_Ratio
+        {
+            VkDescriptorType type;
+            float ratio;
+        };
+
+        void init(Vulkan_Instance* vulkan_instance, const uint32_t initial_sets_per_pool, std::span<const Pool_Size_Ratio> pool_size_ratios);
+        void destroy();
+
+        /// <summary>
+        /// Returns a recycled set of the layout or allocates a new one, creating a new pool when all pools are full.
+        /// Recycled sets still contain the descriptors of their previous use and have to be written before use.
+        /// </summary>
+        VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+
+        /// <summary>
+        /// Returns the set to the free list of its layout, the caller makes sure the GPU no longer uses it.
+        /// </summary>
+        void free(VkDescriptorSetLayout layout, VkDescriptorSet descriptor_set);
+
+        uint32_t get_pool_count() const;
+
+        //Pools grow by this factor up to the max, later pools don't become larger to keep unused memory low
+        static constexpr float POOL_GROWTH_FACTOR = 2.0f;
+        static constexpr uint32_t MAX_SETS_PER_POOL = 4096;
+
+    private:
+
+        VkDescriptorPool create_pool(const uint32_t set_count);
+
+        Vulkan_Instance* vulkan_instance = nullptr;
+
+        std::vector<Pool_Size_Ratio> pool_size_ratios;
+        uint32_t sets_per_pool = 0;
+
+        //Pools in creation order, new allocations are only tried in the last one, earlier pools are full
+        std::vector<VkDescriptorPool> pools;
+
+        std::unordered_map<VkDescriptorSetLayout, std::vector<VkDescriptorSet>> free_sets;
+    };
+}
\ No newline at end of file
@@ -3,10 +3,10 @@
 
 namespace vulvox
 {
-    const int Vulkan_Engine::MAX_FRAMES_IN_FLIGHT = 2;
+    thread_local Vulkan_Engine::Recording_Context* Vulkan_Engine::thread_recording_context = nullptr;
 
 
-    Vulkan_Engine::Vulkan_Engine() : swap_chain(&vulkan_instance)
+    Vulkan_Engine::Vulkan_Engine() : swap_chain(&vulkan_instance), offscreen_target(&vulkan_instance)
     {
     }
 
@@ -39,23 +39,48 @@ namespace vulvox
     {
         std::cout << "Init vulkan.." << std::endl;
 
-        vulkan_instance.init_instance();
-        vulkan_instance.init_surface(window);
+        vulkan_instance.init_instance(headless);
+
+        //Headless rendering has no window, so there is no surface to present to
+        if (!headless)
+        {
+            vulkan_instance.init_surface(window);
+        }
+
         vulkan_instance.init_device();
         vulkan_instance.init_allocator();
 
-        swap_chain.create_swap_chain(window, vulkan_instance.surface);
-        mvp_handler.set_aspect_ratio(static_cast<float>(width) / static_cast<float>(height));
+        if (headless)
+        {
+            //Render into one offscreen image per frame in flight instead of the swap chain images
+            offscreen_target.create_targets(width, height, frames_in_flight);
+        }
+        else
+        {
+            swap_chain.create_swap_chain(window, vulkan_instance.surface);
+        }
+
+        VkExtent2D render_extent = get_render_extent();
+        mvp_handler.set_aspect_ratio(static_cast<float>(render_extent.width) / static_cast<float>(render_extent.height));
 
         create_render_pass();
         create_mvp_descriptor_set_layout();
         create_texture_descriptor_set_layout();
+        bindless_table.init(&vulkan_instance);
         create_graphics_pipeline();
-        command_pool = Vulkan_Command_Pool(&vulkan_instance, MAX_FRAMES_IN_FLIGHT);
+        command_pool = Vulkan_Command_Pool(&vulkan_instance, frames_in_flight);
+        upload_command_pool = Vulkan_Command_Pool(&vulkan_instance, frames_in_flight);
+        gpu_profiler.init(&vulkan_instance, frames_in_flight);
+        instance_culler.init(&vulkan_instance, frames_in_flight, "../shaders/instance_cull_comp.spv");
         create_depth_resources();
         create_framebuffers();
 
-        buffer_manager.init(&vulkan_instance, MAX_FRAMES_IN_FLIGHT);
+        buffer_manager.init(&vulkan_instance, frames_in_flight);
+        mesh_buffer.init(&vulkan_instance);
+        pending_frame_captures.resize(frames_in_flight);
+
+        //Single threaded recording until workers are requested
+        recording_contexts.resize(1);
 
         create_descriptor_pool();
         create_descriptor_sets();
@@ -64,16 +89,38 @@ namespace vulvox
         std::cout << "Vulkan initialized." << std::endl;
     }
 
-    void Vulkan_Engine::init(uint32_t width, uint32_t height)
+    void Vulkan_Engine::init(uint32_t width, uint32_t height, const uint32_t requested_frames_in_flight)
     {
+        set_frames_in_flight(requested_frames_in_flight);
         init_window(width, height);
         init_vulkan();
         is_initialized = true;
     }
 
+    void Vulkan_Engine::init_headless(uint32_t width, uint32_t height, const uint32_t requested_frames_in_flight)
+    {
+        std::cout << "Init headless.." << std::endl;
+
+        set_frames_in_flight(requested_frames_in_flight);
+
+        this->width = width;
+        this->height = height;
+        headless = true;
+
+        init_vulkan();
+        is_initialized = true;
+    }
+
     void Vulkan_Engine::init_imgui()
     {
-        imgui_context = std::make_unique<ImGui_Context>(window, vulkan_instance, render_pass, MAX_FRAMES_IN_FLIGHT);
+        if (headless)
+        {
+            std::cout << "Dear ImGui requires a window and is not available in headless mode." << std::endl;
+            return;
+        }
+
+        //The imgui backend requires at least two sets of frame buffers, extra sets are harmless with a single frame in flight
+        imgui_context = std::make_unique<ImGui_Context>(window, vulkan_instance, render_pass, std::max(frames_in_flight, 2u));
     }
 
     void Vulkan_Engine::disable_imgui()
@@ -93,9 +140,21 @@ namespace vulvox
             return;
         }
 
+        //Abandon the async loads, joining the loader threads lets their last parse finish (the futures report a broken promise)
+        loader_pool.reset();
+        pending_model_loads.clear();
+        pending_texture_loads.clear();
+
         //Wait until all operations are completed before cleanup
         vkDeviceWaitIdle(vulkan_instance.device);
 
+        //All frames are finished, hand out the captures that are still waiting for their frame to complete
+        for (uint32_t frame = 0; frame < frames_in_flight; frame++)
+        {
+            deliver_frame_captures(frame);
+        }
+        frame_capture_requests.clear();
+
         if (imgui_context)
         {
             imgui_context.reset();
@@ -105,45 +164,64 @@ namespace vulvox
 
         vkDestroyPipeline(vulkan_instance.device, instance_plane_pipeline, nullptr);
         vkDestroyPipeline(vulkan_instance.device, vertex_pipeline, nullptr);
-        vkDestroyPipeline(vulkan_instance.device, instance_pipeline, nullptr);
+        for (auto& pipeline : instance_pipelines)
+        {
+            vkDestroyPipeline(vulkan_instance.device, pipeline, nullptr);
+        }
         vkDestroyPipeline(vulkan_instance.device, instance_tex_array_pipeline, nullptr);
+        vkDestroyPipeline(vulkan_instance.device, bindless_pipeline, nullptr);
+        vkDestroyPipelineLayout(vulkan_instance.device, bindless_pipeline_layout, nullptr);
 
         vkDestroyPipelineLayout(vulkan_instance.device, pipeline_layout, nullptr);
         vkDestroyRenderPass(vulkan_instance.device, render_pass, nullptr);
 
-        //Descriptor sets will be destroyed with the pool
-        vkDestroyDescriptorPool(vulkan_instance.device, descriptor_pool, nullptr);
+        //Descriptor sets will be destroyed with the pools
+        descriptor_allocator.destroy();
 
-        //Texture cleanup
-        for (auto& [name, texture] : textures)
+        //Texture cleanup, including the uploads of async loads that were never completed
+        for (auto& uploaded_load : uploaded_texture_loads)
         {
-            texture.destroy();
+            uploaded_load.resource.destroy();
         }
+        uploaded_texture_loads.clear();
 
+        textures.for_each([](Texture& texture) { texture.image.destroy(); });
         textures.clear();
 
-        for (auto& [name, texture_array] : texture_arrays)
-        {
-            texture_array.destroy();
-        }
-
+        texture_arrays.for_each([](Texture& texture_array) { texture_array.image.destroy(); });
         texture_arrays.clear();
 
         //Cleanup descriptor set layout and buffers
         vkDestroyDescriptorSetLayout(vulkan_instance.device, mvp_descriptor_set_layout, nullptr);
         vkDestroyDescriptorSetLayout(vulkan_instance.device, texture_descriptor_set_layout, nullptr);
+        bindless_table.destroy();
 
         //Clear all the models and their (vertex & index) buffers
-        for (auto& [name, model] : models)
+        for (auto& uploaded_load : uploaded_model_loads)
         {
-            model.destroy();
+            uploaded_load.resource.destroy();
         }
+        uploaded_model_loads.clear();
 
+        models.for_each([](Model& model) { model.destroy(); });
         models.clear();
 
+        mesh_buffer.destroy();
+
+        for (auto& instance_set : instance_sets)
+        {
+            if (instance_set.buffer.buffer != VK_NULL_HANDLE)
+            {
+                instance_set.buffer.destroy(vulkan_instance.allocator);
+            }
+        }
+
+        instance_sets.clear();
+        free_instance_sets.clear();
+
         buffer_manager.destroy();
 
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+        for (size_t i = 0; i < frames_in_flight; i++)
         {
             vkDestroySemaphore(vulkan_instance.device, image_available_semaphores.at(i), nullptr);
             vkDestroySemaphore(vulkan_instance.device, render_finished_semaphores.at(i), nullptr);
@@ -151,15 +229,21 @@ namespace vulvox
         }
 
         command_pool.destroy();
+        upload_command_pool.destroy();
+        gpu_profiler.destroy();
+        instance_culler.destroy();
 
         vulkan_instance.cleanup_allocator();
         vulkan_instance.cleanup_device();
         vulkan_instance.cleanup_surface();
         vulkan_instance.cleanup_instance();
 
-        glfwDestroyWindow(window);
+        if (!headless)
+        {
+            glfwDestroyWindow(window);
 
-        glfwTerminate();
+            glfwTerminate();
+        }
     }
 
     GLFWwindow* Vulkan_Engine::get_glfw_window_ptr()
@@ -177,411 +261,2157 @@ namespace vulvox
         this->width = new_width;
         this->height = new_height;
 
+        if (headless)
+        {
+            //No window to resize, rebuild the offscreen targets directly
+            recreate_offscreen_targets();
+            return;
+        }
+
         //Will also call the resize callback so the render engine will recreate the swapchain
         glfwSetWindowSize(get_glfw_window_ptr(), new_width, new_height);
     }
 
-    void Vulkan_Engine::load_model(const std::string& model_name, const std::filesystem::path& path)
+    Model_Handle Vulkan_Engine::load_model(const std::string& model_name, const std::filesystem::path& path)
     {
         if (models.contains(model_name))
         {
             std::cout << "Attempted to load model " << model_name << " but a model with the same name was already loaded. Path was: " << path << std::endl;
-            return;
+            return models.find(model_name);
         }
 
-        auto [model_it, succeeded] = models.try_emplace(model_name, &vulkan_instance, command_pool, path);
-
-        if (!succeeded)
-        {
-            std::string error_string = "Failed to load model " + model_name + " with path: " + path.string();
-            throw std::runtime_error(error_string);
-        }
+        return models.insert(model_name, Model(&mesh_buffer, command_pool, path));
     }
 
-    void Vulkan_Engine::load_texture(const std::string& texture_name, const std::filesystem::path& path)
+    Texture_Handle Vulkan_Engine::load_texture(const std::string& texture_name, const std::filesystem::path& path)
     {
         if (textures.contains(texture_name))
         {
             std::cout << "Attempted to load texture " << texture_name << " but a texture with the same name was already loaded. Path was: " << path << std::endl;
-            return;
+            return textures.find(texture_name);
         }
 
-        auto [texture_it, succeeded] = textures.try_emplace(texture_name, Image::create_texture_image(vulkan_instance, command_pool, path));
-
-        if (!succeeded)
-        {
-            std::string error_string = "Failed to load texture " + texture_name + " with path: " + path.string();
-            throw std::runtime_error(error_string);
-        }
+        return insert_texture(texture_name, Image::create_texture_image(vulkan_instance, command_pool, texture_cache.resolve(path)));
+    }
 
+    Texture_Handle Vulkan_Engine::insert_texture(const std::string& texture_name, const Image& image)
+    {
+        Texture texture{};
+        texture.image = image;
+        texture.descriptor_set = create_texture_descriptor_set(texture.image);
 
-        auto [texture_descriptor_it, descriptor_succeeded] = texture_descriptor_sets.try_emplace(texture_name, create_texture_descriptor_set(texture_it->second));
+        Texture_Handle handle = textures.insert(texture_name, texture);
 
-        if (!descriptor_succeeded)
+        //The slot index doubles as the element in the bindless texture table, reused slots overwrite the element of the unloaded texture
+        if (bindless_table.is_available() && !bindless_table.set_texture(handle.index, texture.image))
         {
-            throw std::runtime_error("Failed to allocate descriptor sets! (map allocation failed)");
+            std::cout << "Texture " << texture_name << " does not fit in the bindless texture table, it can only be drawn with its own descriptor set." << std::endl;
         }
+
+        return handle;
     }
 
-    void Vulkan_Engine::load_texture_array(const std::string& texture_name, const std::vector<std::filesystem::path>& paths)
+    Texture_Array_Handle Vulkan_Engine::load_texture_array(const std::string& texture_name, const std::vector<std::filesystem::path>& paths)
     {
         if (texture_arrays.contains(texture_name))
         {
             std::cout << "Attempted to load texture array " << texture_name << " but a texture array with the same name was already loaded." << std::endl;
-            return;
+            return texture_arrays.find(texture_name);
+        }
+
+        std::vector<std::filesystem::path> resolved_paths;
+        resolved_paths.reserve(paths.size());
+
+        for (const auto& path : paths)
+        {
+            resolved_paths.push_back(texture_cache.resolve(path));
         }
 
-        auto [texture_it, succeeded] = texture_arrays.try_emplace(texture_name, Image::create_texture_array_image(vulkan_instance, command_pool, paths));
+        Texture texture_array{};
+        texture_array.image = Image::create_texture_array_image(vulkan_instance, command_pool, resolved_paths);
+        texture_array.descriptor_set = create_texture_descriptor_set(texture_array.image);
 
-        if (!succeeded)
+        return texture_arrays.insert(texture_name, texture_array);
+    }
+
+    std::shared_future<Model_Handle> Vulkan_Engine::load_model_async(const std::string& model_name, const std::filesystem::path& path)
+    {
+        if (models.contains(model_name))
         {
-            std::string error_string = "Failed to load texture array " + texture_name;
-            throw std::runtime_error(error_string);
+            std::cout << "Attempted to load model " << model_name << " but a model with the same name was already loaded. Path was: " << path << std::endl;
+
+            std::promise<Model_Handle> loaded;
+            loaded.set_value(models.find(model_name));
+            return loaded.get_future().share();
         }
 
-        auto [texture_descriptor_it, descriptor_succeeded] = texture_array_descriptor_sets.try_emplace(texture_name, create_texture_descriptor_set(texture_it->second));
+        for (const auto& pending_load : pending_model_loads)
+        {
+            if (pending_load.name == model_name)
+            {
+                return pending_load.handle;
+            }
+        }
 
-        if (!descriptor_succeeded)
+        for (const auto& uploaded_load : uploaded_model_loads)
         {
-            throw std::runtime_error("Failed to allocate descriptor sets! (map allocation failed)");
+            if (uploaded_load.name == model_name)
+            {
+                return uploaded_load.handle;
+            }
         }
 
+        Pending_Load<Model_Data, Model_Handle>& pending_load = pending_model_loads.emplace_back();
+        pending_load.name = model_name;
+        pending_load.data = get_loader_pool().submit([path]() { return Model::parse(path); });
+        pending_load.handle = pending_load.promise.get_future().share();
+
+        return pending_load.handle;
     }
 
-    void Vulkan_Engine::unload_model(const std::string& name)
+    std::shared_future<Texture_Handle> Vulkan_Engine::load_texture_async(const std::string& texture_name, const std::filesystem::path& path)
     {
+        if (textures.contains(texture_name))
+        {
+            std::cout << "Attempted to load texture " << texture_name << " but a texture with the same name was already loaded. Path was: " << path << std::endl;
+
+            std::promise<Texture_Handle> loaded;
+            loaded.set_value(textures.find(texture_name));
+            return loaded.get_future().share();
+        }
+
+        for (const auto& pending_load : pending_texture_loads)
+        {
+            if (pending_load.name == texture_name)
+            {
+                return pending_load.handle;
+            }
+        }
+
+        for (const auto& uploaded_load : uploaded_texture_loads)
+        {
+            if (uploaded_load.name == texture_name)
+            {
+                return uploaded_load.handle;
+            }
+        }
+
+        Pending_Load<Image_Data, Texture_Handle>& pending_load = pending_texture_loads.emplace_back();
+        pending_load.name = texture_name;
+        //The cache lookup hashes the file, which happens on the loader thread as well
+        pending_load.data = get_loader_pool().submit([path, cache = texture_cache]() { return Image::decode_texture(cache.resolve(path)); });
+        pending_load.handle = pending_load.promise.get_future().share();
+
+        return pending_load.handle;
     }
 
-    void Vulkan_Engine::unload_texture(const std::string& name)
+    void Vulkan_Engine::set_texture_cache_directory(const std::filesystem::path& directory)
     {
+        texture_cache.set_directory(directory);
     }
 
-    void Vulkan_Engine::unload_texture_array(const std::string& name)
+    void Vulkan_Engine::wait_for_async_loads()
     {
+        if (recording_frame)
+        {
+            std::cout << "Cannot wait for async loads while a frame is being recorded, skipping wait." << std::endl;
+            return;
+        }
+
+        //In chunks, so the staging buffers of a whole level are not alive at the same time.
+        //Loads in an upload batch the user opened are finished by its end_upload_batch instead.
+        while (!pending_model_loads.empty() || !pending_texture_loads.empty())
+        {
+            process_async_loads(ASYNC_UPLOADS_PER_FRAME, true);
+        }
+
+        //Uploads submitted by earlier frames
+        command_pool.wait_for_uploads();
+        complete_async_loads();
     }
 
-    void Vulkan_Engine::start_draw()
+    void Vulkan_Engine::process_async_loads(const uint32_t max_uploads, const bool wait)
     {
-        vkWaitForFences(vulkan_instance.device, 1, &in_flight_fences[current_frame], VK_TRUE, UINT64_MAX);
-
-        //Ask the swapchain for a render image to target
-        VkResult result = vkAcquireNextImageKHR(vulkan_instance.device, swap_chain.swap_chain, UINT64_MAX, image_available_semaphores[current_frame], nullptr, &current_image_index);
+        //Uploads submitted by earlier frames that finished in the meantime
+        command_pool.collect_finished_uploads();
 
-        if (result == VK_ERROR_OUT_OF_DATE_KHR)
+        if (pending_model_loads.empty() && pending_texture_loads.empty())
         {
-            //Swap chain in not compatible with the current window size, recreate
-            recreate_swap_chain();
+            complete_async_loads();
             return;
         }
-        else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+
+        VULVOX_PROFILE_SCOPE("Vulkan_Engine::process_async_loads");
+
+        uint32_t upload_count = 0;
+
+        //All uploads of this call share one submit, or join the batch the user opened.
+        //Frames don't wait for it, the resources are only added once a later frame sees the batch finished.
+        command_pool.begin_upload_batch();
+        uint64_t upload_ticket = command_pool.get_upload_batch_ticket();
+
+        auto is_ready = [wait](const auto& pending_load)
+            {
+                return wait || pending_load.data.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            };
+
+        //Finished loads are uploaded in request order, a failed parse or upload is reported through the future
+        for (auto it = pending_model_loads.begin(); it != pending_model_loads.end() && upload_count < max_uploads;)
         {
-            throw std::runtime_error("Failed to acquire swap chain image!");
+            if (!is_ready(*it))
+            {
+                ++it;
+                continue;
+            }
+
+            try
+            {
+                Model_Data model_data = it->data.get();
+
+                //A synchronous load with the same name may have finished first
+                if (models.contains(it->name))
+                {
+                    it->promise.set_value(models.find(it->name));
+                }
+                else
+                {
+                    uploaded_model_loads.push_back({ it->name, Model(&mesh_buffer, command_pool, model_data), std::move(it->promise), it->handle, upload_ticket });
+                }
+            }
+            catch (const std::exception& exception)
+            {
+                std::cout << "Failed to load model " << it->name << " asynchronously: " << exception.what() << std::endl;
+                it->promise.set_exception(std::current_exception());
+            }
+
+            upload_count++;
+            it = pending_model_loads.erase(it);
         }
 
-        //Reset fence *after* confirming the swapchain is valid (prevents deadlock)
-        vkResetFences(vulkan_instance.device, 1, &in_flight_fences[current_frame]);
+        for (auto it = pending_texture_loads.begin(); it != pending_texture_loads.end() && upload_count < max_uploads;)
+        {
+            if (!is_ready(*it))
+            {
+                ++it;
+                continue;
+            }
 
-        //Tell our memory allocator a new frame has started (useful for optimization)
-        //The 2nd argument is the current swapchain index (this is badly documented online)
-        vmaSetCurrentFrameIndex(vulkan_instance.allocator, current_frame);
+            try
+            {
+                Image_Data image_data = it->data.get();
+
+                if (textures.contains(it->name))
+                {
+                    it->promise.set_value(textures.find(it->name));
+                }
+                else
+                {
+                    uploaded_texture_loads.push_back({ it->name, Image::create_texture_image(vulkan_instance, command_pool, image_data), std::move(it->promise), it->handle, upload_ticket });
+                }
+            }
+            catch (const std::exception& exception)
+            {
+                std::cout << "Failed to load texture " << it->name << " asynchronously: " << exception.what() << std::endl;
+                it->promise.set_exception(std::current_exception());
+            }
 
-        //Reset the instance buffer usage counter
-        buffer_manager.begin_frame();
+            upload_count++;
+            it = pending_texture_loads.erase(it);
+        }
 
-        //Update global variables (camera etc.)
-        update_uniform_buffer();
+        //Waiting keeps the staging buffers of the chunks in wait_for_async_loads from piling up
+        if (wait)
+        {
+            command_pool.end_upload_batch();
+        }
+        else
+        {
+            command_pool.end_upload_batch_async();
+        }
 
-        //Start recording a new command buffer for rendering
-        current_command_buffer = command_pool.reset_command_buffer(current_frame);
+        complete_async_loads();
+    }
 
-        // Start recording the command buffer and wait for draw calls
-        start_record_command_buffer();
+    void Vulkan_Engine::complete_async_loads()
+    {
+        std::erase_if(uploaded_model_loads, [this](auto& uploaded_load)
+            {
+                if (!command_pool.is_upload_finished(uploaded_load.upload_ticket))
+                {
+                    return false;
+                }
+
+                //A synchronous load with the same name may have finished while the upload was in flight
+                if (models.contains(uploaded_load.name))
+                {
+                    uploaded_load.resource.destroy();
+                    uploaded_load.promise.set_value(models.find(uploaded_load.name));
+                }
+                else
+                {
+                    uploaded_load.promise.set_value(models.insert(uploaded_load.name, uploaded_load.resource));
+                }
+
+                return true;
+            });
+
+        std::erase_if(uploaded_texture_loads, [this](auto& uploaded_load)
+            {
+                if (!command_pool.is_upload_finished(uploaded_load.upload_ticket))
+                {
+                    return false;
+                }
+
+                if (textures.contains(uploaded_load.name))
+                {
+                    uploaded_load.resource.destroy();
+                    uploaded_load.promise.set_value(textures.find(uploaded_load.name));
+                }
+                else
+                {
+                    uploaded_load.promise.set_value(insert_texture(uploaded_load.name, uploaded_load.resource));
+                }
+
+                return true;
+            });
+    }
 
-        if (imgui_context)
+    void Vulkan_Engine::begin_upload_batch()
+    {
+        command_pool.begin_upload_batch();
+    }
+
+    void Vulkan_Engine::end_upload_batch()
+    {
+        command_pool.end_upload_batch();
+
+        //Async loads uploaded while the batch was open
+        complete_async_loads();
+    }
+
+    void Vulkan_Engine::unload_model(const std::string& name)
+    {
+        Model_Handle handle = models.find(name);
+
+        if (!handle.is_valid())
         {
-            imgui_context->start_imgui_frame();
+            std::cout << "No model with name " << name << " is loaded, nothing to unload." << std::endl;
+            return;
         }
 
+        unload_model(handle);
     }
 
-    void Vulkan_Engine::end_draw()
+    void Vulkan_Engine::unload_model(const Model_Handle handle)
     {
-        if (imgui_context)
+        Model* model = models.get(handle);
+
+        if (model == nullptr)
         {
-            imgui_context->render_and_end_imgui_frame(current_command_buffer);
+            return;
         }
 
-        //Complete the command buffer before submitting it and presenting the image
-        end_record_command_buffer();
+        if (recording_frame)
+        {
+            std::cout << "Cannot unload model " << models.get_name(handle) << " while a frame is being recorded, skipping unload." << std::endl;
+            return;
+        }
 
-        VkSubmitInfo submit_info{};
-        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        //The buffers may still be read by frames in flight
+        vkDeviceWaitIdle(vulkan_instance.device);
 
-        //Which semaphore to wait for before execution and at which stage
-        std::array<VkSemaphore, 1> wait_semaphores = { image_available_semaphores[current_frame] };
-        std::array<VkPipelineStageFlags, 1> wait_stages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-        submit_info.waitSemaphoreCount = static_cast<uint32_t>(wait_semaphores.size());
-        submit_info.pWaitSemaphores = wait_semaphores.data();
-        submit_info.pWaitDstStageMask = wait_stages.data();
+        model->destroy();
+        models.erase(handle);
+    }
 
-        //Which semaphore to signal when the command buffer is done
-        std::array<VkSemaphore, 1> signal_semaphores = { render_finished_semaphores[current_frame] };
-        submit_info.signalSemaphoreCount = static_cast<uint32_t>(signal_semaphores.size());
-        submit_info.pSignalSemaphores = signal_semaphores.data();
+    void Vulkan_Engine::unload_texture(const std::string& name)
+    {
+        Texture_Handle handle = textures.find(name);
+
+        if (!handle.is_valid())
+        {
+            std::cout << "No texture with name " << name << " is loaded, nothing to unload." << std::endl;
+            return;
+        }
+
+        unload_texture(handle);
+    }
 
-        //Link command buffer
-        submit_info.commandBufferCount = 1;
-        submit_info.pCommandBuffers = &current_command_buffer;
+    void Vulkan_Engine::unload_texture(const Texture_Handle handle)
+    {
+        Texture* texture = textures.get(handle);
 
-        //Submit the command buffer so the GPU starts executing it
-        if (vkQueueSubmit(vulkan_instance.graphics_queue, 1, &submit_info, in_flight_fences[current_frame]) != VK_SUCCESS)
+        if (texture == nullptr)
         {
-            throw std::runtime_error("Failed to submit draw command buffer!");
+            return;
         }
 
-        VkPresentInfoKHR present_info{};
-        present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-        present_info.waitSemaphoreCount = 1;
-        present_info.pWaitSemaphores = signal_semaphores.data(); //Wait for semaphore before we can present
+        if (recording_frame)
+        {
+            std::cout << "Cannot unload texture " << textures.get_name(handle) << " while a frame is being recorded, skipping unload." << std::endl;
+            return;
+        }
 
-        std::array<VkSwapchainKHR, 1> swap_chains = { swap_chain.swap_chain };
-        present_info.swapchainCount = static_cast<uint32_t>(swap_chains.size());
-        present_info.pSwapchains = swap_chains.data();
-        present_info.pImageIndices = &current_image_index;
+        vkDeviceWaitIdle(vulkan_instance.device);
 
-        //Dont need to collect the draw results because the present function returns them as well
-        present_info.pResults = nullptr;
+        //The descriptor set is recycled by the next texture that is loaded
+        descriptor_allocator.free(texture_descriptor_set_layout, texture->descriptor_set);
+        texture->image.destroy();
+        textures.erase(handle);
+    }
 
-        //Present the result on screen
-        VkResult result = vkQueuePresentKHR(vulkan_instance.present_queue, &present_info);
+    void Vulkan_Engine::unload_texture_array(const std::string& name)
+    {
+        Texture_Array_Handle handle = texture_arrays.find(name);
 
-        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || framebuffer_resized)
+        if (!handle.is_valid())
         {
-            framebuffer_resized = false;
+            std::cout << "No texture array with name " << name << " is loaded, nothing to unload." << std::endl;
+            return;
+        }
 
-            //Swap chain in not compatible with the current window size, recreate
-            recreate_swap_chain();
+        unload_texture_array(handle);
+    }
+
+    void Vulkan_Engine::unload_texture_array(const Texture_Array_Handle handle)
+    {
+        Texture* texture_array = texture_arrays.get(handle);
+
+        if (texture_array == nullptr)
+        {
+            return;
         }
-        else if (result != VK_SUCCESS)
+
+        if (recording_frame)
         {
-            throw std::runtime_error("Failed to present swap chain image!");
+            std::cout << "Cannot unload texture array " << texture_arrays.get_name(handle) << " while a frame is being recorded, skipping unload." << std::endl;
+            return;
         }
 
-        //Rotate to next frame resources
-        current_frame = (current_frame++) % MAX_FRAMES_IN_FLIGHT;
+        vkDeviceWaitIdle(vulkan_instance.device);
+
+        descriptor_allocator.free(texture_descriptor_set_layout, texture_array->descriptor_set);
+        texture_array->image.destroy();
+        texture_arrays.erase(handle);
     }
 
-    void Vulkan_Engine::draw_model(const std::string& model_name, const std::string& texture_name, const glm::mat4& model_matrix)
+    Model_Handle Vulkan_Engine::find_model(const std::string& model_name) const
     {
-        if (!models.contains(model_name))
+        Model_Handle handle = models.find(model_name);
+
+        if (!handle.is_valid())
         {
             std::cout << "No model with name " << model_name << " is loaded, skipping draw call." << std::endl;
-            return;
         }
 
-        if (!textures.contains(texture_name))
+        return handle;
+    }
+
+    Texture_Handle Vulkan_Engine::find_texture(const std::string& texture_name) const
+    {
+        Texture_Handle handle = textures.find(texture_name);
+
+        if (!handle.is_valid())
         {
             std::cout << "No texture with name " << texture_name << " is loaded, skipping draw call." << std::endl;
-            return;
         }
 
-        //Set the vertex buffers
-        std::array<VkDeviceSize, 1> offsets = { 0 };
-        vkCmdBindVertexBuffers(current_command_buffer, 0, 1, &models.at(model_name).vertex_buffer.buffer, offsets.data());
+        return handle;
+    }
 
-        //Set the index buffers
-        std::vector<VkBuffer> index_buffers;
-        vkCmdBindIndexBuffer(current_command_buffer, models.at(model_name).index_buffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+    Texture_Array_Handle Vulkan_Engine::find_texture_array(const std::string& texture_array_name) const
+    {
+        Texture_Array_Handle handle = texture_arrays.find(texture_array_name);
 
-        //Bind the uniform buffers
-        //Bind set 0, the MVP buffer
-        vkCmdBindDescriptorSets(current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_sets.tri_descriptor_set[current_frame], 0, nullptr);
-        //Bind set 1, the texture
-        vkCmdBindDescriptorSets(current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 1, 1, &texture_descriptor_sets.at(texture_name), 0, nullptr);
+        if (!handle.is_valid())
+        {
+            std::cout << "No texture array with name " << texture_array_name << " is loaded, skipping draw call." << std::endl;
+        }
 
-        //Set the push constants (model matrix)
-        vkCmdPushConstants(current_command_buffer, pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &model_matrix);
+        return handle;
+    }
+
+    void Vulkan_Engine::start_draw()
+    {
+        VULVOX_PROFILE_SCOPE("Vulkan_Engine::start_draw");
 
-        //Bind to graphics pipeline: The shaders and configuration used to the render the object
-        vkCmdBindPipeline(current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vertex_pipeline);
+        recording_frame = false;
+
+        auto fence_wait_start = std::chrono::high_resolution_clock::now();
+
+        {
+            VULVOX_PROFILE_SCOPE("wait_for_frame_fence");
+            vkWaitForFences(vulkan_instance.device, 1, &in_flight_fences[current_frame], VK_TRUE, UINT64_MAX);
+        }
+
+        frame_statistics = Frame_Statistics{};
+        frame_statistics.frame_number = frame_count;
+        frame_statistics.fence_wait_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - fence_wait_start).count();
+        frame_statistics.frame_in_flight_index = current_frame;
+
+        //Recording of this frame overlaps the GPU work of the previous frame when its fence has not signaled yet
+        //With a single frame in flight the previous frame is this slot, whose fence was just waited on
+        uint32_t previous_frame = (current_frame + frames_in_flight - 1) % frames_in_flight;
+        frame_statistics.overlapped_previous_frame = vkGetFenceStatus(vulkan_instance.device, in_flight_fences[previous_frame]) == VK_NOT_READY;
+
+        //The previous use of this frame's resources is finished, so its readback buffer and queries can be read
+        deliver_frame_captures(current_frame);
+        gpu_profiler.resolve_frame(current_frame);
+
+        //Upload the async loads that finished parsing, before recording starts so they can be drawn this frame
+        process_async_loads(ASYNC_UPLOADS_PER_FRAME, false);
+
+        if (headless)
+        {
+            //Each frame in flight owns one offscreen image, its fence guarantees the previous use is finished
+            current_image_index = current_frame;
+        }
+        else
+        {
+            //Ask the swapchain for a render image to target
+            VkResult result = vkAcquireNextImageKHR(vulkan_instance.device, swap_chain.swap_chain, UINT64_MAX, image_available_semaphores[current_frame], nullptr, &current_image_index);
+
+            if (result == VK_ERROR_OUT_OF_DATE_KHR)
+            {
+                //Swap chain in not compatible with the current window size, recreate
+                recreate_swap_chain();
+                return;
+            }
+            else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+            {
+                throw std::runtime_error("Failed to acquire swap chain image!");
+            }
+        }
+
+        //Reset fence *after* confirming the swapchain is valid (prevents deadlock)
+        vkResetFences(vulkan_instance.device, 1, &in_flight_fences[current_frame]);
+
+        //Tell our memory allocator a new frame has started (useful for optimization)
+        //The 2nd argument is the current swapchain index (this is badly documented online)
+        vmaSetCurrentFrameIndex(vulkan_instance.allocator, current_frame);
+
+        //Reset the instance buffer of this frame, the GPU is done with it
+        buffer_manager.begin_frame(current_frame);
+
+        //Update global variables (camera etc.)
+        update_uniform_buffer();
+
+        //Cull against the same camera as the uniform buffer of this frame
+        std::array<glm::vec4, 6> frustum_planes = mvp_handler.get_frustum_planes();
+        instance_culler.begin_frame(current_frame, frustum_planes);
+        cpu_culler.begin_frame(frustum_planes);
+
+        //Start recording a new command buffer for rendering
+        current_command_buffer = command_pool.reset_command_buffer(current_frame);
+        command_pool.reset_worker_command_buffers(current_frame);
+
+        for (auto& context : recording_contexts)
+        {
+            context.begun = false;
+            context.statistics = Frame_Statistics{};
+        }
+
+        // Start recording the command buffer and wait for draw calls
+        start_record_command_buffer();
+        recording_frame = true;
+
+        if (imgui_context)
+        {
+            imgui_context->start_imgui_frame();
+        }
+
+    }
+
+    void Vulkan_Engine::end_draw()
+    {
+        VULVOX_PROFILE_SCOPE("Vulkan_Engine::end_draw");
+
+        //Record instances the caller forgot to close
+        end_instances();
+
+        //Record the queued draw_model calls of the render thread
+        flush_draw_queue(recording_contexts.front());
+
+        if (imgui_context)
+        {
+            if (gpu_profiler.is_enabled())
+            {
+                imgui_context->draw_gpu_timings(gpu_profiler.get_timings());
+            }
+
+            //With workers the user interface gets its own secondary command buffer, executed after all draws
+            VkCommandBuffer imgui_command_buffer = current_command_buffer;
+            if (recording_workers > 0)
+            {
+                begin_secondary_recording(recording_contexts.back(), static_cast<uint32_t>(recording_contexts.size()) - 1);
+                imgui_command_buffer = recording_contexts.back().command_buffer;
+            }
+
+            imgui_context->render_and_end_imgui_frame(imgui_command_buffer);
+        }
+
+        if (recording_workers > 0)
+        {
+            execute_secondary_command_buffers();
+        }
+
+        //Complete the command buffer before submitting it and presenting the image
+        end_record_command_buffer();
+
+        //Instance set uploads are recorded in a separate command buffer that executes before the render pass
+        std::array<VkCommandBuffer, 2> command_buffers = { VK_NULL_HANDLE, current_command_buffer };
+        uint32_t first_command_buffer = 1;
+
+        if (upload_commands_recorded)
+        {
+            //Make the copied and culled instances (and the indirect draw commands) visible to the draws
+            record_memory_barrier(current_upload_command_buffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+
+            if (vkEndCommandBuffer(current_upload_command_buffer) != VK_SUCCESS)
+            {
+                throw std::runtime_error("Failed to record upload command buffer!");
+            }
+
+            command_buffers[0] = current_upload_command_buffer;
+            first_command_buffer = 0;
+            upload_commands_recorded = false;
+        }
+
+        //Make the instance and staging data visible to the GPU before submitting
+        buffer_manager.end_frame();
+
+        VkSubmitInfo submit_info{};
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+
+        //Which semaphore to wait for before execution and at which stage
+        std::array<VkSemaphore, 1> wait_semaphores = { image_available_semaphores[current_frame] };
+        std::array<VkPipelineStageFlags, 1> wait_stages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+
+        //Which semaphore to signal when the command buffer is done
+        std::array<VkSemaphore, 1> signal_semaphores = { render_finished_semaphores[current_frame] };
+
+        //Headless frames are not acquired or presented, so there is nothing to wait for or signal
+        if (!headless)
+        {
+            submit_info.waitSemaphoreCount = static_cast<uint32_t>(wait_semaphores.size());
+            submit_info.pWaitSemaphores = wait_semaphores.data();
+            submit_info.pWaitDstStageMask = wait_stages.data();
+
+            submit_info.signalSemaphoreCount = static_cast<uint32_t>(signal_semaphores.size());
+            submit_info.pSignalSemaphores = signal_semaphores.data();
+        }
+
+        //Link command buffers
+        submit_info.commandBufferCount = static_cast<uint32_t>(command_buffers.size()) - first_command_buffer;
+        submit_info.pCommandBuffers = command_buffers.data() + first_command_buffer;
+
+        //Submit the command buffer so the GPU starts executing it
+        VULVOX_PROFILE_SCOPE("submit_and_present");
+        if (vkQueueSubmit(vulkan_instance.graphics_queue, 1, &submit_info, in_flight_fences[current_frame]) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to submit draw command buffer!");
+        }
+
+        recording_frame = false;
+
+        for (const auto& context : recording_contexts)
+        {
+            frame_statistics.draw_calls += context.statistics.draw_calls;
+            frame_statistics.instance_count += context.statistics.instance_count;
+            frame_statistics.cpu_culled_instances += context.statistics.cpu_culled_instances;
+        }
+
+        frame_statistics.instance_upload_bytes = buffer_manager.get_instance_upload_bytes();
+        last_frame_statistics = frame_statistics;
+
+        frame_count++;
+
+        if (headless)
+        {
+            //Rotate to next frame resources
+            current_frame = (current_frame + 1) % frames_in_flight;
+            return;
+        }
+
+        VkPresentInfoKHR present_info{};
+        present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+        present_info.waitSemaphoreCount = 1;
+        present_info.pWaitSemaphores = signal_semaphores.data(); //Wait for semaphore before we can present
+
+        std::array<VkSwapchainKHR, 1> swap_chains = { swap_chain.swap_chain };
+        present_info.swapchainCount = static_cast<uint32_t>(swap_chains.size());
+        present_info.pSwapchains = swap_chains.data();
+        present_info.pImageIndices = &current_image_index;
+
+        //Dont need to collect the draw results because the present function returns them as well
+        present_info.pResults = nullptr;
+
+        //Present the result on screen
+        VkResult result = vkQueuePresentKHR(vulkan_instance.present_queue, &present_info);
+
+        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || framebuffer_resized)
+        {
+            framebuffer_resized = false;
+
+            //Swap chain in not compatible with the current window size, recreate
+            recreate_swap_chain();
+        }
+        else if (result != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to present swap chain image!");
+        }
+
+        //Rotate to next frame resources
+        current_frame = (current_frame + 1) % frames_in_flight;
+    }
+
+    void Vulkan_Engine::draw_model(const std::string& model_name, const std::string& texture_name, const glm::mat4& model_matrix)
+    {
+        Model_Handle model = find_model(model_name);
+        Texture_Handle texture = find_texture(texture_name);
+
+        if (model.is_valid() && texture.is_valid())
+        {
+            draw_model(model, texture, model_matrix);
+        }
+    }
+
+    void Vulkan_Engine::draw_model(const Model_Handle model_handle, const Texture_Handle texture_handle, const glm::mat4& model_matrix)
+    {
+        const Model* model = models.get(model_handle);
+        const Texture* texture = textures.get(texture_handle);
+
+        if (model == nullptr || texture == nullptr)
+        {
+            std::cout << "Invalid model or texture handle, skipping draw call." << std::endl;
+            return;
+        }
+
+        //Only queue the draw, flush_draw_queue records all draws of this thread sorted by their state
+        Queued_Draw draw{};
+        draw.pipeline = vertex_pipeline;
+        draw.texture_descriptor_set = texture->descriptor_set;
+        draw.vertex_buffer = mesh_buffer.get_vertex_buffer(model->mesh.page);
+        draw.index_buffer = mesh_buffer.get_index_buffer(model->mesh.page);
+        draw.index_count = model->index_count;
+        draw.first_index = model->mesh.first_index;
+        draw.vertex_offset = model->mesh.vertex_offset;
+        draw.model_matrix = model_matrix;
+        draw.model = model_handle;
+        draw.texture = texture_handle;
+
+        get_recording_context().draw_queue.push_back(draw);
+    }
+
+    void Vulkan_Engine::draw_model_with_texture_array(const std::string& model_name, const std::string& texture_array_name, const int texture_index, const glm::mat4& model_matrix)
+    {
+        Model_Handle model = find_model(model_name);
+        Texture_Array_Handle texture_array = find_texture_array(texture_array_name);
+
+        if (model.is_valid() && texture_array.is_valid())
+        {
+            draw_model_with_texture_array(model, texture_array, texture_index, model_matrix);
+        }
+    }
+
+    void Vulkan_Engine::draw_model_with_texture_array(const Model_Handle model_handle, const Texture_Array_Handle texture_array_handle, const int texture_index, const glm::mat4& model_matrix)
+    {
+        Recording_Context& context = get_recording_context();
+        VkCommandBuffer command_buffer = context.command_buffer;
+
+        if (true)
+        {
+            std::cout << "draw_model_with_texture_array is not yet supported." << std::endl;
+            return;
+        }
+
+        const Model* model = models.get(model_handle);
+        const Texture* texture_array = texture_arrays.get(texture_array_handle);
+
+        if (model == nullptr || texture_array == nullptr)
+        {
+            std::cout << "Invalid model or texture array handle, skipping draw call." << std::endl;
+            return;
+        }
+
+        std::array<VkDeviceSize, 1> offsets = { 0 };
+
+        //Time the draw on the GPU (no-op when profiling is disabled)
+        uint32_t gpu_scope = gpu_profiler.begin_scope(command_buffer, "draw_model_with_texture_array", models.get_name(model_handle));
+
+        //Bind the uniform buffers
+        //Bind set 0, the MVP buffer
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_sets.tri_descriptor_set[current_frame], 0, nullptr);
+        //Bind set 1, the texture
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 1, 1, &texture_array->descriptor_set, 0, nullptr);
+
+        //Binding point 0 - mesh vertex buffer
+        VkBuffer vertex_buffer = mesh_buffer.get_vertex_buffer(model->mesh.page);
+        vkCmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffer, offsets.data());
+
+        ////Binding point 1 - instance data buffer
+        //vkCmdBindVertexBuffers(command_buffer, 1, 1, &instance_data_buffers[current_frame].buffer, offsets.data());
+
+        ////Binding point 2 - texture array index buffer
+        //vkCmdBindVertexBuffers(command_buffer, 2, 1, &instance_texture_index_buffers[current_frame].buffer, offsets.data());
+
+        //Set the push constants (model matrix)
+        vkCmdPushConstants(command_buffer, pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &model_matrix);
+
+        //Bind index buffer
+        vkCmdBindIndexBuffer(command_buffer, mesh_buffer.get_index_buffer(model->mesh.page), 0, VK_INDEX_TYPE_UINT32);
+
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vertex_pipeline);
+
+        //Draw command, set vertex and instance counts (we're not using instancing here) and indices
+        vkCmdDrawIndexed(command_buffer, model->index_count, 1, model->mesh.first_index, model->mesh.vertex_offset, 0);
+        gpu_profiler.end_scope(command_buffer, gpu_scope);
+        context.statistics.draw_calls++;
+        context.statistics.instance_count++;
+    }
+
+    void Vulkan_Engine::flush_draw_queue(Recording_Context& context)
+    {
+        if (context.draw_queue.empty())
+        {
+            return;
+        }
+
+        VULVOX_PROFILE_SCOPE("Vulkan_Engine::flush_draw_queue");
+
+        //Models share the vertex and index buffers of the mesh buffer, the first index tells them apart
+        auto draw_state = [](const Queued_Draw& draw) { return std::tie(draw.pipeline, draw.texture_descriptor_set, draw.vertex_buffer, draw.index_buffer, draw.first_index); };
+
+        //Group the draws by state, so the binds below only happen when the state actually changes
+        std::sort(context.draw_queue.begin(), context.draw_queue.end(), [&](const Queued_Draw& a, const Queued_Draw& b) { return draw_state(a) < draw_state(b); });
+
+        VkCommandBuffer command_buffer = context.command_buffer;
+
+        //State of the previous draw, nothing is bound yet
+        Queued_Draw bound{};
+        bool mvp_bound = false;
+
+        size_t first = 0;
+        while (first < context.draw_queue.size())
+        {
+            //Draws with the same state use the same model and texture
+            size_t last = first + 1;
+            while (last < context.draw_queue.size() && draw_state(context.draw_queue[last]) == draw_state(context.draw_queue[first]))
+            {
+                last++;
+            }
+
+            uint32_t draw_count = static_cast<uint32_t>(last - first);
+
+            if (auto_instancing && draw_count >= AUTO_INSTANCING_MIN_DRAWS)
+            {
+                //Gather the push constant matrices in the instance buffer and replace the draws by a single instanced draw
+                Buffer_Allocation model_matrices_buffer = buffer_manager.allocate_instance_data(static_cast<VkDeviceSize>(draw_count) * sizeof(glm::mat4));
+                glm::mat4* model_matrices = static_cast<glm::mat4*>(model_matrices_buffer.mapped_data);
+
+                for (size_t i = first; i < last; i++)
+                {
+                    *model_matrices++ = context.draw_queue[i].model_matrix;
+                }
+
+                record_instanced_draw(context.draw_queue[first].model, context.draw_queue[first].texture, model_matrices_buffer, draw_count, Instance_Format::MAT4);
+
+                //The instanced draw binds its own pipeline, sets and buffers
+                bound = Queued_Draw{};
+                mvp_bound = false;
+
+                first = last;
+                continue;
+            }
+
+            if (!mvp_bound)
+            {
+                //Bind set 0, the MVP buffer, shared by all queued draws
+                vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_sets.tri_descriptor_set[current_frame], 0, nullptr);
+                mvp_bound = true;
+            }
+
+            for (size_t i = first; i < last; i++)
+            {
+                const Queued_Draw& draw = context.draw_queue[i];
+
+                //Time the draw on the GPU (no-op when profiling is disabled)
+                uint32_t gpu_scope = gpu_profiler.begin_scope(command_buffer, "draw_model", models.get_name(draw.model));
+
+                //Bind to graphics pipeline: The shaders and configuration used to the render the object
+                if (draw.pipeline != bound.pipeline)
+                {
+                    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, draw.pipeline);
+                }
+
+                //Bind set 1, the texture
+                if (draw.texture_descriptor_set != bound.texture_descriptor_set)
+                {
+                    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 1, 1, &draw.texture_descriptor_set, 0, nullptr);
+                }
+
+                //Set the vertex buffers
+                if (draw.vertex_buffer != bound.vertex_buffer)
+                {
+                    std::array<VkDeviceSize, 1> offsets = { 0 };
+                    vkCmdBindVertexBuffers(command_buffer, 0, 1, &draw.vertex_buffer, offsets.data());
+                }
+
+                //Set the index buffers
+                if (draw.index_buffer != bound.index_buffer)
+                {
+                    vkCmdBindIndexBuffer(command_buffer, draw.index_buffer, 0, VK_INDEX_TYPE_UINT32);
+                }
+
+                //Set the push constants (model matrix)
+                vkCmdPushConstants(command_buffer, pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &draw.model_matrix);
+
+                //Draw command, set vertex and instance counts (we're not using instancing here) and indices
+                vkCmdDrawIndexed(command_buffer, draw.index_count, 1, draw.first_index, draw.vertex_offset, 0);
+                gpu_profiler.end_scope(command_buffer, gpu_scope);
+
+                bound = draw;
+            }
+
+            context.statistics.draw_calls += draw_count;
+            context.statistics.instance_count += draw_count;
+
+            first = last;
+        }
+
+        context.draw_queue.clear();
+    }
+
+    void Vulkan_Engine::draw_instanced(const std::string& model_name, const std::string& texture_name, const std::vector<glm::mat4>& model_matrices)
+    {
+        Model_Handle model = find_model(model_name);
+        Texture_Handle texture = find_texture(texture_name);
+
+        if (model.is_valid() && texture.is_valid())
+        {
+            draw_instanced(model, texture, model_matrices);
+        }
+    }
+
+    void Vulkan_Engine::draw_instanced(const Model_Handle model_handle, const Texture_Handle texture_handle, const std::vector<glm::mat4>& model_matrices)
+    {
+        const Model* model = models.get(model_handle);
+
+        if (model == nullptr || textures.get(texture_handle) == nullptr)
+        {
+            std::cout << "Invalid model or texture handle, skipping draw call." << std::endl;
+            return;
+        }
+
+        if (cpu_culler.is_enabled())
+        {
+            //Only the visible instances are written to the instance buffer
+            Buffer_Allocation model_matrices_buffer;
+            uint32_t visible_count = cpu_cull_instances(get_recording_context(), model->bounding_sphere, model_matrices, model_matrices_buffer);
+
+            if (visible_count > 0)
+            {
+                record_instanced_draw(model_handle, texture_handle, model_matrices_buffer, visible_count, Instance_Format::MAT4);
+            }
+            return;
+        }
+
+        Buffer_Allocation model_matrices_buffer = buffer_manager.copy_to_instance_buffer(model_matrices);
+
+        record_instanced_draw(model_handle, texture_handle, model_matrices_buffer, static_cast<uint32_t>(model_matrices.size()), Instance_Format::MAT4);
+    }
+
+    void Vulkan_Engine::draw_instanced(const std::string& model_name, const std::string& texture_name, const Instance_Format format, std::span<const std::byte> instance_data)
+    {
+        Model_Handle model = find_model(model_name);
+        Texture_Handle texture = find_texture(texture_name);
+
+        if (model.is_valid() && texture.is_valid())
+        {
+            draw_instanced(model, texture, format, instance_data);
+        }
+    }
+
+    void Vulkan_Engine::draw_instanced(const Model_Handle model_handle, const Texture_Handle texture_handle, const Instance_Format format, std::span<const std::byte> instance_data)
+    {
+        if (models.get(model_handle) == nullptr || textures.get(texture_handle) == nullptr)
+        {
+            std::cout << "Invalid model or texture handle, skipping draw call." << std::endl;
+            return;
+        }
+
+        if (!has_instance_pipeline(format))
+        {
+            return;
+        }
+
+        Buffer_Allocation instance_buffer = buffer_manager.allocate_instance_data(instance_data.size());
+        if (!instance_data.empty())
+        {
+            memcpy(instance_buffer.mapped_data, instance_data.data(), instance_data.size());
+        }
+
+        uint32_t instance_count = static_cast<uint32_t>(instance_data.size() / get_instance_format_size(format));
+
+        record_instanced_draw(model_handle, texture_handle, instance_buffer, instance_count, format);
+    }
+
+    std::span<std::byte> Vulkan_Engine::begin_instances(const std::string& model_name, const std::string& texture_name, const uint32_t instance_count, const Instance_Format format)
+    {
+        Model_Handle model = find_model(model_name);
+        Texture_Handle texture = find_texture(texture_name);
+
+        if (!model.is_valid() || !texture.is_valid())
+        {
+            return {};
+        }
+
+        return begin_instances(model, texture, instance_count, format);
+    }
+
+    std::span<std::byte> Vulkan_Engine::begin_instances(const Model_Handle model_handle, const Texture_Handle texture_handle, const uint32_t instance_count, const Instance_Format format)
+    {
+        Pending_Instances& pending_instances = get_recording_context().pending_instances;
+
+        if (pending_instances.active)
+        {
+            std::cout << "begin_instances called before end_instances, recording the previous instances first." << std::endl;
+            end_instances();
+        }
+
+        if (!has_instance_pipeline(format))
+        {
+            return {};
+        }
+
+        if (models.get(model_handle) == nullptr || textures.get(texture_handle) == nullptr)
+        {
+            std::cout << "Invalid model or texture handle, skipping draw call." << std::endl;
+            return {};
+        }
+
+        //Hand out the mapped range directly, the caller fills it in place of building a vector that we would copy
+        pending_instances.active = true;
+        pending_instances.model = model_handle;
+        pending_instances.texture = texture_handle;
+        pending_instances.instance_count = instance_count;
+        pending_instances.format = format;
+        pending_instances.allocation = buffer_manager.allocate_instance_data(static_cast<VkDeviceSize>(instance_count) * get_instance_format_size(format));
+
+        return std::span<std::byte>(static_cast<std::byte*>(pending_instances.allocation.mapped_data), pending_instances.allocation.size);
+    }
+
+    void Vulkan_Engine::end_instances()
+    {
+        Pending_Instances& pending_instances = get_recording_context().pending_instances;
+
+        if (!pending_instances.active)
+        {
+            return;
+        }
+        pending_instances.active = false;
+
+        record_instanced_draw(pending_instances.model, pending_instances.texture, pending_instances.allocation, pending_instances.instance_count, pending_instances.format);
+    }
+
+    Instance_Set_Handle Vulkan_Engine::create_instance_set(const std::string& model_name, const std::string& texture_name, const uint32_t initial_capacity)
+    {
+        if (!models.contains(model_name))
+        {
+            throw std::runtime_error("No model with name " + model_name + " is loaded, cannot create instance set!");
+        }
+
+        if (!textures.contains(texture_name))
+        {
+            throw std::runtime_error("No texture with name " + texture_name + " is loaded, cannot create instance set!");
+        }
+
+        return create_instance_set(models.find(model_name), textures.find(texture_name), initial_capacity);
+    }
+
+    Instance_Set_Handle Vulkan_Engine::create_instance_set(const Model_Handle model_handle, const Texture_Handle texture_handle, const uint32_t initial_capacity)
+    {
+        if (models.get(model_handle) == nullptr || textures.get(texture_handle) == nullptr)
+        {
+            throw std::runtime_error("Invalid model or texture handle, cannot create instance set!");
+        }
+
+        //Reuse the slot of a destroyed set, its generation was bumped so old handles stay invalid
+        uint32_t index;
+        if (!free_instance_sets.empty())
+        {
+            index = free_instance_sets.back();
+            free_instance_sets.pop_back();
+        }
+        else
+        {
+            index = static_cast<uint32_t>(instance_sets.size());
+            instance_sets.emplace_back();
+        }
+
+        Instance_Set& instance_set = instance_sets[index];
+        instance_set.in_use = true;
+        instance_set.model = model_handle;
+        instance_set.texture = texture_handle;
+        instance_set.instance_count = 0;
+
+        if (initial_capacity > 0)
+        {
+            instance_set.buffer.create(vulkan_instance, initial_capacity * sizeof(glm::mat4),
+                VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 0);
+            instance_set.capacity = initial_capacity;
+        }
+
+        return Instance_Set_Handle{ index, instance_set.generation };
+    }
+
+    void Vulkan_Engine::destroy_instance_set(const Instance_Set_Handle handle)
+    {
+        Instance_Set* instance_set = get_instance_set(handle);
+
+        if (instance_set == nullptr)
+        {
+            return;
+        }
+
+        //Frames in flight may still draw the set, destroy its buffer once they are finished
+        if (instance_set->buffer.buffer != VK_NULL_HANDLE)
+        {
+            buffer_manager.retire_buffer(get_retire_frame(), instance_set->buffer);
+        }
+
+        uint32_t generation = instance_set->generation + 1;
+        *instance_set = Instance_Set{};
+        instance_set->generation = generation;
+
+        free_instance_sets.push_back(handle.index);
+    }
+
+    void Vulkan_Engine::update_instances(const Instance_Set_Handle handle, const uint32_t first, std::span<const glm::mat4> model_matrices)
+    {
+        VULVOX_PROFILE_SCOPE("Vulkan_Engine::update_instances");
+
+        Instance_Set* instance_set = get_instance_set(handle);
+
+        if (instance_set == nullptr)
+        {
+            std::cout << "Invalid instance set handle, skipping instance update." << std::endl;
+            return;
+        }
+
+        if (model_matrices.empty())
+        {
+            return;
+        }
+
+        uint32_t last = first + static_cast<uint32_t>(model_matrices.size());
+
+        VkBufferCopy copy_region{};
+        copy_region.dstOffset = static_cast<VkDeviceSize>(first) * sizeof(glm::mat4);
+        copy_region.size = model_matrices.size_bytes();
+
+        if (recording_frame)
+        {
+            std::lock_guard<std::mutex> lock(upload_mutex);
+
+            //Only the dirty range goes through the staging ring, the copy executes before the draws of this frame
+            VkCommandBuffer command_buffer = get_upload_command_buffer();
+
+            if (last > instance_set->capacity)
+            {
+                grow_instance_set(command_buffer, *instance_set, last);
+            }
+            else if (instance_set->last_upload_frame == frame_count)
+            {
+                //Copies of the same frame may overlap, keep them in order
+                record_memory_barrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+            }
+
+            Buffer_Allocation staging_data = buffer_manager.allocate_staging_data(copy_region.size);
+            memcpy(staging_data.mapped_data, model_matrices.data(), copy_region.size);
+
+            copy_region.srcOffset = staging_data.offset;
+            vkCmdCopyBuffer(command_buffer, staging_data.buffer, instance_set->buffer.buffer, 1, &copy_region);
+
+            instance_set->last_upload_frame = frame_count;
+        }
+        else
+        {
+            //Outside of a frame there is nothing to record into, upload immediately like the model data
+            Buffer staging_buffer;
+            staging_buffer.create(vulkan_instance, copy_region.size,
+                VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+
+            memcpy(staging_buffer.allocation_info.pMappedData, model_matrices.data(), copy_region.size);
+
+            VkCommandBuffer command_buffer = command_pool.begin_single_time_commands();
+
+            //Submitted frames may still read the instances we overwrite
+            record_memory_barrier(command_buffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, VK_PIPELINE_STAGE_TRANSFER_BIT, 0);
+
+            if (last > instance_set->capacity)
+            {
+                grow_instance_set(command_buffer, *instance_set, last);
+            }
+
+            copy_region.srcOffset = 0;
+            vkCmdCopyBuffer(command_buffer, staging_buffer.buffer, instance_set->buffer.buffer, 1, &copy_region);
+
+            record_memory_barrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+
+            command_pool.release_staging_buffer(staging_buffer);
+            command_pool.end_single_time_commands();
+        }
+
+        instance_set->instance_count = std::max(instance_set->instance_count, last);
+    }
+
+    void Vulkan_Engine::draw_instance_set(const Instance_Set_Handle handle)
+    {
+        Instance_Set* instance_set = get_instance_set(handle);
+
+        if (instance_set == nullptr)
+        {
+            std::cout << "Invalid instance set handle, skipping draw call." << std::endl;
+            return;
+        }
+
+        if (instance_set->instance_count == 0)
+        {
+            return;
+        }
+
+        //The set keeps the handles, the assets may have been unloaded since
+        if (models.get(instance_set->model) == nullptr || textures.get(instance_set->texture) == nullptr)
+        {
+            std::cout << "The model or texture of the instance set was unloaded, skipping draw call." << std::endl;
+            return;
+        }
+
+        Buffer_Allocation model_matrices_buffer{};
+        model_matrices_buffer.buffer = instance_set->buffer.buffer;
+        model_matrices_buffer.size = instance_set->instance_count * sizeof(glm::mat4);
+
+        record_instanced_draw(instance_set->model, instance_set->texture, model_matrices_buffer, instance_set->instance_count, Instance_Format::MAT4);
+    }
+
+    Vulkan_Engine::Instance_Set* Vulkan_Engine::get_instance_set(const Instance_Set_Handle handle)
+    {
+        if (handle.index >= instance_sets.size())
+        {
+            return nullptr;
+        }
+
+        Instance_Set& instance_set = instance_sets[handle.index];
+
+        if (!instance_set.in_use || instance_set.generation != handle.generation)
+        {
+            return nullptr;
+        }
+
+        return &instance_set;
+    }
+
+    void Vulkan_Engine::grow_instance_set(VkCommandBuffer command_buffer, Instance_Set& instance_set, const uint32_t required_capacity)
+    {
+        VULVOX_PROFILE_SCOPE("Vulkan_Engine::grow_instance_set");
+
+        //Grow by at least 50% so appending instances one range at a time doesn't reallocate every frame
+        uint32_t new_capacity = std::max(required_capacity, instance_set.capacity + instance_set.capacity / 2);
+
+        Buffer new_buffer;
+        new_buffer.create(vulkan_instance, new_capacity * sizeof(glm::mat4),
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 0);
+
+        if (instance_set.buffer.buffer != VK_NULL_HANDLE)
+        {
+            if (instance_set.instance_count > 0)
+            {
+                //Move the existing instances on the GPU, the host doesn't keep a copy
+                VkBufferCopy copy_region{};
+                copy_region.size = instance_set.instance_count * sizeof(glm::mat4);
+                vkCmdCopyBuffer(command_buffer, instance_set.buffer.buffer, new_buffer.buffer, 1, &copy_region);
+
+                //The dirty range copy that follows may overlap the moved instances
+                record_memory_barrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+            }
+
+            buffer_manager.retire_buffer(get_retire_frame(), instance_set.buffer);
+        }
+
+        instance_set.buffer = new_buffer;
+        instance_set.capacity = new_capacity;
+    }
+
+    uint32_t Vulkan_Engine::get_retire_frame() const
+    {
+        //Outside of a frame the newest frame that could use a buffer is the last submitted one
+        return recording_frame ? current_frame : (current_frame + frames_in_flight - 1) % frames_in_flight;
+    }
+
+    VkCommandBuffer Vulkan_Engine::get_upload_command_buffer()
+    {
+        if (upload_commands_recorded)
+        {
+            return current_upload_command_buffer;
+        }
+
+        current_upload_command_buffer = upload_command_pool.reset_command_buffer(current_frame);
+
+        VkCommandBufferBeginInfo begin_info{};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        if (vkBeginCommandBuffer(current_upload_command_buffer, &begin_info) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to begin recording upload command buffer!");
+        }
+
+        //The previous frame may still read the instances we overwrite, only an execution dependency is needed
+        record_memory_barrier(current_upload_command_buffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, VK_PIPELINE_STAGE_TRANSFER_BIT, 0);
+
+        upload_commands_recorded = true;
+
+        return current_upload_command_buffer;
+    }
+
+    void Vulkan_Engine::record_memory_barrier(VkCommandBuffer command_buffer, VkPipelineStageFlags src_stage, VkAccessFlags src_access, VkPipelineStageFlags dst_stage, VkAccessFlags dst_access)
+    {
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = src_access;
+        barrier.dstAccessMask = dst_access;
+
+        vkCmdPipelineBarrier(command_buffer, src_stage, dst_stage, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    bool Vulkan_Engine::has_instance_pipeline(const Instance_Format format) const
+    {
+        return instance_pipelines[static_cast<size_t>(format)] != VK_NULL_HANDLE;
+    }
+
+    uint32_t Vulkan_Engine::cpu_cull_instances(Recording_Context& context, const glm::vec4& bounding_sphere, const std::vector<glm::mat4>& model_matrices, Buffer_Allocation& model_matrices_buffer)
+    {
+        Thread_Pool& pool = get_thread_pool();
+
+        uint32_t visible_count = cpu_culler.cull(pool, model_matrices, bounding_sphere, context.cull_result);
+        context.statistics.cpu_culled_instances += model_matrices.size() - visible_count;
+
+        if (visible_count == 0)
+        {
+            return 0;
+        }
+
+        model_matrices_buffer = buffer_manager.allocate_instance_data(visible_count * sizeof(glm::mat4));
+        cpu_culler.write_visible<glm::mat4>(pool, context.cull_result, model_matrices, static_cast<glm::mat4*>(model_matrices_buffer.mapped_data));
+
+        return visible_count;
+    }
+
+    Thread_Pool& Vulkan_Engine::get_thread_pool()
+    {
+        //Recording threads can start the pool at the same time
+        std::call_once(thread_pool_created, [this]() { thread_pool = std::make_unique<Thread_Pool>(); });
+
+        return *thread_pool;
+    }
+
+    Thread_Pool& Vulkan_Engine::get_loader_pool()
+    {
+        if (!loader_pool)
+        {
+            loader_pool = std::make_unique<Thread_Pool>(LOADER_THREAD_COUNT);
+        }
+
+        return *loader_pool;
+    }
+
+    bool Vulkan_Engine::cull_instances(const Model& model, const Buffer_Allocation& instances, const Buffer_Allocation* texture_indices, const uint32_t instance_count, Culled_Instances& culled_instances)
+    {
+        if (!instance_culler.is_enabled() || instance_count == 0)
+        {
+            return false;
+        }
+
+        VULVOX_PROFILE_SCOPE("Vulkan_Engine::cull_instances");
+
+        Culled_Instances output{};
+        output.instances = buffer_manager.allocate_device_data(static_cast<VkDeviceSize>(instance_count) * sizeof(glm::mat4));
+
+        if (texture_indices != nullptr)
+        {
+            output.texture_indices = buffer_manager.allocate_device_data(static_cast<VkDeviceSize>(instance_count) * sizeof(uint32_t));
+        }
+
+        //Start without visible instances, the culling shader counts them
+        VkDrawIndexedIndirectCommand draw_command{};
+        draw_command.indexCount = model.index_count;
+        draw_command.instanceCount = 0;
+        draw_command.firstIndex = model.mesh.first_index;
+        draw_command.vertexOffset = model.mesh.vertex_offset;
+
+        output.draw_command = buffer_manager.allocate_instance_data(sizeof(VkDrawIndexedIndirectCommand));
+        memcpy(output.draw_command.mapped_data, &draw_command, sizeof(draw_command));
+
+        //Workers share the upload command buffer and the descriptor sets of the culler
+        std::lock_guard<std::mutex> lock(upload_mutex);
+
+        VkCommandBuffer command_buffer = get_upload_command_buffer();
+
+        //Instance sets may have been updated earlier in the upload command buffer
+        record_memory_barrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+
+        if (!instance_culler.record_cull(command_buffer, model.bounding_sphere, instance_count,
+            instances, texture_indices, output.instances, texture_indices != nullptr ? &output.texture_indices : nullptr, output.draw_command))
+        {
+            return false;
+        }
+
+        culled_instances = output;
+        return true;
+    }
+
+    void Vulkan_Engine::record_instanced_draw(const Model_Handle model_handle, const Texture_Handle texture_handle, const Buffer_Allocation& model_matrices_buffer, const uint32_t instance_count, const Instance_Format format)
+    {
+        Recording_Context& context = get_recording_context();
+        VkCommandBuffer command_buffer = context.command_buffer;
+
+        std::array<VkDeviceSize, 1> offsets = { 0 };
+
+        const Model& model = *models.get(model_handle);
+
+        //Cull on the GPU, the draw then reads the visible instances and their count from the cull output
+        //The culling shader reads full matrices, compact formats are drawn unculled
+        Culled_Instances culled_instances{};
+        bool culled = format == Instance_Format::MAT4 && cull_instances(model, model_matrices_buffer, nullptr, instance_count, culled_instances);
+        const Buffer_Allocation& instance_buffer = culled ? culled_instances.instances : model_matrices_buffer;
+
+        //Time the draw on the GPU (no-op when profiling is disabled)
+        uint32_t gpu_scope = gpu_profiler.begin_scope(command_buffer, "draw_instanced", models.get_name(model_handle));
+
+        //Bind the uniform buffers
+        //Bind set 0, the MVP buffer
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_sets.instance_descriptor_set[current_frame], 0, nullptr);
+        //Bind set 1, the texture
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 1, 1, &textures.get(texture_handle)->descriptor_set, 0, nullptr);
+
+        //Binding point 0 - mesh vertex buffer
+        VkBuffer vertex_buffer = mesh_buffer.get_vertex_buffer(model.mesh.page);
+        vkCmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffer, offsets.data());
+
+        //Binding point 1 - instance data buffer
+        vkCmdBindVertexBuffers(command_buffer, 1, 1, &instance_buffer.buffer, &instance_buffer.offset);
+
+        //Bind index buffer
+        vkCmdBindIndexBuffer(command_buffer, mesh_buffer.get_index_buffer(model.mesh.page), 0, VK_INDEX_TYPE_UINT32);
+
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, instance_pipelines[static_cast<size_t>(format)]);
+
+        //Render instances
+        if (culled)
+        {
+            vkCmdDrawIndexedIndirect(command_buffer, culled_instances.draw_command.buffer, culled_instances.draw_command.offset, 1, sizeof(VkDrawIndexedIndirectCommand));
+        }
+        else
+        {
+            vkCmdDrawIndexed(command_buffer, model.index_count, instance_count, model.mesh.first_index, model.mesh.vertex_offset, 0);
+        }
+        gpu_profiler.end_scope(command_buffer, gpu_scope);
+        context.statistics.draw_calls++;
+        context.statistics.instance_count += instance_count;
+    }
+
+    void Vulkan_Engine::draw_instanced_with_texture_array(const std::string& model_name, const std::string& texture_array_name, const std::vector<glm::mat4>& model_matrices, const std::vector<uint32_t>& texture_indices)
+    {
+        Model_Handle model = find_model(model_name);
+        Texture_Array_Handle texture_array = find_texture_array(texture_array_name);
+
+        if (model.is_valid() && texture_array.is_valid())
+        {
+            draw_instanced_with_texture_array(model, texture_array, model_matrices, texture_indices);
+        }
+    }
+
+    void Vulkan_Engine::draw_instanced_with_texture_array(const Model_Handle model_handle, const Texture_Array_Handle texture_array_handle, const std::vector<glm::mat4>& model_matrices, const std::vector<uint32_t>& texture_indices)
+    {
+        Recording_Context& context = get_recording_context();
+        VkCommandBuffer command_buffer = context.command_buffer;
+
+        const Model* model = models.get(model_handle);
+        const Texture* texture_array = texture_arrays.get(texture_array_handle);
+
+        if (model == nullptr || texture_array == nullptr)
+        {
+            std::cout << "Invalid model or texture array handle, skipping draw call." << std::endl;
+            return;
+        }
+
+        //Every instance reads its texture index, culled or not
+        if (texture_indices.size() < model_matrices.size())
+        {
+            std::cout << "Fewer texture indices than model matrices, skipping draw call." << std::endl;
+            return;
+        }
+
+        std::array<VkDeviceSize, 1> offsets = { 0 };
+
+        Buffer_Allocation model_matrices_buffer;
+        Buffer_Allocation texture_index_buffer;
+        uint32_t instance_count = static_cast<uint32_t>(model_matrices.size());
+
+        if (cpu_culler.is_enabled())
+        {
+            //The texture indices of the visible instances are written in the same order as their matrices
+            instance_count = cpu_cull_instances(context, model->bounding_sphere, model_matrices, model_matrices_buffer);
+
+            if (instance_count == 0)
+            {
+                return;
+            }
+
+            texture_index_buffer = buffer_manager.allocate_instance_data(instance_count * sizeof(uint32_t));
+            cpu_culler.write_visible<uint32_t>(get_thread_pool(), context.cull_result, texture_indices, static_cast<uint32_t*>(texture_index_buffer.mapped_data));
+        }
+        else
+        {
+            model_matrices_buffer = buffer_manager.copy_to_instance_buffer(model_matrices);
+            texture_index_buffer = buffer_manager.copy_to_instance_buffer(texture_indices);
+        }
+
+        //Cull on the GPU, the texture indices are compacted together with the matrices
+        Culled_Instances culled_instances{};
+        if (cull_instances(*model, model_matrices_buffer, &texture_index_buffer, instance_count, culled_instances))
+        {
+            model_matrices_buffer = culled_instances.instances;
+            texture_index_buffer = culled_instances.texture_indices;
+        }
+
+        //Time the draw on the GPU (no-op when profiling is disabled)
+        uint32_t gpu_scope = gpu_profiler.begin_scope(command_buffer, "draw_instanced_with_texture_array", models.get_name(model_handle));
+
+        //Bind the uniform buffers
+        //Bind set 0, the MVP buffer
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_sets.instance_descriptor_set[current_frame], 0, nullptr);
+        //Bind set 1, the textures
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 1, 1, &texture_array->descriptor_set, 0, nullptr);
+
+        //Binding point 0 - mesh vertex buffer
+        VkBuffer vertex_buffer = mesh_buffer.get_vertex_buffer(model->mesh.page);
+        vkCmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffer, offsets.data());
+
+        //Binding point 1 - instance data buffer
+        vkCmdBindVertexBuffers(command_buffer, 1, 1, &model_matrices_buffer.buffer, &model_matrices_buffer.offset);
+
+        //Binding point 2 - texture array index buffer
+        vkCmdBindVertexBuffers(command_buffer, 2, 1, &texture_index_buffer.buffer, &texture_index_buffer.offset);
+
+        //Bind index buffer
+        vkCmdBindIndexBuffer(command_buffer, mesh_buffer.get_index_buffer(model->mesh.page), 0, VK_INDEX_TYPE_UINT32);
+
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, instance_tex_array_pipeline);
+
+        //Render instances
+        if (culled_instances.draw_command.buffer != VK_NULL_HANDLE)
+        {
+            vkCmdDrawIndexedIndirect(command_buffer, culled_instances.draw_command.buffer, culled_instances.draw_command.offset, 1, sizeof(VkDrawIndexedIndirectCommand));
+        }
+        else
+        {
+            vkCmdDrawIndexed(command_buffer, model->index_count, instance_count, model->mesh.first_index, model->mesh.vertex_offset, 0);
+        }
+        gpu_profiler.end_scope(command_buffer, gpu_scope);
+        context.statistics.draw_calls++;
+        context.statistics.instance_count += instance_count;
+    }
+
+    void Vulkan_Engine::draw_planes(const std::string& texture_array_name, const std::vector<glm::mat4>& model_matrices, const std::vector<uint32_t>& texture_indices, const std::vector<glm::vec4>& min_max_uvs)
+    {
+        Texture_Array_Handle texture_array = find_texture_array(texture_array_name);
+
+        if (texture_array.is_valid())
+        {
+            draw_planes(texture_array, model_matrices, texture_indices, min_max_uvs);
+        }
+    }
+
+    void Vulkan_Engine::draw_planes(const Texture_Array_Handle texture_array_handle, const std::vector<glm::mat4>& model_matrices, const std::vector<uint32_t>& texture_indices, const std::vector<glm::vec4>& min_max_uvs)
+    {
+        Recording_Context& context = get_recording_context();
+        VkCommandBuffer command_buffer = context.command_buffer;
+
+        const Texture* texture_array = texture_arrays.get(texture_array_handle);
+
+        if (texture_array == nullptr)
+        {
+            std::cout << "Invalid texture array handle, skipping draw call." << std::endl;
+            return;
+        }
+
+        //Every instance reads its texture index and uvs, culled or not
+        if (texture_indices.size() < model_matrices.size() || min_max_uvs.size() < model_matrices.size())
+        {
+            std::cout << "Fewer texture indices or uvs than model matrices, skipping draw call." << std::endl;
+            return;
+        }
+
+        Buffer_Allocation model_matrices_buffer;
+        Buffer_Allocation texture_index_buffer;
+        Buffer_Allocation min_max_uv_buffer;
+        uint32_t instance_count = static_cast<uint32_t>(model_matrices.size());
+
+        if (cpu_culler.is_enabled())
+        {
+            //Bounding sphere of the unit square in the xy plane that instance_plane.vert generates
+            const glm::vec4 plane_bounding_sphere(0.0f, 0.0f, 0.0f, std::sqrt(0.5f));
+
+            instance_count = cpu_cull_instances(context, plane_bounding_sphere, model_matrices, model_matrices_buffer);
+
+            if (instance_count == 0)
+            {
+                return;
+            }
+
+            texture_index_buffer = buffer_manager.allocate_instance_data(instance_count * sizeof(uint32_t));
+            min_max_uv_buffer = buffer_manager.allocate_instance_data(instance_count * sizeof(glm::vec4));
+            cpu_culler.write_visible<uint32_t>(get_thread_pool(), context.cull_result, texture_indices, static_cast<uint32_t*>(texture_index_buffer.mapped_data));
+            cpu_culler.write_visible<glm::vec4>(get_thread_pool(), context.cull_result, min_max_uvs, static_cast<glm::vec4*>(min_max_uv_buffer.mapped_data));
+        }
+        else
+        {
+            model_matrices_buffer = buffer_manager.copy_to_instance_buffer(model_matrices);
+            texture_index_buffer = buffer_manager.copy_to_instance_buffer(texture_indices);
+            min_max_uv_buffer = buffer_manager.copy_to_instance_buffer(min_max_uvs);
+        }
+
+        //Time the draw on the GPU (no-op when profiling is disabled)
+        uint32_t gpu_scope = gpu_profiler.begin_scope(command_buffer, "draw_planes", texture_arrays.get_name(texture_array_handle));
+
+        //Bind the uniform buffers
+        //Bind set 0, the MVP buffer
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_sets.instance_descriptor_set[current_frame], 0, nullptr);
+        //Bind set 1, the textures
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 1, 1, &texture_array->descriptor_set, 0, nullptr);
+
+        //Binding point 1 - instance data buffer
+        vkCmdBindVertexBuffers(command_buffer, 1, 1, &model_matrices_buffer.buffer, &model_matrices_buffer.offset);
+
+        //Binding point 2 - texture array index buffer
+        vkCmdBindVertexBuffers(command_buffer, 2, 1, &texture_index_buffer.buffer, &texture_index_buffer.offset);
+
+        //Binding point 3 - texture min max uvs
+        vkCmdBindVertexBuffers(command_buffer, 3, 1, &min_max_uv_buffer.buffer, &min_max_uv_buffer.offset);
+
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, instance_plane_pipeline);
+
+        //Render instances
+        vkCmdDraw(command_buffer, 6, instance_count, 0, 0);
+        gpu_profiler.end_scope(command_buffer, gpu_scope);
+        context.statistics.draw_calls++;
+        context.statistics.instance_count += instance_count;
+    }
+
+    void Vulkan_Engine::draw_batch(const std::string& texture_array_name, std::span<const Batch_Item> items)
+    {
+        Texture_Array_Handle texture_array = find_texture_array(texture_array_name);
+
+        if (texture_array.is_valid())
+        {
+            draw_batch(texture_array, items);
+        }
+    }
+
+    void Vulkan_Engine::draw_batch(const Texture_Array_Handle texture_array_handle, std::span<const Batch_Item> items)
+    {
+        const Texture* texture_array = texture_arrays.get(texture_array_handle);
+
+        if (texture_array == nullptr)
+        {
+            std::cout << "Invalid texture array handle, skipping draw call." << std::endl;
+            return;
+        }
+
+        record_batch(items, false, texture_array->descriptor_set, texture_arrays.get_name(texture_array_handle));
+    }
+
+    void Vulkan_Engine::draw_batch(std::span<const Batch_Item> items)
+    {
+        if (!has_bindless_textures())
+        {
+            std::cout << "Bindless textures are unavailable, skipping draw call." << std::endl;
+            return;
+        }
+
+        record_batch(items, true, bindless_table.get_descriptor_set(), "bindless");
+    }
+
+    void Vulkan_Engine::record_batch(std::span<const Batch_Item> items, const bool bindless, VkDescriptorSet texture_descriptor_set, const std::string& scope_name)
+    {
+        Recording_Context& context = get_recording_context();
+        VkCommandBuffer command_buffer = context.command_buffer;
+
+        VULVOX_PROFILE_SCOPE("Vulkan_Engine::draw_batch");
+
+        //Sort the items by mesh buffer page and model, every model then is one indirect command over a consecutive range of instances
+        //and every page one multi-draw indirect call
+        std::vector<std::tuple<uint32_t, uint32_t, uint32_t>>& batch_order = context.batch_order;
+        batch_order.clear();
+
+        for (uint32_t i = 0; i < items.size(); i++)
+        {
+            const Model* model = models.get(items[i].model);
+
+            //Bindless items select their texture by handle, the slot of the handle is the element in the texture table
+            if (model != nullptr && (!bindless || (textures.get(items[i].texture) != nullptr && bindless_table.contains_slot(items[i].texture.index))))
+            {
+                batch_order.emplace_back(model->mesh.page, items[i].model.index, i);
+            }
+        }
+
+        if (batch_order.size() != items.size())
+        {
+            std::cout << "Skipped " << items.size() - batch_order.size() << " batch items with an invalid model or texture handle." << std::endl;
+        }
+
+        if (batch_order.empty())
+        {
+            return;
+        }
+
+        std::sort(batch_order.begin(), batch_order.end());
+
+        uint32_t command_count = 1;
+        for (size_t i = 1; i < batch_order.size(); i++)
+        {
+            if (std::get<1>(batch_order[i]) != std::get<1>(batch_order[i - 1]))
+            {
+                command_count++;
+            }
+        }
+
+        uint32_t instance_count = static_cast<uint32_t>(batch_order.size());
+
+        Buffer_Allocation model_matrices_buffer = buffer_manager.allocate_instance_data(static_cast<VkDeviceSize>(instance_count) * sizeof(glm::mat4));
+        Buffer_Allocation texture_index_buffer = buffer_manager.allocate_instance_data(static_cast<VkDeviceSize>(instance_count) * sizeof(uint32_t));
+        Buffer_Allocation draw_commands_buffer = buffer_manager.allocate_instance_data(static_cast<VkDeviceSize>(command_count) * sizeof(VkDrawIndexedIndirectCommand));
+
+        glm::mat4* model_matrices = static_cast<glm::mat4*>(model_matrices_buffer.mapped_data);
+        uint32_t* texture_indices = static_cast<uint32_t*>(texture_index_buffer.mapped_data);
+        VkDrawIndexedIndirectCommand* draw_commands = static_cast<VkDrawIndexedIndirectCommand*>(draw_commands_buffer.mapped_data);
+
+        //Without multi-draw indirect every command is recorded as a direct draw, which still avoids the rebinds
+        bool multi_draw = vulkan_instance.supports_multi_draw_indirect();
+
+        //Time the draw on the GPU (no-op when profiling is disabled)
+        uint32_t gpu_scope = gpu_profiler.begin_scope(command_buffer, "draw_batch", scope_name);
+
+        VkPipelineLayout layout = bindless ? bindless_pipeline_layout : pipeline_layout;
+
+        //Bind the uniform buffers
+        //Bind set 0, the MVP buffer
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &descriptor_sets.instance_descriptor_set[current_frame], 0, nullptr);
+        //Bind set 1, the texture array or the bindless texture table
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 1, 1, &texture_descriptor_set, 0, nullptr);
+
+        //Binding point 1 - instance data buffer, the commands select their range with the first instance
+        vkCmdBindVertexBuffers(command_buffer, 1, 1, &model_matrices_buffer.buffer, &model_matrices_buffer.offset);
+
+        //Binding point 2 - texture array layer or texture table element
+        vkCmdBindVertexBuffers(command_buffer, 2, 1, &texture_index_buffer.buffer, &texture_index_buffer.offset);
+
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, bindless ? bindless_pipeline : instance_tex_array_pipeline);
+
+        uint32_t draw_calls = 0;
+        uint32_t written_commands = 0;
+        uint32_t page_first_command = 0;
+        uint32_t bound_page = UINT32_MAX;
+
+        //Issue the commands of the bound page in a single call
+        auto draw_page = [&]()
+            {
+                if (multi_draw && written_commands > page_first_command)
+                {
+                    VkDeviceSize offset = draw_commands_buffer.offset + static_cast<VkDeviceSize>(page_first_command) * sizeof(VkDrawIndexedIndirectCommand);
+                    vkCmdDrawIndexedIndirect(command_buffer, draw_commands_buffer.buffer, offset, written_commands - page_first_command, sizeof(VkDrawIndexedIndirectCommand));
+                    draw_calls++;
+                }
+
+                page_first_command = written_commands;
+            };
+
+        size_t first = 0;
+        while (first < batch_order.size())
+        {
+            auto [page, model_index, item_index] = batch_order[first];
+            const Model* model = models.get(items[item_index].model);
+
+            //Instances of the same model
+            size_t last = first;
+            while (last < batch_order.size() && std::get<1>(batch_order[last]) == model_index)
+            {
+                const Batch_Item& item = items[std::get<2>(batch_order[last])];
+                model_matrices[last] = item.model_matrix;
+                texture_indices[last] = bindless ? item.texture.index : item.texture_index;
+                last++;
+            }
+
+            if (page != bound_page)
+            {
+                draw_page();
+
+                std::array<VkDeviceSize, 1> offsets = { 0 };
+
+                //Binding point 0 - mesh vertex buffer, shared by all models in the page
+                VkBuffer vertex_buffer = mesh_buffer.get_vertex_buffer(page);
+                vkCmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffer, offsets.data());
+
+                //Bind index buffer
+                vkCmdBindIndexBuffer(command_buffer, mesh_buffer.get_index_buffer(page), 0, VK_INDEX_TYPE_UINT32);
+
+                bound_page = page;
+            }
+
+            VkDrawIndexedIndirectCommand draw_command{};
+            draw_command.indexCount = model->index_count;
+            draw_command.instanceCount = static_cast<uint32_t>(last - first);
+            draw_command.firstIndex = model->mesh.first_index;
+            draw_command.vertexOffset = model->mesh.vertex_offset;
+            draw_command.firstInstance = static_cast<uint32_t>(first);
+
+            if (multi_draw)
+            {
+                draw_commands[written_commands] = draw_command;
+            }
+            else
+            {
+                vkCmdDrawIndexed(command_buffer, draw_command.indexCount, draw_command.instanceCount, draw_command.firstIndex, draw_command.vertexOffset, draw_command.firstInstance);
+                draw_calls++;
+            }
+
+            written_commands++;
+            first = last;
+        }
+
+        draw_page();
+
+        gpu_profiler.end_scope(command_buffer, gpu_scope);
+        context.statistics.draw_calls += draw_calls;
+        context.statistics.instance_count += instance_count;
+    }
+
+    void Vulkan_Engine::request_frame_capture(Frame_Capture_Callback callback)
+    {
+        if (!callback)
+        {
+            return;
+        }
+
+        if (!headless && !swap_chain.supports_readback())
+        {
+            std::cout << "Swap chain images can not be copied on this device, frame capture request ignored." << std::endl;
+            return;
+        }
+
+        frame_capture_requests.push_back(callback);
+    }
+
+    void Vulkan_Engine::record_frame_capture()
+    {
+        if (frame_capture_requests.empty())
+        {
+            return;
+        }
+
+        VkFormat format = get_render_format();
+        VkExtent2D extent = get_render_extent();
+
+        Frame_Capture capture{};
+        capture.frame_number = frame_count;
+        capture.width = extent.width;
+        capture.height = extent.height;
+        capture.row_pitch = extent.width * 4;
+
+        switch (format)
+        {
+        case VK_FORMAT_B8G8R8A8_SRGB: capture.bgra = true; capture.srgb = true; break;
+        case VK_FORMAT_B8G8R8A8_UNORM: capture.bgra = true; break;
+        case VK_FORMAT_R8G8B8A8_SRGB: capture.srgb = true; break;
+        case VK_FORMAT_R8G8B8A8_UNORM: break;
+        default:
+            std::cout << "Frame capture of render format " << string_VkFormat(format) << " is not supported, skipping capture." << std::endl;
+            frame_capture_requests.clear();
+            return;
+        }
+
+        VkDeviceSize capture_size = static_cast<VkDeviceSize>(capture.row_pitch) * capture.height;
+        Buffer& readback_buffer = buffer_manager.get_readback_buffer(current_frame, capture_size);
+
+        //Swap chain images are left in the present layout by the render pass, offscreen images already are a transfer source
+        VkImageLayout final_layout = headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        VkImage image = get_render_image(current_image_index);
+
+        //Wait for the color writes of the render pass before copying
+        VkImageMemoryBarrier to_transfer_barrier{};
+        to_transfer_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        to_transfer_barrier.oldLayout = final_layout;
+        to_transfer_barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        to_transfer_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        to_transfer_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        to_transfer_barrier.image = image;
+        to_transfer_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        to_transfer_barrier.subresourceRange.baseMipLevel = 0;
+        to_transfer_barrier.subresourceRange.levelCount = 1;
+        to_transfer_barrier.subresourceRange.baseArrayLayer = 0;
+        to_transfer_barrier.subresourceRange.layerCount = 1;
+        to_transfer_barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        to_transfer_barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+        vkCmdPipelineBarrier(current_command_buffer,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &to_transfer_barrier);
+
+        //Row length and image height of zero means tightly packed
+        VkBufferImageCopy region{};
+        region.bufferOffset = 0;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = { 0, 0, 0 };
+        region.imageExtent = { extent.width, extent.height, 1 };
+
+        vkCmdCopyImageToBuffer(current_command_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readback_buffer.buffer, 1, &region);
+
+        //Make the copied data visible to the host once the fence signals
+        VkBufferMemoryBarrier host_read_barrier{};
+        host_read_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        host_read_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        host_read_barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        host_read_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        host_read_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        host_read_barrier.buffer = readback_buffer.buffer;
+        host_read_barrier.offset = 0;
+        host_read_barrier.size = capture_size;
+
+        //Return swap chain images to the present layout
+        VkImageMemoryBarrier to_present_barrier = to_transfer_barrier;
+        to_present_barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        to_present_barrier.newLayout = final_layout;
+        to_present_barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        to_present_barrier.dstAccessMask = 0;
+
+        vkCmdPipelineBarrier(current_command_buffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0, 0, nullptr, 1, &host_read_barrier, headless ? 0 : 1, &to_present_barrier);
+
+        Pending_Frame_Capture& pending_capture = pending_frame_captures[current_frame];
+        pending_capture.capture = capture;
+        pending_capture.callbacks = std::move(frame_capture_requests);
+        frame_capture_requests.clear();
+    }
+
+    void Vulkan_Engine::deliver_frame_captures(const uint32_t frame)
+    {
+        Pending_Frame_Capture& pending_capture = pending_frame_captures[frame];
+
+        if (pending_capture.callbacks.empty())
+        {
+            return;
+        }
+
+        Buffer& readback_buffer = buffer_manager.get_readback_buffer(frame);
+        VkDeviceSize capture_size = static_cast<VkDeviceSize>(pending_capture.capture.row_pitch) * pending_capture.capture.height;
+
+        //Memory might not be host coherent, make sure the GPU writes are visible
+        vmaInvalidateAllocation(vulkan_instance.allocator, readback_buffer.allocation, 0, capture_size);
+
+        Frame_Capture capture = pending_capture.capture;
+        capture.pixels = std::span<const uint8_t>(static_cast<const uint8_t*>(readback_buffer.allocation_info.pMappedData), capture_size);
+
+        //Move callbacks out first, a callback may request a new capture
+        std::vector<Frame_Capture_Callback> callbacks = std::move(pending_capture.callbacks);
+        pending_capture.callbacks.clear();
+
+        for (const auto& callback : callbacks)
+        {
+            callback(capture);
+        }
+    }
+
+    bool Vulkan_Engine::initialized() const
+    {
+        return is_initialized;
+    }
+
+    bool Vulkan_Engine::is_headless() const
+    {
+        return headless;
+    }
+
+    bool Vulkan_Engine::should_close() const
+    {
+        //Headless rendering has no window that can be closed, the caller decides when to stop
+        if (headless || window == nullptr)
+        {
+            return false;
+        }
+
+        return glfwWindowShouldClose(window);
+    }
+
+    Frame_Statistics Vulkan_Engine::get_frame_statistics() const
+    {
+        return last_frame_statistics;
+    }
 
-        //Draw command, set vertex and instance counts (we're not using instancing here) and indices
-        vkCmdDrawIndexed(current_command_buffer, models.at(model_name).index_count, 1, 0, 0, 0);
+    uint32_t Vulkan_Engine::get_frames_in_flight() const
+    {
+        return frames_in_flight;
     }
 
-    void Vulkan_Engine::draw_model_with_texture_array(const std::string& model_name, const std::string& texture_array_name, const int texture_index, const glm::mat4& model_matrix)
+    uint32_t Vulkan_Engine::get_current_frame_index() const
     {
-        if (true)
-        {
-            std::cout << "draw_model_with_texture_array is not yet supported." << std::endl;
-            return;
-        }
+        return current_frame;
+    }
 
-        if (!models.contains(model_name))
-        {
-            std::cout << "No model with name " << model_name << " is loaded, skipping draw call." << std::endl;
-            return;
-        }
+    void Vulkan_Engine::set_frames_in_flight(const uint32_t requested_frames_in_flight)
+    {
+        frames_in_flight = std::clamp(requested_frames_in_flight, 1u, MAX_FRAMES_IN_FLIGHT);
 
-        if (!texture_arrays.contains(texture_array_name))
+        if (frames_in_flight != requested_frames_in_flight)
         {
-            std::cout << "No texture array with name " << texture_array_name << " is loaded, skipping draw call." << std::endl;
-            return;
+            std::cout << "Unsupported amount of frames in flight " << requested_frames_in_flight << ", using " << frames_in_flight << " instead." << std::endl;
         }
 
-        std::array<VkDeviceSize, 1> offsets = { 0 };
+        current_frame = 0;
+    }
 
-        //Bind the uniform buffers
-        //Bind set 0, the MVP buffer
-        vkCmdBindDescriptorSets(current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_sets.tri_descriptor_set[current_frame], 0, nullptr);
-        //Bind set 1, the texture
-        vkCmdBindDescriptorSets(current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 1, 1, &texture_array_descriptor_sets.at(texture_array_name), 0, nullptr);
+    void Vulkan_Engine::set_gpu_profiling(const bool enable)
+    {
+        gpu_profiler.set_enabled(enable);
+    }
 
-        //Binding point 0 - mesh vertex buffer
-        vkCmdBindVertexBuffers(current_command_buffer, 0, 1, &models.at(model_name).vertex_buffer.buffer, offsets.data());
+    void Vulkan_Engine::set_gpu_culling(const bool enable)
+    {
+        instance_culler.set_enabled(enable);
+    }
 
-        ////Binding point 1 - instance data buffer
-        //vkCmdBindVertexBuffers(current_command_buffer, 1, 1, &instance_data_buffers[current_frame].buffer, offsets.data());
+    bool Vulkan_Engine::is_gpu_culling_enabled() const
+    {
+        return instance_culler.is_enabled();
+    }
 
-        ////Binding point 2 - texture array index buffer
-        //vkCmdBindVertexBuffers(current_command_buffer, 2, 1, &instance_texture_index_buffers[current_frame].buffer, offsets.data());
+    void Vulkan_Engine::set_cpu_culling(const bool enable)
+    {
+        cpu_culler.set_enabled(enable);
+    }
 
-        //Set the push constants (model matrix)
-        vkCmdPushConstants(current_command_buffer, pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &model_matrix);
+    bool Vulkan_Engine::is_cpu_culling_enabled() const
+    {
+        return cpu_culler.is_enabled();
+    }
 
-        //Bind index buffer
-        vkCmdBindIndexBuffer(current_command_buffer, models.at(model_name).index_buffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+    void Vulkan_Engine::set_auto_instancing(const bool enable)
+    {
+        auto_instancing = enable;
+    }
 
-        vkCmdBindPipeline(current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vertex_pipeline);
+    bool Vulkan_Engine::is_auto_instancing_enabled() const
+    {
+        return auto_instancing;
+    }
 
-        //Draw command, set vertex and instance counts (we're not using instancing here) and indices
-        vkCmdDrawIndexed(current_command_buffer, models.at(model_name).index_count, 1, 0, 0, 0);
+    bool Vulkan_Engine::has_bindless_textures() const
+    {
+        return bindless_pipeline != VK_NULL_HANDLE;
     }
 
-    void Vulkan_Engine::draw_instanced(const std::string& model_name, const std::string& texture_name, const std::vector<glm::mat4>& model_matrices)
+    void Vulkan_Engine::set_recording_workers(const uint32_t worker_count)
     {
-        if (!models.contains(model_name))
+        if (recording_frame)
         {
-            std::cout << "No model with name " << model_name << " is loaded, skipping draw call." << std::endl;
-            return;
+            throw std::runtime_error("The recording worker count can only be changed outside of a frame!");
         }
 
-        if (!textures.contains(texture_name))
+        if (worker_count == recording_workers)
         {
-            std::cout << "No texture with name " << texture_name << " is loaded, skipping draw call." << std::endl;
             return;
         }
 
-        std::array<VkDeviceSize, 1> offsets = { 0 };
-
-
-        size_t model_matrices_buffer = buffer_manager.copy_to_instance_buffer(vulkan_instance, current_frame, model_matrices);
-
-        //Bind the uniform buffers
-        //Bind set 0, the MVP buffer
-        vkCmdBindDescriptorSets(current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_sets.instance_descriptor_set[current_frame], 0, nullptr);
-        //Bind set 1, the texture
-        vkCmdBindDescriptorSets(current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 1, 1, &texture_descriptor_sets.at(texture_name), 0, nullptr);
-
-        //Binding point 0 - mesh vertex buffer
-        vkCmdBindVertexBuffers(current_command_buffer, 0, 1, &models.at(model_name).vertex_buffer.buffer, offsets.data());
+        //The worker pools of the frames in flight may still be executing
+        vkDeviceWaitIdle(vulkan_instance.device);
 
-        //Binding point 1 - instance data buffer
-        vkCmdBindVertexBuffers(current_command_buffer, 1, 1, &buffer_manager.get_instance_buffer(model_matrices_buffer).buffer, offsets.data());
+        //Besides the workers the render thread and the user interface get a secondary command buffer
+        uint32_t context_count = worker_count > 0 ? worker_count + 2 : 1;
 
-        //Bind index buffer
-        vkCmdBindIndexBuffer(current_command_buffer, models.at(model_name).index_buffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+        command_pool.create_worker_command_buffers(frames_in_flight, worker_count > 0 ? context_count : 0);
 
-        vkCmdBindPipeline(current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, instance_pipeline);
+        recording_contexts.clear();
+        recording_contexts.resize(context_count);
+        recording_workers = worker_count;
+    }
 
-        //Render instances
-        uint32_t instance_count = static_cast<uint32_t>(model_matrices.size());
-        vkCmdDrawIndexed(current_command_buffer, models.at(model_name).index_count, instance_count, 0, 0, 0);
+    uint32_t Vulkan_Engine::get_recording_workers() const
+    {
+        return recording_workers;
     }
 
-    void Vulkan_Engine::draw_instanced_with_texture_array(const std::string& model_name, const std::string& texture_array_name, const std::vector<glm::mat4>& model_matrices, const std::vector<uint32_t>& texture_indices)
+    void Vulkan_Engine::begin_worker_recording(const uint32_t worker)
     {
-        if (!models.contains(model_name))
+        if (!recording_frame)
         {
-            std::cout << "No model with name " << model_name << " is loaded, skipping draw call." << std::endl;
-            return;
+            throw std::runtime_error("begin_worker_recording has to be called between start_draw and end_draw!");
         }
 
-        if (!texture_arrays.contains(texture_array_name))
+        if (worker >= recording_workers)
         {
-            std::cout << "No texture array with name " << texture_array_name << " is loaded, skipping draw call." << std::endl;
-            return;
+            throw std::runtime_error("Worker " + std::to_string(worker) + " is out of range, only " + std::to_string(recording_workers) + " recording workers are set!");
         }
 
-        std::array<VkDeviceSize, 1> offsets = { 0 };
-
-        size_t model_matrices_buffer = buffer_manager.copy_to_instance_buffer(vulkan_instance, current_frame, model_matrices);
-        size_t texture_index_buffer = buffer_manager.copy_to_instance_buffer(vulkan_instance, current_frame, texture_indices);
-
-        //Bind the uniform buffers
-        //Bind set 0, the MVP buffer
-        vkCmdBindDescriptorSets(current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_sets.instance_descriptor_set[current_frame], 0, nullptr);
-        //Bind set 1, the textures
-        vkCmdBindDescriptorSets(current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 1, 1, &texture_array_descriptor_sets.at(texture_array_name), 0, nullptr);
-
-        //Binding point 0 - mesh vertex buffer
-        vkCmdBindVertexBuffers(current_command_buffer, 0, 1, &models.at(model_name).vertex_buffer.buffer, offsets.data());
-
-        //Binding point 1 - instance data buffer
-        vkCmdBindVertexBuffers(current_command_buffer, 1, 1, &buffer_manager.get_instance_buffer(model_matrices_buffer).buffer, offsets.data());
-
-        //Binding point 2 - texture array index buffer
-        vkCmdBindVertexBuffers(current_command_buffer, 2, 1, &buffer_manager.get_instance_buffer(texture_index_buffer).buffer, offsets.data());
+        Recording_Context& context = recording_contexts[worker + 1];
 
-        //Bind index buffer
-        vkCmdBindIndexBuffer(current_command_buffer, models.at(model_name).index_buffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+        if (context.bound)
+        {
+            throw std::runtime_error("Worker " + std::to_string(worker) + " is already recording on another thread!");
+        }
 
-        vkCmdBindPipeline(current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, instance_tex_array_pipeline);
+        //A worker can record multiple times per frame, the command buffer stays open until end_draw
+        if (!context.begun)
+        {
+            begin_secondary_recording(context, worker + 1);
+        }
 
-        //Render instances
-        uint32_t instance_count = static_cast<uint32_t>(model_matrices.size());
-        vkCmdDrawIndexed(current_command_buffer, models.at(model_name).index_count, instance_count, 0, 0, 0);
+        context.bound = true;
+        thread_recording_context = &context;
     }
 
-    void Vulkan_Engine::draw_planes(const std::string& texture_array_name, const std::vector<glm::mat4>& model_matrices, const std::vector<uint32_t>& texture_indices, const std::vector<glm::vec4>& min_max_uvs)
+    void Vulkan_Engine::end_worker_recording()
     {
-        if (!texture_arrays.contains(texture_array_name))
+        if (thread_recording_context == nullptr)
         {
-            std::cout << "No texture array with name " << texture_array_name << " is loaded, skipping draw call." << std::endl;
             return;
         }
 
-        size_t model_matrices_buffer = buffer_manager.copy_to_instance_buffer(vulkan_instance, current_frame, model_matrices);
-        size_t texture_index_buffer = buffer_manager.copy_to_instance_buffer(vulkan_instance, current_frame, texture_indices);
-        size_t min_max_uv_buffer = buffer_manager.copy_to_instance_buffer(vulkan_instance, current_frame, min_max_uvs);
-
-        std::array<VkDeviceSize, 1> offsets = { 0 };
-
-        //Bind the uniform buffers
-        //Bind set 0, the MVP buffer
-        vkCmdBindDescriptorSets(current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_sets.instance_descriptor_set[current_frame], 0, nullptr);
-        //Bind set 1, the textures
-        vkCmdBindDescriptorSets(current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 1, 1, &texture_array_descriptor_sets.at(texture_array_name), 0, nullptr);
-
-        //Binding point 1 - instance data buffer
-        vkCmdBindVertexBuffers(current_command_buffer, 1, 1, &buffer_manager.get_instance_buffer(model_matrices_buffer).buffer, offsets.data());
-
-        //Binding point 2 - texture array index buffer
-        vkCmdBindVertexBuffers(current_command_buffer, 2, 1, &buffer_manager.get_instance_buffer(texture_index_buffer).buffer, offsets.data());
+        //Record instances the worker forgot to close
+        end_instances();
 
-        //Binding point 3 - texture min max uvs
-        vkCmdBindVertexBuffers(current_command_buffer, 3, 1, &buffer_manager.get_instance_buffer(min_max_uv_buffer).buffer, offsets.data());
+        flush_draw_queue(*thread_recording_context);
 
-        vkCmdBindPipeline(current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, instance_plane_pipeline);
+        thread_recording_context->bound = false;
+        thread_recording_context = nullptr;
+    }
 
-        //Render instances
-        uint32_t instance_count = static_cast<uint32_t>(model_matrices.size());
-        vkCmdDraw(current_command_buffer, 6, instance_count, 0, 0);
+    Vulkan_Engine::Recording_Context& Vulkan_Engine::get_recording_context()
+    {
+        return thread_recording_context != nullptr ? *thread_recording_context : recording_contexts.front();
     }
 
-    bool Vulkan_Engine::initialized() const
+    GPU_Frame_Timings Vulkan_Engine::get_gpu_timings() const
     {
-        return is_initialized;
+        return gpu_profiler.get_timings();
     }
 
     std::string Vulkan_Engine::get_memory_statistics() const
@@ -626,10 +2456,66 @@ namespace vulvox
         //Destroy objects that depend on the swap chain
         depth_image.destroy();
 
+        if (headless)
+        {
+            offscreen_target.cleanup_targets();
+            return;
+        }
+
         //Destroy the swap chain
         swap_chain.cleanup_swap_chain();
     }
 
+    void Vulkan_Engine::recreate_offscreen_targets()
+    {
+        vkDeviceWaitIdle(vulkan_instance.device);
+
+        cleanup_swap_chain();
+
+        offscreen_target.create_targets(width, height, frames_in_flight);
+
+        mvp_handler.set_aspect_ratio(static_cast<float>(width) / static_cast<float>(height));
+
+        create_depth_resources(); //Depend on depth image
+        create_framebuffers(); //Depend on image views
+    }
+
+    VkExtent2D Vulkan_Engine::get_render_extent() const
+    {
+        return headless ? offscreen_target.extent : swap_chain.extent;
+    }
+
+    VkFormat Vulkan_Engine::get_render_format() const
+    {
+        return headless ? offscreen_target.image_format : swap_chain.image_format;
+    }
+
+    std::vector<VkImageView> Vulkan_Engine::get_render_image_views() const
+    {
+        if (!headless)
+        {
+            return swap_chain.image_views;
+        }
+
+        std::vector<VkImageView> image_views;
+        for (const auto& image : offscreen_target.images)
+        {
+            image_views.push_back(image.image_view);
+        }
+
+        return image_views;
+    }
+
+    std::vector<VkFramebuffer>& Vulkan_Engine::get_render_framebuffers()
+    {
+        return headless ? offscreen_target.framebuffers : swap_chain.framebuffers;
+    }
+
+    VkImage Vulkan_Engine::get_render_image(const uint32_t image_index) const
+    {
+        return headless ? offscreen_target.images[image_index].image : swap_chain.get_images()[image_index];
+    }
+
     void Vulkan_Engine::create_render_pass()
     {
         //The render pass describes the framebuffer attachments 
@@ -637,7 +2523,7 @@ namespace vulvox
         //and how their content should be handled
 
         VkAttachmentDescription color_attachment{};
-        color_attachment.format = swap_chain.image_format;
+        color_attachment.format = get_render_format();
         color_attachment.samples = VK_SAMPLE_COUNT_1_BIT; //No multisampling
         color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR; //Clear buffer before rendering
         color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE; //Store rendered content
@@ -646,9 +2532,9 @@ namespace vulvox
         color_attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         color_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 
-        //This buffer is used for presentation
+        //This buffer is used for presentation, or as a copy source when rendering headless
         color_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        color_attachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        color_attachment.finalLayout = headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
         //Index of fragment shader out_color
         VkAttachmentReference color_attachment_ref{};
@@ -762,15 +2648,15 @@ namespace vulvox
         VkViewport viewport{};
         viewport.x = 0.0f;
         viewport.y = 0.0f;
-        viewport.width = (float)swap_chain.extent.width;
-        viewport.height = (float)swap_chain.extent.height;
+        viewport.width = (float)get_render_extent().width;
+        viewport.height = (float)get_render_extent().height;
         viewport.minDepth = 0.0f;
         viewport.maxDepth = 1.0f;
 
         //Visible part of the viewport (whole viewport)
         VkRect2D scissor{};
         scissor.offset = { 0,0 };
-        scissor.extent = swap_chain.extent;
+        scissor.extent = get_render_extent();
 
         //It is usefull to have a non-static viewport and scissor size
         std::vector<VkDynamicState> dynamic_states =
@@ -937,7 +2823,7 @@ namespace vulvox
         vertex_input_state_info.vertexBindingDescriptionCount = 2;
         vertex_input_state_info.vertexAttributeDescriptionCount = 7;
 
-        if (vkCreateGraphicsPipelines(vulkan_instance.device, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &instance_pipeline) != VK_SUCCESS)
+        if (vkCreateGraphicsPipelines(vulkan_instance.device, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &instance_pipelines[static_cast<size_t>(Instance_Format::MAT4)]) != VK_SUCCESS)
         {
             throw std::runtime_error("Failed to create instance graphics pipeline!");
         }
@@ -1024,6 +2910,98 @@ namespace vulvox
         {
             throw std::runtime_error("Failed to create plane graphics pipeline!");
         }
+
+        ///Compact instance format pipelines
+        //Same state as the instance pipeline, only the instance layout and vertex shader differ
+        //The quaternion formats share a shader, the vertex fetch converts the half floats
+        const std::array<std::pair<Instance_Format, std::filesystem::path>, 3> compact_instance_shaders =
+        { {
+            { Instance_Format::AFFINE_3X4, "../shaders/instance_affine_vert.spv" },
+            { Instance_Format::QUAT_SCALE, "../shaders/instance_quat_vert.spv" },
+            { Instance_Format::HALF_QUAT_SCALE, "../shaders/instance_quat_vert.spv" },
+        } };
+
+        for (const auto& [format, shader_filepath] : compact_instance_shaders)
+        {
+            //Optional, draws using a format without pipeline are skipped
+            if (!std::filesystem::exists(shader_filepath))
+            {
+                std::cout << "Shader file " << shader_filepath.filename() << " not found, compact instance format " << static_cast<uint32_t>(format) << " is unavailable." << std::endl;
+                continue;
+            }
+
+            Vulkan_Shader compact_vert_shader{ vulkan_instance.device, shader_filepath, "main", VK_SHADER_STAGE_VERTEX_BIT };
+
+            shader_stages_info[0] = compact_vert_shader.get_shader_stage_create_info();
+            shader_stages_info[1] = instance_frag_shader_stage_info;
+
+            std::array<VkVertexInputBindingDescription, 2> compact_binding_descriptions =
+            {
+                Vertex::get_binding_description(0),
+                Instance_Data::get_binding_description(1, format)
+            };
+
+            std::vector<VkVertexInputAttributeDescription> compact_attribute_descriptions = Vertex::get_attribute_descriptions(0);
+
+            for (const auto& attribute_desc : Instance_Data::get_attribute_descriptions(1, format))
+            {
+                compact_attribute_descriptions.push_back(attribute_desc);
+            }
+
+            vertex_input_state_info.pVertexBindingDescriptions = compact_binding_descriptions.data();
+            vertex_input_state_info.pVertexAttributeDescriptions = compact_attribute_descriptions.data();
+            vertex_input_state_info.vertexBindingDescriptionCount = static_cast<uint32_t>(compact_binding_descriptions.size());
+            vertex_input_state_info.vertexAttributeDescriptionCount = static_cast<uint32_t>(compact_attribute_descriptions.size());
+
+            if (vkCreateGraphicsPipelines(vulkan_instance.device, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &instance_pipelines[static_cast<size_t>(format)]) != VK_SUCCESS)
+            {
+                throw std::runtime_error("Failed to create compact instance graphics pipeline!");
+            }
+        }
+
+        ///Bindless pipeline
+        //Same instance layout as the texture array pipeline, the per-instance index selects an element of the bindless texture table
+        std::filesystem::path instance_bindless_vert_shader_filepath("../shaders/instance_bindless_vert.spv");
+        std::filesystem::path instance_bindless_frag_shader_filepath("../shaders/instance_bindless_frag.spv");
+
+        if (!bindless_table.is_available())
+        {
+            return;
+        }
+
+        //Optional, draw_batch without a texture array is skipped without this pipeline
+        if (!std::filesystem::exists(instance_bindless_vert_shader_filepath) || !std::filesystem::exists(instance_bindless_frag_shader_filepath))
+        {
+            std::cout << "Bindless shader files not found, bindless textures are unavailable." << std::endl;
+            return;
+        }
+
+        //Set 1 is the texture table instead of a single texture, set 0 and the push constants are compatible with the other pipelines
+        std::array<VkDescriptorSetLayout, 2> bindless_set_layouts = { mvp_descriptor_set_layout, bindless_table.get_layout() };
+        pipeline_layout_info.pSetLayouts = bindless_set_layouts.data();
+
+        if (vkCreatePipelineLayout(vulkan_instance.device, &pipeline_layout_info, nullptr, &bindless_pipeline_layout) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create bindless pipeline layout!");
+        }
+
+        Vulkan_Shader instance_bindless_vert_shader{ vulkan_instance.device, instance_bindless_vert_shader_filepath, "main", VK_SHADER_STAGE_VERTEX_BIT };
+        Vulkan_Shader instance_bindless_frag_shader{ vulkan_instance.device, instance_bindless_frag_shader_filepath, "main", VK_SHADER_STAGE_FRAGMENT_BIT };
+
+        shader_stages_info[0] = instance_bindless_vert_shader.get_shader_stage_create_info();
+        shader_stages_info[1] = instance_bindless_frag_shader.get_shader_stage_create_info();
+
+        vertex_input_state_info.pVertexBindingDescriptions = binding_descriptions.data();
+        vertex_input_state_info.pVertexAttributeDescriptions = attribute_descriptions.data();
+        vertex_input_state_info.vertexBindingDescriptionCount = static_cast<uint32_t>(binding_descriptions.size());
+        vertex_input_state_info.vertexAttributeDescriptionCount = static_cast<uint32_t>(attribute_descriptions.size());
+
+        pipeline_info.layout = bindless_pipeline_layout;
+
+        if (vkCreateGraphicsPipelines(vulkan_instance.device, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &bindless_pipeline) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create bindless graphics pipeline!");
+        }
     }
 
     /// <summary>
@@ -1032,23 +3010,27 @@ namespace vulvox
     /// </summary>
     void Vulkan_Engine::create_framebuffers()
     {
-        swap_chain.framebuffers.resize(swap_chain.image_views.size());
+        std::vector<VkImageView> image_views = get_render_image_views();
+        std::vector<VkFramebuffer>& framebuffers = get_render_framebuffers();
+        VkExtent2D render_extent = get_render_extent();
+
+        framebuffers.resize(image_views.size());
 
-        for (size_t i = 0; i < swap_chain.image_views.size(); i++)
+        for (size_t i = 0; i < image_views.size(); i++)
         {
             //The swap chain uses multiple images, the render pipeline uses a single depth buffer (protected by semaphores)
-            std::array<VkImageView, 2> attachments = { swap_chain.image_views[i], depth_image.image_view };
+            std::array<VkImageView, 2> attachments = { image_views[i], depth_image.image_view };
 
             VkFramebufferCreateInfo framebuffer_info{};
             framebuffer_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
             framebuffer_info.renderPass = render_pass;
             framebuffer_info.attachmentCount = static_cast<uint32_t>(attachments.size());
             framebuffer_info.pAttachments = attachments.data();
-            framebuffer_info.width = swap_chain.extent.width;
-            framebuffer_info.height = swap_chain.extent.height;
+            framebuffer_info.width = render_extent.width;
+            framebuffer_info.height = render_extent.height;
             framebuffer_info.layers = 1; //Only single layer images in the swap chain
 
-            if (vkCreateFramebuffer(vulkan_instance.device, &framebuffer_info, nullptr, &swap_chain.framebuffers[i]) != VK_SUCCESS)
+            if (vkCreateFramebuffer(vulkan_instance.device, &framebuffer_info, nullptr, &framebuffers[i]) != VK_SUCCESS)
             {
                 throw std::runtime_error("Failed to create framebuffer!");
             }
@@ -1061,7 +3043,7 @@ namespace vulvox
 
         depth_image.create_image(
             &vulkan_instance,
-            swap_chain.extent.width, swap_chain.extent.height,
+            get_render_extent().width, get_render_extent().height,
             depth_format,
             VK_IMAGE_TILING_OPTIMAL,
             VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
@@ -1072,32 +3054,18 @@ namespace vulvox
     }
 
     /// <summary>
-    /// This function creates a descriptor pool that holds the descriptor sets.
-    /// Because this renderers usecase will not involve a lot of models we just create a single large pool.
+    /// Sets up the descriptor allocator that holds the descriptor sets.
+    /// The first pool fits the MVP sets and a moderate amount of textures, more pools are added when textures keep being loaded.
     /// </summary>
     void Vulkan_Engine::create_descriptor_pool()
     {
-        std::array<VkDescriptorPoolSize, 2> pool_sizes{};
-
-        pool_sizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        pool_sizes[0].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT) * 2;
-
-        //Limits for a common GPU are >1mil, for our use we probably wont exceed 512 textures 
-        //(if we do we could consider making a manager class in the future)
-        pool_sizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        pool_sizes[1].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT) * 512;
+        //Every set holds a single uniform buffer (MVP) or a single image sampler (textures),
+        //reserving one of each per set means a pool never runs out of a type before it runs out of sets
+        std::array<Vulkan_Descriptor_Allocator::Pool_Size_Ratio, 2> pool_size_ratios{ {
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1.0f },
+            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1.0f } } };
 
-        VkDescriptorPoolCreateInfo pool_info{};
-        pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        pool_info.poolSizeCount = static_cast<uint32_t>(pool_sizes.size());
-        pool_info.pPoolSizes = pool_sizes.data();
-        pool_info.maxSets = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT) + 510; // Just allocate a bunch so we can load multiple models, can make dynamic later.
-        pool_info.flags = 0;
-
-        if (vkCreateDescriptorPool(vulkan_instance.device, &pool_info, nullptr, &descriptor_pool) != VK_SUCCESS)
-        {
-            throw std::runtime_error("Failed to create descriptor pool!");
-        }
+        descriptor_allocator.init(&vulkan_instance, frames_in_flight * 2 + 512, pool_size_ratios);
     }
 
     /// <summary>
@@ -1156,24 +3124,15 @@ namespace vulvox
     /// </summary>
     void Vulkan_Engine::create_descriptor_sets()
     {
-        std::vector<VkDescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, mvp_descriptor_set_layout);
-
-        VkDescriptorSetAllocateInfo allocate_info{};
-        allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocate_info.descriptorPool = descriptor_pool;
-        allocate_info.descriptorSetCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
-        allocate_info.pSetLayouts = layouts.data(); //mvp uniform layout
-
         ///Triangle descriptor sets
-        descriptor_sets.tri_descriptor_set.resize(MAX_FRAMES_IN_FLIGHT);
+        descriptor_sets.tri_descriptor_set.resize(frames_in_flight);
 
-        if (VkResult result = vkAllocateDescriptorSets(vulkan_instance.device, &allocate_info, descriptor_sets.tri_descriptor_set.data()); result != VK_SUCCESS)
+        for (auto& descriptor_set : descriptor_sets.tri_descriptor_set)
         {
-            std::string error_string{ string_VkResult(result) };
-            throw std::runtime_error("Failed to allocate descriptor sets! " + error_string);
+            descriptor_set = descriptor_allocator.allocate(mvp_descriptor_set_layout);
         }
 
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+        for (size_t i = 0; i < frames_in_flight; i++)
         {
             VkDescriptorBufferInfo buffer_info{};
             buffer_info.buffer = buffer_manager.get_uniform_buffer(i).buffer;
@@ -1199,16 +3158,15 @@ namespace vulvox
         }
 
         ///Instance descriptor sets
-        descriptor_sets.instance_descriptor_set.resize(MAX_FRAMES_IN_FLIGHT);
+        descriptor_sets.instance_descriptor_set.resize(frames_in_flight);
 
-        if (VkResult result = vkAllocateDescriptorSets(vulkan_instance.device, &allocate_info, descriptor_sets.instance_descriptor_set.data()); result != VK_SUCCESS)
+        for (auto& descriptor_set : descriptor_sets.instance_descriptor_set)
         {
-            std::string error_string{ string_VkResult(result) };
-            throw std::runtime_error("Failed to allocate descriptor sets! " + error_string);
+            descriptor_set = descriptor_allocator.allocate(mvp_descriptor_set_layout);
         }
 
         //TODO: Do we need this or can we just use the above one for all shaders?
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+        for (size_t i = 0; i < frames_in_flight; i++)
         {
             VkDescriptorBufferInfo buffer_info{};
             buffer_info.buffer = buffer_manager.get_uniform_buffer(i).buffer;
@@ -1239,20 +3197,8 @@ namespace vulvox
     /// <param name="texture_name">Name of the texture to create a descriptor for</param>
     VkDescriptorSet Vulkan_Engine::create_texture_descriptor_set(const Image& texture)
     {
-        VkDescriptorSet new_descriptor_set{};
-
-        VkDescriptorSetAllocateInfo allocate_info{};
-        allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocate_info.descriptorPool = descriptor_pool;
-        allocate_info.descriptorSetCount = 1;
-        allocate_info.pSetLayouts = &texture_descriptor_set_layout; //texture uniform layout
-
-        ///Triangle descriptor sets
-        descriptor_sets.tri_descriptor_set.resize(MAX_FRAMES_IN_FLIGHT);
-        if (vkAllocateDescriptorSets(vulkan_instance.device, &allocate_info, &new_descriptor_set) != VK_SUCCESS)
-        {
-            throw std::runtime_error("Failed to allocate descriptor sets!");
-        }
+        //Grows the pools when needed, a recycled set is overwritten below
+        VkDescriptorSet new_descriptor_set = descriptor_allocator.allocate(texture_descriptor_set_layout); //texture uniform layout
 
         VkDescriptorImageInfo image_info{};
         image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
@@ -1279,9 +3225,9 @@ namespace vulvox
 
     void Vulkan_Engine::create_sync_objects()
     {
-        image_available_semaphores.resize(MAX_FRAMES_IN_FLIGHT);
-        render_finished_semaphores.resize(MAX_FRAMES_IN_FLIGHT);
-        in_flight_fences.resize(MAX_FRAMES_IN_FLIGHT);
+        image_available_semaphores.resize(frames_in_flight);
+        render_finished_semaphores.resize(frames_in_flight);
+        in_flight_fences.resize(frames_in_flight);
 
         VkSemaphoreCreateInfo semaphore_info{};
         semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -1290,7 +3236,7 @@ namespace vulvox
         fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
         fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT; //Start in signaled state for first frame
 
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+        for (size_t i = 0; i < frames_in_flight; i++)
         {
             if (vkCreateSemaphore(vulkan_instance.device, &semaphore_info, nullptr, &image_available_semaphores[i]) != VK_SUCCESS ||
                 vkCreateSemaphore(vulkan_instance.device, &semaphore_info, nullptr, &render_finished_semaphores[i]) != VK_SUCCESS ||
@@ -1309,11 +3255,11 @@ namespace vulvox
 
         //attach this render pass to the swap chain image
         render_pass_begin_info.renderPass = render_pass;
-        render_pass_begin_info.framebuffer = swap_chain.framebuffers[current_image_index];
+        render_pass_begin_info.framebuffer = get_render_framebuffers()[current_image_index];
 
         //Cover the whole swap chain image
         render_pass_begin_info.renderArea.offset = { 0,0 };
-        render_pass_begin_info.renderArea.extent = swap_chain.extent;
+        render_pass_begin_info.renderArea.extent = get_render_extent();
 
         //Clear to black (we use VK_ATTACHMENT_LOAD_OP_CLEAR)
         //Clear order should be same as attachment order
@@ -1323,19 +3269,6 @@ namespace vulvox
         render_pass_begin_info.clearValueCount = static_cast<uint32_t>(clear_colors.size());
         render_pass_begin_info.pClearValues = clear_colors.data();
 
-        //We set viewport and scissor to dynamic earlier, so we define them now
-        VkViewport viewport{};
-        viewport.x = 0.0f;
-        viewport.y = 0.0f;
-        viewport.width = static_cast<float>(swap_chain.extent.width);
-        viewport.height = static_cast<float>(swap_chain.extent.height);
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-
-        VkRect2D scissor{};
-        scissor.offset = { 0,0 };
-        scissor.extent = swap_chain.extent;
-
         //Start recording a command buffer
         VkCommandBufferBeginInfo begin_info{};
         begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -1347,19 +3280,109 @@ namespace vulvox
             throw std::runtime_error("Failed to begin recording command buffer!");
         }
 
+        //Resets this frame's queries and starts timing the render pass
+        gpu_profiler.begin_frame(current_command_buffer, current_frame, frame_count);
+
+        if (recording_workers == 0)
+        {
+            //VK_SUBPASS_CONTENTS_INLINE means we don't use secondary command buffers
+            vkCmdBeginRenderPass(current_command_buffer, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+
+            record_viewport_and_scissor(current_command_buffer);
+
+            recording_contexts.front().command_buffer = current_command_buffer;
+            return;
+        }
+
+        //The render pass only executes secondary command buffers, the render thread records into the first one
+        vkCmdBeginRenderPass(current_command_buffer, &render_pass_begin_info, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+        begin_secondary_recording(recording_contexts.front(), 0);
+    }
+
+    void Vulkan_Engine::begin_secondary_recording(Recording_Context& context, const uint32_t worker_slot)
+    {
+        context.command_buffer = command_pool.get_worker_command_buffer(current_frame, worker_slot);
+
+        //Secondary command buffers that continue a render pass have to know the render pass and framebuffer
+        VkCommandBufferInheritanceInfo inheritance_info{};
+        inheritance_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritance_info.renderPass = render_pass;
+        inheritance_info.subpass = 0;
+        inheritance_info.framebuffer = get_render_framebuffers()[current_image_index];
+
+        VkCommandBufferBeginInfo begin_info{};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        begin_info.pInheritanceInfo = &inheritance_info;
+
+        if (vkBeginCommandBuffer(context.command_buffer, &begin_info) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to begin recording secondary command buffer!");
+        }
+
+        //Dynamic state is not inherited from the primary command buffer
+        record_viewport_and_scissor(context.command_buffer);
+
+        context.begun = true;
+    }
+
+    void Vulkan_Engine::execute_secondary_command_buffers()
+    {
+        std::vector<VkCommandBuffer> secondary_command_buffers;
+        secondary_command_buffers.reserve(recording_contexts.size());
+
+        for (auto& context : recording_contexts)
+        {
+            if (context.bound)
+            {
+                throw std::runtime_error("end_draw called while a worker is still recording, call end_worker_recording first!");
+            }
+
+            if (!context.begun)
+            {
+                continue;
+            }
+
+            if (vkEndCommandBuffer(context.command_buffer) != VK_SUCCESS)
+            {
+                throw std::runtime_error("Failed to record secondary command buffer!");
+            }
+
+            secondary_command_buffers.push_back(context.command_buffer);
+        }
+
+        vkCmdExecuteCommands(current_command_buffer, static_cast<uint32_t>(secondary_command_buffers.size()), secondary_command_buffers.data());
+    }
 
-        //VK_SUBPASS_CONTENTS_INLINE means we don't use secondary command buffers
-        vkCmdBeginRenderPass(current_command_buffer, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+    void Vulkan_Engine::record_viewport_and_scissor(VkCommandBuffer command_buffer) const
+    {
+        //We set viewport and scissor to dynamic earlier, so we define them now
+        VkViewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = static_cast<float>(get_render_extent().width);
+        viewport.height = static_cast<float>(get_render_extent().height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
 
+        VkRect2D scissor{};
+        scissor.offset = { 0,0 };
+        scissor.extent = get_render_extent();
 
-        vkCmdSetViewport(current_command_buffer, 0, 1, &viewport);
-        vkCmdSetScissor(current_command_buffer, 0, 1, &scissor);
+        vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+        vkCmdSetScissor(command_buffer, 0, 1, &scissor);
     }
 
     void Vulkan_Engine::end_record_command_buffer()
     {
         vkCmdEndRenderPass(current_command_buffer);
 
+        gpu_profiler.end_frame(current_command_buffer);
+
+        //Copy the finished image to the readback buffer before closing the command buffer
+        record_frame_capture();
+
         if (vkEndCommandBuffer(current_command_buffer) != VK_SUCCESS)
         {
             throw std::runtime_error("Failed to record command buffer!");
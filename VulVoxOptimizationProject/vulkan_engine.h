@@ -11,7 +11,17 @@ namespace vulvox
         void init_window(uint32_t width, uint32_t height);
         void init_vulkan();
 
-        void init(uint32_t width, uint32_t height);
+        /// <summary>
+        /// requested_frames_in_flight (1 to MAX_FRAMES_IN_FLIGHT) is the amount of frames the CPU can record ahead of the GPU,
+        /// every frame in flight has its own command buffers, instance buffers, descriptor sets and fence.
+        /// </summary>
+        void init(uint32_t width, uint32_t height, const uint32_t requested_frames_in_flight = DEFAULT_FRAMES_IN_FLIGHT);
+
+        /// <summary>
+        /// Initializes the engine without a window, surface or swap chain.
+        /// Frames are rendered into a ring of offscreen images and are never presented.
+        /// </summary>
+        void init_headless(uint32_t width, uint32_t height, const uint32_t requested_frames_in_flight = DEFAULT_FRAMES_IN_FLIGHT);
 
         void init_imgui();
         void disable_imgui();
@@ -24,28 +34,139 @@ namespace vulvox
 
         void resize_window(const uint32_t new_width, const uint32_t new_height);
 
-        void load_model(const std::string& model_name, const std::filesystem::path& path);
-        void load_texture(const std::string& texture_name, const std::filesystem::path& path);
-        void load_texture_array(const std::string& texture_name, const std::vector<std::filesystem::path>& paths);
-
+        Model_Handle load_model(const std::string& model_name, const std::filesystem::path& path);
+        Texture_Handle load_texture(const std::string& texture_name, const std::filesystem::path& path);
+        Texture_Array_Handle load_texture_array(const std::string& texture_name, const std::vector<std::filesystem::path>& paths);
+
+        /// <summary>
+        /// Parses or decodes the file on a loader thread, the GPU upload is submitted at the start of a later frame (start_draw), a few loads per frame,
+        /// and the resource is added once a following frame finds its fence signaled.
+        /// The future becomes ready once the resource is loaded and holds its handle, or the exception of a failed load.
+        /// Call from the same thread as start_draw, like the synchronous loads.
+        /// </summary>
+        std::shared_future<Model_Handle> load_model_async(const std::string& model_name, const std::filesystem::path& path);
+        std::shared_future<Texture_Handle> load_texture_async(const std::string& texture_name, const std::filesystem::path& path);
+
+        void set_texture_cache_directory(const std::filesystem::path& directory);
+
+        /// <summary>
+        /// Blocks until every queued async load is uploaded, e.g. at the end of a loading screen. Skipped while a frame is being recorded.
+        /// </summary>
+        void wait_for_async_loads();
+
+        /// <summary>
+        /// Loads between these calls share a single upload submit instead of waiting for every copy, nested calls are allowed.
+        /// </summary>
+        void begin_upload_batch();
+        void end_upload_batch();
+
+        /// <summary>
+        /// Waits for the device to be idle before destroying the resource, skipped while a frame is being recorded.
+        /// </summary>
         void unload_model(const std::string& name);
+        void unload_model(const Model_Handle handle);
         void unload_texture(const std::string& name);
+        void unload_texture(const Texture_Handle handle);
         void unload_texture_array(const std::string& name);
+        void unload_texture_array(const Texture_Array_Handle handle);
 
         void start_draw();
         void end_draw();
 
+        /// <summary>
+        /// Queue a copy of the current render image to a readback buffer, the callback is called once the GPU finished the frame.
+        /// </summary>
+        void request_frame_capture(Frame_Capture_Callback callback);
+
+        //The string overloads resolve the names and forward to the handle overloads
         void draw_model(const std::string& model_name, const std::string& texture_name, const glm::mat4& model_matrix);
+        void draw_model(const Model_Handle model_handle, const Texture_Handle texture_handle, const glm::mat4& model_matrix);
         void draw_model_with_texture_array(const std::string& model_name, const std::string& texture_array_name, const int texture_index, const glm::mat4& model_matrix);
+        void draw_model_with_texture_array(const Model_Handle model_handle, const Texture_Array_Handle texture_array_handle, const int texture_index, const glm::mat4& model_matrix);
         void draw_instanced(const std::string& model_name, const std::string& texture_name, const std::vector<glm::mat4>& model_matrices);
+        void draw_instanced(const Model_Handle model_handle, const Texture_Handle texture_handle, const std::vector<glm::mat4>& model_matrices);
+        void draw_instanced(const std::string& model_name, const std::string& texture_name, const Instance_Format format, std::span<const std::byte> instance_data);
+        void draw_instanced(const Model_Handle model_handle, const Texture_Handle texture_handle, const Instance_Format format, std::span<const std::byte> instance_data);
         void draw_instanced_with_texture_array(const std::string& model_name, const std::string& texture_array_name, const std::vector<glm::mat4>& model_matrices, const std::vector<uint32_t>& texture_indices);
+        void draw_instanced_with_texture_array(const Model_Handle model_handle, const Texture_Array_Handle texture_array_handle, const std::vector<glm::mat4>& model_matrices, const std::vector<uint32_t>& texture_indices);
         void draw_planes(const std::string& texture_array_name, const std::vector<glm::mat4>& model_matrices, const std::vector<uint32_t>& texture_indices, const std::vector<glm::vec4>& min_max_uvs);
+        void draw_planes(const Texture_Array_Handle texture_array_handle, const std::vector<glm::mat4>& model_matrices, const std::vector<uint32_t>& texture_indices, const std::vector<glm::vec4>& min_max_uvs);
+
+        /// <summary>
+        /// Draws items of different models with one multi-draw indirect call per mesh buffer page, one indirect command per model.
+        /// </summary>
+        void draw_batch(const std::string& texture_array_name, std::span<const Batch_Item> items);
+        void draw_batch(const Texture_Array_Handle texture_array_handle, std::span<const Batch_Item> items);
+
+        /// <summary>
+        /// Bindless variant of draw_batch, every item is textured with its own texture from the bindless texture table.
+        /// </summary>
+        void draw_batch(std::span<const Batch_Item> items);
+        bool has_bindless_textures() const;
+
+        /// <summary>
+        /// Allocate instance data in the mapped instance buffer of this frame, the returned bytes are written by the caller.
+        /// Returns an empty span when the draw call is skipped.
+        /// </summary>
+        std::span<std::byte> begin_instances(const std::string& model_name, const std::string& texture_name, const uint32_t instance_count, const Instance_Format format);
+        std::span<std::byte> begin_instances(const Model_Handle model_handle, const Texture_Handle texture_handle, const uint32_t instance_count, const Instance_Format format);
+        void end_instances();
+
+        /// <summary>
+        /// Retained instance sets, the model matrices live in a device local buffer and are only uploaded when updated.
+        /// Updates inside a frame are copied through the per-frame staging ring before the render pass, outside a frame they are uploaded immediately.
+        /// </summary>
+        Instance_Set_Handle create_instance_set(const std::string& model_name, const std::string& texture_name, const uint32_t initial_capacity);
+        Instance_Set_Handle create_instance_set(const Model_Handle model_handle, const Texture_Handle texture_handle, const uint32_t initial_capacity);
+        void destroy_instance_set(const Instance_Set_Handle handle);
+        void update_instances(const Instance_Set_Handle handle, const uint32_t first, std::span<const glm::mat4> model_matrices);
+        void draw_instance_set(const Instance_Set_Handle handle);
 
         bool initialized() const;
+        bool is_headless() const;
+        bool should_close() const;
 
         bool framebuffer_resized = false;
 
         std::string get_memory_statistics() const;
+        Frame_Statistics get_frame_statistics() const;
+
+        uint32_t get_frames_in_flight() const;
+
+        /// <summary>
+        /// Slot of the per-frame resources the current (or next) frame records into, cycles through 0 to frames_in_flight - 1.
+        /// </summary>
+        uint32_t get_current_frame_index() const;
+
+        static constexpr uint32_t DEFAULT_FRAMES_IN_FLIGHT = 2;
+        static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 4;
+
+        void set_gpu_profiling(const bool enable);
+        GPU_Frame_Timings get_gpu_timings() const;
+
+        void set_gpu_culling(const bool enable);
+        bool is_gpu_culling_enabled() const;
+
+        void set_cpu_culling(const bool enable);
+        bool is_cpu_culling_enabled() const;
+
+        void set_auto_instancing(const bool enable);
+        bool is_auto_instancing_enabled() const;
+
+        /// <summary>
+        /// Multithreaded recording, every worker records its draw calls into its own secondary command buffer (one command pool per worker per frame in flight).
+        /// The render pass then executes the secondary command buffers of the render thread, the workers (in worker order) and the user interface.
+        /// 0 workers records directly into the primary command buffer. Only change the worker count outside of a frame.
+        /// </summary>
+        void set_recording_workers(const uint32_t worker_count);
+        uint32_t get_recording_workers() const;
+
+        /// <summary>
+        /// Binds the calling thread to a worker until end_worker_recording, the draw calls of the thread are recorded into the worker's command buffer.
+        /// Only valid between start_draw and end_draw, every worker has to be ended before end_draw.
+        /// </summary>
+        void begin_worker_recording(const uint32_t worker);
+        void end_worker_recording();
 
     private:
 
@@ -55,6 +176,20 @@ namespace vulvox
         void recreate_swap_chain();
         void cleanup_swap_chain();
 
+        //Headless equivalent of recreate_swap_chain, rebuilds the offscreen targets at the current width and height
+        void recreate_offscreen_targets();
+
+        //Render target accessors, these either refer to the swap chain or the offscreen targets (headless)
+        VkExtent2D get_render_extent() const;
+        VkFormat get_render_format() const;
+        std::vector<VkImageView> get_render_image_views() const;
+        std::vector<VkFramebuffer>& get_render_framebuffers();
+        VkImage get_render_image(const uint32_t image_index) const;
+
+        //Frame capture functions
+        void record_frame_capture();
+        void deliver_frame_captures(const uint32_t frame);
+
         void create_render_pass();
         void create_graphics_pipeline();
         void create_framebuffers();
@@ -74,35 +209,256 @@ namespace vulvox
         void start_record_command_buffer();
         void end_record_command_buffer();
 
+        //Draw calls are recorded into the command buffer of the calling thread's context, with statistics and scratch data per thread
+        struct Recording_Context;
+        Recording_Context& get_recording_context();
+
+        //Begins the secondary command buffer of a context, continuing the render pass of the frame
+        void begin_secondary_recording(Recording_Context& context, const uint32_t worker_slot);
+
+        //Ends the secondary command buffers of the frame and executes them in the render pass
+        void execute_secondary_command_buffers();
+
+        void record_viewport_and_scissor(VkCommandBuffer command_buffer) const;
+
+        //Records the queued draw_model calls of a context sorted by pipeline, descriptor set and buffers, skipping binds of unchanged state
+        //Runs of at least AUTO_INSTANCING_MIN_DRAWS draws of the same model and texture become a single instanced draw
+        void flush_draw_queue(Recording_Context& context);
+
+        //Records an instanced draw of which the model matrices are already in the instance buffer
+        void record_instanced_draw(const Model_Handle model_handle, const Texture_Handle texture_handle, const Buffer_Allocation& model_matrices_buffer, const uint32_t instance_count, const Instance_Format format);
+
+        //Records the batch items with the texture array pipeline, or with the bindless pipeline where every item selects its own texture
+        void record_batch(std::span<const Batch_Item> items, const bool bindless, VkDescriptorSet texture_descriptor_set, const std::string& scope_name);
+
+        //Output of the culling pass of a single draw
+        struct Culled_Instances
+        {
+            Buffer_Allocation instances;
+            Buffer_Allocation texture_indices;
+            Buffer_Allocation draw_command; //VkDrawIndexedIndirectCommand
+        };
+
+        //Records frustum culling in the upload command buffer, returns false when culling is disabled or not possible for this draw
+        bool cull_instances(const Model& model, const Buffer_Allocation& instances, const Buffer_Allocation* texture_indices, const uint32_t instance_count, Culled_Instances& culled_instances);
+
+        //Culls on the CPU and writes the visible model matrices to the instance buffer, returns the visible instance count (nothing is allocated when 0)
+        uint32_t cpu_cull_instances(Recording_Context& context, const glm::vec4& bounding_sphere, const std::vector<glm::mat4>& model_matrices, Buffer_Allocation& model_matrices_buffer);
+
+        //Clamps the requested amount to the supported range, only before the per-frame resources are created
+        void set_frames_in_flight(const uint32_t requested_frames_in_flight);
+
+        //Worker threads for CPU side frame work, started on first use
+        Thread_Pool& get_thread_pool();
+
+        //Separate workers for async loads, a long decode must not delay the frame work queued on the frame pool
+        Thread_Pool& get_loader_pool();
+
+        //Uploads up to max_uploads finished async loads, wait blocks until the queued loads are parsed instead of skipping them
+        void process_async_loads(const uint32_t max_uploads, const bool wait);
+
+        //Makes the futures of the uploaded async loads ready once their upload batch finished, which is later when the user opened a batch
+        void complete_async_loads();
+
+        //Registers an uploaded texture, shared by the synchronous and async loads
+        Texture_Handle insert_texture(const std::string& texture_name, const Image& image);
+
+        //Returns false when the shader of a compact instance format was not available at init, silent since the pipeline creation already reported it
+        bool has_instance_pipeline(const Instance_Format format) const;
+
+        //Instance set functions
+        struct Instance_Set;
+        Instance_Set* get_instance_set(const Instance_Set_Handle handle);
+        void grow_instance_set(VkCommandBuffer command_buffer, Instance_Set& instance_set, const uint32_t required_capacity);
+
+        //Frame slot whose next start destroys buffers that are replaced now
+        uint32_t get_retire_frame() const;
+
+        //Begins the upload command buffer of this frame on first use
+        VkCommandBuffer get_upload_command_buffer();
+
+        static void record_memory_barrier(VkCommandBuffer command_buffer, VkPipelineStageFlags src_stage, VkAccessFlags src_access, VkPipelineStageFlags dst_stage, VkAccessFlags dst_access);
+
         VkShaderModule create_shader_module(const std::vector<char>& bytecode);
 
         bool has_stencil_component(VkFormat format) const;
 
         bool is_initialized = false;
+        bool headless = false;
+
+        uint64_t frame_count = 0;
 
-        int frame_count = 0;
+        //Statistics of the frame that is being recorded and of the last completed frame
+        Frame_Statistics frame_statistics;
+        Frame_Statistics last_frame_statistics;
 
         uint32_t width = 800;
         uint32_t height = 600;
-        GLFWwindow* window;
+        GLFWwindow* window = nullptr;
 
         //Vulkan and device contexts
         Vulkan_Instance vulkan_instance;
 
         Vulkan_Swap_Chain swap_chain;
 
+        //Replaces the swap chain when rendering headless
+        Vulkan_Offscreen_Target offscreen_target;
+
         //Command pool and the allocated command buffers that store the commands send to the GPU
         Vulkan_Command_Pool command_pool;
 
+        //Per-frame command buffers for copies that have to happen outside the render pass, submitted before the frame's command buffer
+        Vulkan_Command_Pool upload_command_pool;
+
+        //Timestamp queries around the render pass and draw calls
+        Vulkan_GPU_Profiler gpu_profiler;
+
+        //Compute frustum culling of instanced draws
+        Vulkan_Instance_Culler instance_culler;
+
+        //Frustum culling of instanced draws on the CPU, before the instance data is written
+        CPU_Instance_Culler cpu_culler;
+        std::unique_ptr<Thread_Pool> thread_pool;
+        std::once_flag thread_pool_created;
+
         //Draw state
         VkCommandBuffer current_command_buffer;
         uint32_t current_image_index;
+        bool recording_frame = false;
+
+        VkCommandBuffer current_upload_command_buffer = VK_NULL_HANDLE;
+        bool upload_commands_recorded = false;
+
+        //Guards the upload command buffer, workers record culling dispatches into it
+        std::mutex upload_mutex;
 
         //Semaphores and fences to synchronize the gpu and host operations
         std::vector<VkSemaphore> image_available_semaphores;
         std::vector<VkSemaphore> render_finished_semaphores;
         std::vector<VkFence> in_flight_fences; //Fence for draw finish
 
+        //Instances handed out by begin_instances, recorded by end_instances
+        struct Pending_Instances
+        {
+            bool active = false;
+            Model_Handle model;
+            Texture_Handle texture;
+            uint32_t instance_count = 0;
+            Instance_Format format = Instance_Format::MAT4;
+            Buffer_Allocation allocation;
+        };
+
+        //draw_model call, recorded by flush_draw_queue
+        struct Queued_Draw
+        {
+            VkPipeline pipeline = VK_NULL_HANDLE;
+            VkDescriptorSet texture_descriptor_set = VK_NULL_HANDLE;
+            VkBuffer vertex_buffer = VK_NULL_HANDLE;
+            VkBuffer index_buffer = VK_NULL_HANDLE;
+            uint32_t index_count = 0;
+            uint32_t first_index = 0;
+            int32_t vertex_offset = 0;
+            glm::mat4 model_matrix{ 1.0f };
+            //Used for the GPU scope and automatic instancing
+            Model_Handle model;
+            Texture_Handle texture;
+        };
+
+        struct Recording_Context
+        {
+            VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+            bool begun = false; //Secondary command buffer has been begun this frame
+            bool bound = false; //A worker thread is recording into this context
+
+            //Only the draw call, instance and culling counts are used, merged into the frame statistics at end_draw
+            Frame_Statistics statistics;
+
+            Pending_Instances pending_instances;
+            CPU_Cull_Result cull_result;
+
+            //draw_model calls of this frame, the vector keeps its capacity between frames
+            std::vector<Queued_Draw> draw_queue;
+
+            //Scratch space of draw_batch, (mesh buffer page, model index, item index)
+            std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> batch_order;
+        };
+
+        //Render thread context first, then one per worker and the user interface last (only the first when recording single threaded)
+        std::vector<Recording_Context> recording_contexts;
+        uint32_t recording_workers = 0;
+
+        //Batch repeated draw_model calls into instanced draws
+        bool auto_instancing = true;
+        static constexpr uint32_t AUTO_INSTANCING_MIN_DRAWS = 4;
+
+        //Async load that is parsed or decoded on the loader pool and waits for its upload on the render thread
+        template<typename Data, typename Handle>
+        struct Pending_Load
+        {
+            std::string name;
+            std::future<Data> data;
+            std::promise<Handle> promise;
+            std::shared_future<Handle> handle;
+        };
+
+        std::vector<Pending_Load<Model_Data, Model_Handle>> pending_model_loads;
+        std::vector<Pending_Load<Image_Data, Texture_Handle>> pending_texture_loads;
+
+        //Async load whose upload is submitted, the resource is added (and its future becomes ready) once the upload batch holding it has finished
+        template<typename Resource, typename Handle>
+        struct Uploaded_Load
+        {
+            std::string name;
+            Resource resource;
+            std::promise<Handle> promise;
+            std::shared_future<Handle> handle;
+            uint64_t upload_ticket = 0;
+        };
+
+        std::vector<Uploaded_Load<Model, Model_Handle>> uploaded_model_loads;
+        std::vector<Uploaded_Load<Image, Texture_Handle>> uploaded_texture_loads;
+        std::unique_ptr<Thread_Pool> loader_pool;
+
+        //Compressed versions of the loaded textures, only resolved against, the entries are written offline
+        Texture_Cache texture_cache{ Texture_Cache::DEFAULT_DIRECTORY };
+
+        //Recording the staging copies and mip generation still runs on the render thread, limiting them per frame spreads a burst of finished loads
+        static constexpr uint32_t ASYNC_UPLOADS_PER_FRAME = 4;
+        static constexpr uint32_t LOADER_THREAD_COUNT = 2;
+
+        //Context the calling worker thread is bound to, nullptr on the render thread
+        static thread_local Recording_Context* thread_recording_context;
+
+        //Retained instance sets, slots of destroyed sets are reused
+        struct Instance_Set
+        {
+            bool in_use = false;
+            uint32_t generation = 0;
+
+            Model_Handle model;
+            Texture_Handle texture;
+
+            //Device local model matrices
+            Buffer buffer;
+            uint32_t capacity = 0;
+            uint32_t instance_count = 0;
+
+            uint64_t last_upload_frame = UINT64_MAX;
+        };
+        std::vector<Instance_Set> instance_sets;
+        std::vector<uint32_t> free_instance_sets;
+
+        //Frame captures requested for the frame that is currently being recorded
+        std::vector<Frame_Capture_Callback> frame_capture_requests;
+
+        //Frame captures recorded in a frame in flight, delivered once the fence of that frame signals
+        struct Pending_Frame_Capture
+        {
+            Frame_Capture capture;
+            std::vector<Frame_Capture_Callback> callbacks;
+        };
+        std::vector<Pending_Frame_Capture> pending_frame_captures;
+
         VkRenderPass render_pass; //Stores how the render images are handeled
 
         VkDescriptorSetLayout mvp_descriptor_set_layout;
@@ -110,18 +466,23 @@ namespace vulvox
         VkPipelineLayout pipeline_layout; //Describes the layout of the 'global' data, e.g. uniform buffers
 
         //GPU draw state (stages, shaders, rasterization options, depth settings, etc.)
-        VkPipeline instance_pipeline;
+        std::array<VkPipeline, static_cast<size_t>(Instance_Format::COUNT)> instance_pipelines{}; //One per instance format
         VkPipeline instance_tex_array_pipeline;
         VkPipeline vertex_pipeline;
         VkPipeline instance_plane_pipeline;
 
+        //Optional, only created when the device supports descriptor indexing and the bindless shaders are compiled
+        Vulkan_Bindless_Table bindless_table;
+        VkPipelineLayout bindless_pipeline_layout = VK_NULL_HANDLE;
+        VkPipeline bindless_pipeline = VK_NULL_HANDLE;
+
         ///Stuff that gets send to the shaders
 
 
 
         //Descriptor pool and sets, 
         //holds the binding information that connects the shader inputs to the data
-        VkDescriptorPool descriptor_pool;
+        Vulkan_Descriptor_Allocator descriptor_allocator;
 
         struct Descriptor_Sets
         {
@@ -137,11 +498,24 @@ namespace vulvox
         //Manages all the uniform and instance buffers
         Vulkan_Buffer_Manager buffer_manager;
 
-        std::unordered_map<std::string, Model> models;
-        std::unordered_map<std::string, Image> textures;
-        std::unordered_map<std::string, VkDescriptorSet> texture_descriptor_sets;
-        std::unordered_map<std::string, VkDescriptorSet> texture_array_descriptor_sets;
-        std::unordered_map<std::string, Image> texture_arrays;
+        //Vertex and index data of all models
+        Vulkan_Mesh_Buffer mesh_buffer;
+
+        //Textures and texture arrays with the descriptor set that binds them
+        struct Texture
+        {
+            Image image;
+            VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+        };
+
+        //Resolve a name for the string based draw functions, prints a message and returns an invalid handle when it is not loaded
+        Model_Handle find_model(const std::string& model_name) const;
+        Texture_Handle find_texture(const std::string& texture_name) const;
+        Texture_Array_Handle find_texture_array(const std::string& texture_array_name) const;
+
+        Resource_Slots<Model, Model_Handle> models;
+        Resource_Slots<Texture, Texture_Handle> textures;
+        Resource_Slots<Texture, Texture_Array_Handle> texture_arrays;
 
         MVP_Handler mvp_handler;
 
@@ -149,8 +523,9 @@ namespace vulvox
         std::unique_ptr<ImGui_Context> imgui_context;
 
         //We don't want to wait for the previous frame to finish while processing the next frame,
-        //so we create double the amount of buffers so we can overlap frame processing
-        static const int MAX_FRAMES_IN_FLIGHT;
+        //so every frame in flight gets its own set of per-frame resources and the frames overlap
+        //More frames in flight trade latency for throughput, set at init
+        uint32_t frames_in_flight = DEFAULT_FRAMES_IN_FLIGHT;
         uint32_t current_frame = 0;
     };
 
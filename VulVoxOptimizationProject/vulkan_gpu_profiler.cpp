@@ -0,0 +1,206 @@
+#include "pch.h"
+#include "vulkan_gpu_profiler.h"
+
+namespace vulvox
+{
+    void Vulkan_GPU_Profiler::init(Vulkan_Instance* vulkan_instance, const uint32_t frames_in_flight, const uint32_t max_scopes_per_frame)
+    {
+        this->vulkan_instance = vulkan_instance;
+        this->max_scopes_per_frame = max_scopes_per_frame;
+
+        //Timestamps are only supported if the queue reports valid timestamp bits
+        Queue_Family_Indices indices = vulkan_instance->get_queue_families(vulkan_instance->surface);
+
+        uint32_t queue_family_count = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(vulkan_instance->physical_device, &queue_family_count, nullptr);
+        std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+        vkGetPhysicalDeviceQueueFamilyProperties(vulkan_instance->physical_device, &queue_family_count, queue_families.data());
+
+        uint32_t valid_bits = queue_families[indices.graphics_family.value()].timestampValidBits;
+        VkPhysicalDeviceProperties properties = vulkan_instance->get_physical_device_properties();
+
+        supported = valid_bits > 0 && properties.limits.timestampPeriod > 0.0f;
+
+        if (!supported)
+        {
+            std::cout << "Graphics queue does not support timestamp queries, GPU profiling is not available." << std::endl;
+            return;
+        }
+
+        timestamp_period = static_cast<double>(properties.limits.timestampPeriod);
+        timestamp_mask = valid_bits >= 64 ? std::numeric_limits<uint64_t>::max() : ((uint64_t{ 1 } << valid_bits) - 1);
+
+        //Two timestamps per scope, a begin and an end
+        VkQueryPoolCreateInfo query_pool_info{};
+        query_pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        query_pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        query_pool_info.queryCount = max_scopes_per_frame * 2;
+
+        frame_queries.resize(frames_in_flight);
+
+        for (auto& queries : frame_queries)
+        {
+            if (vkCreateQueryPool(vulkan_instance->device, &query_pool_info, nullptr, &queries.query_pool) != VK_SUCCESS)
+            {
+                throw std::runtime_error("Failed to create timestamp query pool!");
+            }
+
+            queries.scope_names.reserve(max_scopes_per_frame);
+        }
+    }
+
+    void Vulkan_GPU_Profiler::destroy()
+    {
+        for (auto& queries : frame_queries)
+        {
+            vkDestroyQueryPool(vulkan_instance->device, queries.query_pool, nullptr);
+        }
+        frame_queries.clear();
+        current_queries = nullptr;
+    }
+
+    bool Vulkan_GPU_Profiler::is_supported() const
+    {
+        return supported;
+    }
+
+    void Vulkan_GPU_Profiler::set_enabled(const bool enable)
+    {
+        if (enable && !supported)
+        {
+            std::cout << "GPU profiling is not supported on this device." << std::endl;
+            return;
+        }
+
+        enabled = enable;
+
+        if (!enabled)
+        {
+            timings = GPU_Frame_Timings{};
+        }
+    }
+
+    bool Vulkan_GPU_Profiler::is_enabled() const
+    {
+        return enabled;
+    }
+
+    void Vulkan_GPU_Profiler::resolve_frame(const uint32_t frame)
+    {
+        if (frame >= frame_queries.size())
+        {
+            return;
+        }
+
+        Frame_Queries& queries = frame_queries[frame];
+
+        if (!queries.recorded)
+        {
+            return;
+        }
+        queries.recorded = false;
+
+        uint32_t query_count = static_cast<uint32_t>(queries.scope_names.size()) * 2;
+        std::vector<uint64_t> timestamps(query_count);
+
+        //The frame fence has signaled, so all results are available and we don't need to wait
+        VkResult result = vkGetQueryPoolResults(vulkan_instance->device, queries.query_pool, 0, query_count,
+            timestamps.size() * sizeof(uint64_t), timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+        if (result != VK_SUCCESS)
+        {
+            return;
+        }
+
+        auto to_milliseconds = [&](uint32_t scope)
+            {
+                uint64_t begin = timestamps[scope * 2] & timestamp_mask;
+                uint64_t end = timestamps[scope * 2 + 1] & timestamp_mask;
+                return static_cast<double>((end - begin) & timestamp_mask) * timestamp_period / 1000000.0;
+            };
+
+        timings.frame_number = queries.frame_number;
+        timings.valid = true;
+        timings.render_pass_ms = to_milliseconds(0);
+
+        timings.draw_timings.resize(queries.scope_names.size() - 1);
+        for (uint32_t scope = 1; scope < queries.scope_names.size(); scope++)
+        {
+            timings.draw_timings[scope - 1].name = queries.scope_names[scope];
+            timings.draw_timings[scope - 1].duration_ms = to_milliseconds(scope);
+        }
+    }
+
+    void Vulkan_GPU_Profiler::begin_frame(VkCommandBuffer command_buffer, const uint32_t frame, const uint64_t frame_number)
+    {
+        current_queries = nullptr;
+
+        if (!enabled || frame >= frame_queries.size())
+        {
+            return;
+        }
+
+        current_queries = &frame_queries[frame];
+        current_queries->scope_names.clear();
+        current_queries->frame_number = frame_number;
+        current_queries->recorded = true;
+
+        //Queries have to be reset before use, this is not allowed inside a render pass
+        vkCmdResetQueryPool(command_buffer, current_queries->query_pool, 0, max_scopes_per_frame * 2);
+
+        current_queries->scope_names.emplace_back("render_pass");
+        vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, current_queries->query_pool, 0);
+    }
+
+    void Vulkan_GPU_Profiler::end_frame(VkCommandBuffer command_buffer)
+    {
+        if (current_queries == nullptr)
+        {
+            return;
+        }
+
+        end_scope(command_buffer, 0);
+        current_queries = nullptr;
+    }
+
+    uint32_t Vulkan_GPU_Profiler::begin_scope(VkCommandBuffer command_buffer, const char* category, const std::string& name)
+    {
+        if (current_queries == nullptr)
+        {
+            return NO_SCOPE;
+        }
+
+        uint32_t scope = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(scope_mutex);
+
+            if (current_queries->scope_names.size() >= max_scopes_per_frame)
+            {
+                return NO_SCOPE;
+            }
+
+            scope = static_cast<uint32_t>(current_queries->scope_names.size());
+            current_queries->scope_names.emplace_back(std::string(category) + " " + name);
+        }
+
+        vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, current_queries->query_pool, scope * 2);
+
+        return scope;
+    }
+
+    void Vulkan_GPU_Profiler::end_scope(VkCommandBuffer command_buffer, const uint32_t scope)
+    {
+        if (current_queries == nullptr || scope == NO_SCOPE)
+        {
+            return;
+        }
+
+        vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, current_queries->query_pool, scope * 2 + 1);
+    }
+
+    const GPU_Frame_Timings& Vulkan_GPU_Profiler::get_timings() const
+    {
+        return timings;
+    }
+}
\ No newline at end of file
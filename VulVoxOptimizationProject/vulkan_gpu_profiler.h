@@ -0,0 +1,85 @@
+#pragma once
+
+namespace vulvox
+{
+    /// <summary>
+    /// Measures GPU execution times with timestamp queries.
+    /// Every frame in flight owns a query pool, the results of a frame are read back once the fence of that frame has signaled so the host never waits on the GPU.
+    /// </summary>
+    class Vulkan_GPU_Profiler
+    {
+    public:
+
+        Vulkan_GPU_Profiler() = default;
+
+        void init(Vulkan_Instance* vulkan_instance, const uint32_t frames_in_flight, const uint32_t max_scopes_per_frame = 2048);
+        void destroy();
+
+        /// <summary>
+        /// False if the graphics queue does not support timestamps.
+        /// </summary>
+        bool is_supported() const;
+
+        void set_enabled(const bool enable);
+        bool is_enabled() const;
+
+        /// <summary>
+        /// Read back the timestamps of the given frame, only call this after the fence of the frame has signaled.
+        /// </summary>
+        void resolve_frame(const uint32_t frame);
+
+        /// <summary>
+        /// Resets the query pool of the frame and starts the render pass scope, has to be recorded outside of a render pass.
+        /// </summary>
+        void begin_frame(VkCommandBuffer command_buffer, const uint32_t frame, const uint64_t frame_number);
+
+        /// <summary>
+        /// Ends the render pass scope, call after the render pass has ended.
+        /// </summary>
+        void end_frame(VkCommandBuffer command_buffer);
+
+        /// <summary>
+        /// Write a start timestamp for a scope, returns the scope index to pass to end_scope.
+        /// The name is only built when profiling, so there is no cost when disabled. Safe to call from multiple recording threads.
+        /// </summary>
+        uint32_t begin_scope(VkCommandBuffer command_buffer, const char* category, const std::string& name);
+        void end_scope(VkCommandBuffer command_buffer, const uint32_t scope);
+
+        /// <summary>
+        /// Timings of the most recently resolved frame.
+        /// </summary>
+        const GPU_Frame_Timings& get_timings() const;
+
+        //Returned by begin_scope when the scope is not profiled (disabled or out of queries)
+        static constexpr uint32_t NO_SCOPE = std::numeric_limits<uint32_t>::max();
+
+    private:
+
+        struct Frame_Queries
+        {
+            VkQueryPool query_pool = VK_NULL_HANDLE;
+            std::vector<std::string> scope_names; //Scope 0 is the render pass
+            uint64_t frame_number = 0;
+            bool recorded = false;
+        };
+
+        Vulkan_Instance* vulkan_instance = nullptr;
+
+        std::vector<Frame_Queries> frame_queries;
+        Frame_Queries* current_queries = nullptr;
+
+        //Guards the scope list when scopes are recorded on multiple threads
+        std::mutex scope_mutex;
+
+        GPU_Frame_Timings timings;
+
+        uint32_t max_scopes_per_frame = 0;
+
+        bool supported = false;
+        bool enabled = false;
+
+        //Nanoseconds per timestamp tick and the mask of valid timestamp bits
+        double timestamp_period = 1.0;
+        uint64_t timestamp_mask = 0;
+    };
+}
\ No newline at end of file
@@ -5,12 +5,13 @@ namespace vulvox
 {
     void Image::create_image(Vulkan_Instance* vulkan_instance,
         uint32_t image_width, uint32_t image_height,
-        VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkImageAspectFlags aspect_flags, VmaMemoryUsage memory_usage)
+        VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkImageAspectFlags aspect_flags, VmaMemoryUsage memory_usage, uint32_t mip_level_count)
     {
         this->vulkan_instance = vulkan_instance;
         this->width = image_width;
         this->height = image_height;
         this->layer_count = 1;
+        this->mip_levels = mip_level_count;
         this->format = format;
         this->aspect_flags = aspect_flags;
 
@@ -21,7 +22,7 @@ namespace vulvox
         image_info.extent.width = width;
         image_info.extent.height = height;
         image_info.extent.depth = 1;
-        image_info.mipLevels = 1; //No mip mapping
+        image_info.mipLevels = mip_levels; //1 for render targets, a full chain for textures
         image_info.arrayLayers = 1;
         image_info.format = format; //Same as pixel buffers
         image_info.tiling = tiling; //We dont need to access the images memory so no need for linear tiling
@@ -45,12 +46,13 @@ namespace vulvox
 
     void Image::create_image(Vulkan_Instance* vulkan_instance,
         uint32_t image_width, uint32_t image_height, uint32_t array_layers,
-        VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkImageAspectFlags aspect_flags, VmaMemoryUsage memory_usage)
+        VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkImageAspectFlags aspect_flags, VmaMemoryUsage memory_usage, uint32_t mip_level_count)
     {
         this->vulkan_instance = vulkan_instance;
         this->width = image_width;
         this->height = image_height;
         this->layer_count = array_layers;
+        this->mip_levels = mip_level_count;
         this->format = format;
         this->aspect_flags = aspect_flags;
 
@@ -61,7 +63,7 @@ namespace vulvox
         image_info.extent.width = width;
         image_info.extent.height = height;
         image_info.extent.depth = 1;
-        image_info.mipLevels = 1; //No mip mapping
+        image_info.mipLevels = mip_levels; //1 for render targets, a full chain for textures
         image_info.arrayLayers = array_layers;
         image_info.format = format; //Same as pixel buffers
         image_info.tiling = tiling; //We dont need to access the images memory so no need for linear tiling
@@ -97,10 +99,10 @@ namespace vulvox
 
         //Default color channel mapping (SWIZZLE to default)
 
-        //Single layer image, no mipmapping
+        //Single layer image, all mip levels
         view_info.subresourceRange.aspectMask = aspect_flags;
         view_info.subresourceRange.baseMipLevel = 0;
-        view_info.subresourceRange.levelCount = 1;
+        view_info.subresourceRange.levelCount = mip_levels;
         view_info.subresourceRange.baseArrayLayer = 0;
         view_info.subresourceRange.layerCount = 1;
 
@@ -124,10 +126,10 @@ namespace vulvox
 
         //Default color channel mapping (SWIZZLE to default)
 
-        //Single layer image, no mipmapping
+        //All layers and mip levels
         view_info.subresourceRange.aspectMask = aspect_flags;
         view_info.subresourceRange.baseMipLevel = 0;
-        view_info.subresourceRange.levelCount = 1;
+        view_info.subresourceRange.levelCount = mip_levels;
         view_info.subresourceRange.baseArrayLayer = 0;
         view_info.subresourceRange.layerCount = layer_count;
 
@@ -166,11 +168,11 @@ namespace vulvox
         sampler_info.compareEnable = VK_FALSE;
         sampler_info.compareOp = VK_COMPARE_OP_ALWAYS;
 
-        //No mip mapping at the moment, for later?
+        //Trilinear filtering over the whole mip chain
         sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
         sampler_info.mipLodBias = 0.0f;
         sampler_info.minLod = 0.0f;
-        sampler_info.maxLod = VK_LOD_CLAMP_NONE;
+        sampler_info.maxLod = static_cast<float>(mip_levels);
 
         if (vkCreateSampler(vulkan_instance->device, &sampler_info, nullptr, &sampler) != VK_SUCCESS)
         {
@@ -180,9 +182,6 @@ namespace vulvox
 
     void Image::transition_image_layout(Vulkan_Command_Pool& command_pool, VkImageLayout new_layout)
     {
-        VkCommandBuffer command_buffer = command_pool.begin_single_time_commands();
-
-
         //Create barrier to prevent reading before write is done
         VkImageMemoryBarrier barrier{};
         barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -195,8 +194,8 @@ namespace vulvox
 
         barrier.image = image;
         barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.baseMipLevel = 0; //No mipmapping
-        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseMipLevel = 0; //All mip levels
+        barrier.subresourceRange.levelCount = mip_levels;
         barrier.subresourceRange.baseArrayLayer = 0;
         barrier.subresourceRange.layerCount = layer_count;
 
@@ -211,6 +210,20 @@ namespace vulvox
 
             source_stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT; //Start immediately (start of pipeline)
             destination_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+            //Part of the copy, so it runs on the transfer queue (if there is one) in front of the copy
+            VkCommandBuffer command_buffer = command_pool.begin_transfer_commands();
+
+            //Send command for image barrier
+            vkCmdPipelineBarrier(command_buffer,
+                source_stage,
+                destination_stage,
+                0,
+                0, nullptr,
+                0, nullptr,
+                1, &barrier);
+
+            command_pool.end_transfer_commands();
         }
         else if (current_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && new_layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
         {
@@ -218,26 +231,139 @@ namespace vulvox
             barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
             barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
-            source_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
             destination_stage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+            //The fragment shader stage only exists on the graphics queue, the command pool hands the image over from the transfer queue
+            command_pool.record_upload_barrier(barrier, destination_stage);
         }
         else
         {
             throw std::invalid_argument("Unsupported layout transition!");
         }
 
-        //Send command for image barrier
+        current_layout = new_layout;
+    }
+
+    void Image::generate_mipmaps(Vulkan_Command_Pool& command_pool)
+    {
+        if (current_layout != VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+        {
+            throw std::invalid_argument("Mipmap generation requires the image in the transfer dst layout!");
+        }
+
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = mip_levels;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = layer_count;
+
+        //Make the copy visible to the blits, this also hands the image over to the graphics queue when the copy ran on the transfer queue
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+        command_pool.record_upload_barrier(barrier, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+        //Blits are recorded after the acquire in the graphics commands of the upload batch
+        VkCommandBuffer command_buffer = command_pool.begin_single_time_commands();
+
+        barrier.subresourceRange.levelCount = 1;
+
+        int32_t mip_width = static_cast<int32_t>(width);
+        int32_t mip_height = static_cast<int32_t>(height);
+
+        for (uint32_t i = 1; i < mip_levels; i++)
+        {
+            //Previous level is written (by the copy or the previous blit), read it as blit source
+            barrier.subresourceRange.baseMipLevel = i - 1;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+            vkCmdPipelineBarrier(command_buffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                0, nullptr,
+                0, nullptr,
+                1, &barrier);
+
+            int32_t next_width = std::max(mip_width / 2, 1);
+            int32_t next_height = std::max(mip_height / 2, 1);
+
+            //Downsample the previous level into this one, all layers at once
+            VkImageBlit blit{};
+            blit.srcOffsets[0] = { 0, 0, 0 };
+            blit.srcOffsets[1] = { mip_width, mip_height, 1 };
+            blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.srcSubresource.mipLevel = i - 1;
+            blit.srcSubresource.baseArrayLayer = 0;
+            blit.srcSubresource.layerCount = layer_count;
+            blit.dstOffsets[0] = { 0, 0, 0 };
+            blit.dstOffsets[1] = { next_width, next_height, 1 };
+            blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.dstSubresource.mipLevel = i;
+            blit.dstSubresource.baseArrayLayer = 0;
+            blit.dstSubresource.layerCount = layer_count;
+
+            vkCmdBlitImage(command_buffer,
+                image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                1, &blit,
+                VK_FILTER_LINEAR);
+
+            //Previous level is done, ready it for sampling
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+            vkCmdPipelineBarrier(command_buffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                0, nullptr,
+                0, nullptr,
+                1, &barrier);
+
+            mip_width = next_width;
+            mip_height = next_height;
+        }
+
+        //Last level is only ever written
+        barrier.subresourceRange.baseMipLevel = mip_levels - 1;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
         vkCmdPipelineBarrier(command_buffer,
-            source_stage,
-            destination_stage,
-            0,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
             0, nullptr,
             0, nullptr,
             1, &barrier);
 
-        current_layout = new_layout;
+        command_pool.end_single_time_commands();
+
+        current_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+
+    uint32_t Image::get_mip_level_count(const Vulkan_Instance& vulkan_instance, uint32_t image_width, uint32_t image_height, VkFormat format)
+    {
+        //Blits with a linear filter need format support, without it the texture keeps a single level
+        VkFormatProperties format_properties;
+        vkGetPhysicalDeviceFormatProperties(vulkan_instance.physical_device, format, &format_properties);
+
+        if (!(format_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
+        {
+            std::cout << "Texture format does not support linear blitting, mipmaps are not generated." << std::endl;
+            return 1;
+        }
 
-        command_pool.end_single_time_commands(command_buffer);
+        return static_cast<uint32_t>(std::floor(std::log2(std::max(image_width, image_height)))) + 1;
     }
 
     void Image::destroy()
@@ -251,7 +377,7 @@ namespace vulvox
 
     void Image::copy_buffer_to_image(Vulkan_Command_Pool& command_pool, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height)
     {
-        VkCommandBuffer command_buffer = command_pool.begin_single_time_commands();
+        VkCommandBuffer command_buffer = command_pool.begin_transfer_commands();
 
         VkBufferImageCopy region{};
         region.bufferOffset = 0; //Start of pixel values
@@ -276,12 +402,12 @@ namespace vulvox
             1,
             &region);
 
-        command_pool.end_single_time_commands(command_buffer);
+        command_pool.end_transfer_commands();
     }
 
     void Image::copy_buffer_to_image_array(Vulkan_Command_Pool& command_pool, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, uint32_t layer_count, VkDeviceSize layer_size)
     {
-        VkCommandBuffer command_buffer = command_pool.begin_single_time_commands();
+        VkCommandBuffer command_buffer = command_pool.begin_transfer_commands();
 
         std::vector<VkBufferImageCopy> copy_regions;
         for (uint32_t i = 0; i < layer_count; i++)
@@ -313,37 +439,102 @@ namespace vulvox
             static_cast<uint32_t>(copy_regions.size()),
             copy_regions.data());
 
-        command_pool.end_single_time_commands(command_buffer);
+        command_pool.end_transfer_commands();
+    }
+
+    void Image::copy_buffer_to_image_regions(Vulkan_Command_Pool& command_pool, VkBuffer buffer, VkImage image, std::span<const VkBufferImageCopy> regions)
+    {
+        VkCommandBuffer command_buffer = command_pool.begin_transfer_commands();
+
+        //Enqueue the copies of all mip levels and layers at once
+        vkCmdCopyBufferToImage(
+            command_buffer,
+            buffer,
+            image,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            static_cast<uint32_t>(regions.size()),
+            regions.data());
+
+        command_pool.end_transfer_commands();
     }
 
     Image Image::create_texture_image(Vulkan_Instance& vulkan_instance, Vulkan_Command_Pool& command_pool, const std::filesystem::path& texture_path)
     {
+        return create_texture_image(vulkan_instance, command_pool, decode_texture(texture_path));
+    }
+
+    Image_Data Image::decode_texture(const std::filesystem::path& texture_path)
+    {
+        VULVOX_PROFILE_SCOPE("Image::decode_texture");
+
+        //Precompressed files skip the decode, the blocks are copied to the image as they are
+        if (Texture_File::is_compressed_texture_path(texture_path))
+        {
+            Image_Data image_data{};
+            image_data.compressed = Texture_File::load(texture_path);
+            image_data.width = image_data.compressed->width;
+            image_data.height = image_data.compressed->height;
+
+            return image_data;
+        }
+
         int texture_width;
         int texture_height;
         int texture_channels;
 
         //Load texture image, force alpha channel
-        stbi_uc* pixels = stbi_load(texture_path.string().c_str(), &texture_width, &texture_height, &texture_channels, STBI_rgb_alpha);
-        VkDeviceSize image_size = texture_width * texture_height * 4; //RGBA8 assumed
+        Image_Data image_data{};
+        image_data.pixels.reset(stbi_load(texture_path.string().c_str(), &texture_width, &texture_height, &texture_channels, STBI_rgb_alpha));
+
+        if (!image_data.pixels)
+        {
+            throw std::runtime_error("Failed to load texture image! Path was: " + texture_path.string());
+        }
+
+        image_data.width = static_cast<uint32_t>(texture_width);
+        image_data.height = static_cast<uint32_t>(texture_height);
+
+        return image_data;
+    }
+
+    Image Image::create_texture_image(Vulkan_Instance& vulkan_instance, Vulkan_Command_Pool& command_pool, const Image_Data& image_data)
+    {
+        VULVOX_PROFILE_SCOPE("Image::create_texture_image");
 
-        if (!pixels)
+        if (image_data.compressed)
         {
-            throw std::runtime_error("Failed to load texture image!");
+            if (image_data.compressed->layer_count > 1)
+            {
+                std::cout << "Warning: Compressed texture has " << image_data.compressed->layer_count << " layers, only the first layer is used. Load it as a texture array to use all layers." << std::endl;
+            }
+
+            if (vulkan_instance.supports_compressed_format(image_data.compressed->format))
+            {
+                return create_compressed_texture_image(vulkan_instance, command_pool, *image_data.compressed, false);
+            }
+
+            std::cout << "Block compressed texture format is not supported by the device, decompressing to RGBA8." << std::endl;
+            return create_texture_image(vulkan_instance, command_pool, decompress_texture(*image_data.compressed, 0));
         }
 
+        VkDeviceSize image_size = static_cast<VkDeviceSize>(image_data.width) * image_data.height * 4; //RGBA8 assumed
+
         //Setup host visible staging buffer
         Buffer staging_buffer;
         staging_buffer.create(vulkan_instance, image_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
             VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
 
-        //Copy the texture data into the staging buffer
-        memcpy(staging_buffer.allocation_info.pMappedData, pixels, image_size);
+        //Copy the texture data into the staging buffer, the decoded pixels are released by the owner of the image data
+        memcpy(staging_buffer.allocation_info.pMappedData, image_data.pixels.get(), image_size);
 
-        //Image in staging buffer, we can free the image data
-        stbi_image_free(pixels);
+        //Full mip chain, the lower levels are blitted from level 0 (so it is also a transfer source)
+        uint32_t mip_level_count = get_mip_level_count(vulkan_instance, image_data.width, image_data.height, VK_FORMAT_R8G8B8A8_SRGB);
 
         Image texture_image;
-        texture_image.create_image(&vulkan_instance, texture_width, texture_height, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_ASPECT_COLOR_BIT, VMA_MEMORY_USAGE_AUTO);
+        texture_image.create_image(&vulkan_instance, image_data.width, image_data.height, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_ASPECT_COLOR_BIT, VMA_MEMORY_USAGE_AUTO, mip_level_count);
+
+        //The transitions and the copy are submitted together (with the other uploads when the caller opened a batch)
+        command_pool.begin_upload_batch();
 
         //Change layout of target image memory to be optimal for writing destination
         texture_image.transition_image_layout(command_pool, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
@@ -351,10 +542,18 @@ namespace vulvox
         //Transfer the image data from the staging buffer to the image memory
         copy_buffer_to_image(command_pool, staging_buffer.buffer, texture_image.image, texture_image.width, texture_image.height);
 
-        //Change layout of image memory to be optimal for reading by a shader
-        texture_image.transition_image_layout(command_pool, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        //Fill the lower mip levels, this leaves every level optimal for reading by a shader
+        if (texture_image.mip_levels > 1)
+        {
+            texture_image.generate_mipmaps(command_pool);
+        }
+        else
+        {
+            texture_image.transition_image_layout(command_pool, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        }
 
-        staging_buffer.destroy(vulkan_instance.allocator);
+        command_pool.release_staging_buffer(staging_buffer);
+        command_pool.end_upload_batch();
 
         texture_image.create_image_view();
         texture_image.create_texture_sampler();
@@ -369,28 +568,86 @@ namespace vulvox
             throw std::runtime_error("Failed to load texture image! No texture paths given.");
         }
 
-        std::vector<stbi_uc*> pixel_layers;
+        std::vector<Image_Data> textures;
 
-        std::vector<uint32_t> texture_widths{};
-        std::vector<uint32_t> texture_heights{};
+        for (const auto& texture_path : texture_paths)
+        {
+            textures.push_back(decode_texture(texture_path));
+        }
 
-        int texture_width = 0;
-        int texture_height = 0;
-        int texture_channels = 0;
+        //Block compressed files are uploaded as they are when they all match, their layers become consecutive layers of the array
+        if (std::ranges::all_of(textures, [](const Image_Data& texture) { return texture.compressed.has_value(); }))
+        {
+            const Compressed_Image_Data& first = *textures.front().compressed;
 
-        for (const auto& texture_path : texture_paths)
+            bool matching = std::ranges::all_of(textures, [&first](const Image_Data& texture)
+                {
+                    return texture.compressed->format == first.format && texture.compressed->width == first.width
+                        && texture.compressed->height == first.height && texture.compressed->mip_levels == first.mip_levels;
+                });
+
+            if (!matching)
+            {
+                std::cout << "Warning: Given compressed textures for texture array creation differ in format, size or mip levels! Decompressing them to RGBA8." << std::endl;
+            }
+            else if (!vulkan_instance.supports_compressed_format(first.format))
+            {
+                std::cout << "Block compressed texture format is not supported by the device, decompressing to RGBA8." << std::endl;
+            }
+            else
+            {
+                Compressed_Image_Data layered_image_data{};
+                layered_image_data.format = first.format;
+                layered_image_data.width = first.width;
+                layered_image_data.height = first.height;
+                layered_image_data.layer_count = 0;
+                layered_image_data.mip_levels = first.mip_levels;
+
+                for (const auto& texture : textures)
+                {
+                    VkDeviceSize offset = layered_image_data.blocks.size();
+
+                    for (VkBufferImageCopy region : texture.compressed->regions)
+                    {
+                        region.bufferOffset += offset;
+                        region.imageSubresource.baseArrayLayer += layered_image_data.layer_count;
+                        layered_image_data.regions.push_back(region);
+                    }
+
+                    layered_image_data.blocks.insert(layered_image_data.blocks.end(), texture.compressed->blocks.begin(), texture.compressed->blocks.end());
+                    layered_image_data.layer_count += texture.compressed->layer_count;
+                }
+
+                return create_compressed_texture_image(vulkan_instance, command_pool, layered_image_data, true);
+            }
+        }
+
+        //RGBA8 layers, compressed files are decompressed layer by layer
+        std::vector<Image_Data> pixel_layers;
+
+        for (auto& texture : textures)
         {
-            //Load image data from given paths, rgba format is assumed
-            stbi_uc* pixels = stbi_load(texture_path.string().c_str(), &texture_width, &texture_height, &texture_channels, STBI_rgb_alpha);
-            texture_widths.push_back(texture_width);
-            texture_heights.push_back(texture_height);
+            if (!texture.compressed)
+            {
+                pixel_layers.push_back(std::move(texture));
+                continue;
+            }
 
-            if (!pixels)
+            for (uint32_t layer = 0; layer < texture.compressed->layer_count; layer++)
             {
-                throw std::runtime_error("Failed to load texture image! Path was: " + texture_path.string());
+                pixel_layers.push_back(decompress_texture(*texture.compressed, layer));
             }
+        }
+
+        textures.clear();
+
+        std::vector<uint32_t> texture_widths{};
+        std::vector<uint32_t> texture_heights{};
 
-            pixel_layers.push_back(pixels);
+        for (const auto& pixel_layer : pixel_layers)
+        {
+            texture_widths.push_back(pixel_layer.width);
+            texture_heights.push_back(pixel_layer.height);
         }
 
         if (std::ranges::adjacent_find(texture_widths, std::ranges::not_equal_to()) != texture_widths.end() ||
@@ -417,23 +674,24 @@ namespace vulvox
         {
             VkDeviceSize layer_size = texture_widths[i] * texture_heights[i] * 4; //RGBA8 assumed
 
-            memcpy((unsigned char*)staging_buffer.allocation_info.pMappedData + (i * layer_size), pixel_layers[i], layer_size);
+            memcpy((unsigned char*)staging_buffer.allocation_info.pMappedData + (i * layer_size), pixel_layers[i].pixels.get(), layer_size);
         }
 
         //Image in staging buffer, we can free the image data
-        for (auto& pixels : pixel_layers)
-        {
-            stbi_image_free(pixels);
-        }
-
         pixel_layers.clear();
 
+        uint32_t mip_level_count = get_mip_level_count(vulkan_instance, max_width, max_height, VK_FORMAT_R8G8B8A8_SRGB);
+
         Image layered_texture_image;
         layered_texture_image.create_image(&vulkan_instance, max_width, max_height, layer_count,
             VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL,
-            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
             VK_IMAGE_ASPECT_COLOR_BIT,
-            VMA_MEMORY_USAGE_AUTO);
+            VMA_MEMORY_USAGE_AUTO,
+            mip_level_count);
+
+        //The transitions and the copy are submitted together (with the other uploads when the caller opened a batch)
+        command_pool.begin_upload_batch();
 
         //Change layout of target image memory to be optimal for writing destination
         layered_texture_image.transition_image_layout(command_pool, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
@@ -441,10 +699,18 @@ namespace vulvox
         //Transfer the image data from the staging buffer to the image memory
         copy_buffer_to_image_array(command_pool, staging_buffer.buffer, layered_texture_image.image, layered_texture_image.width, layered_texture_image.height, layered_texture_image.layer_count, max_layer_size);
 
-        //Change layout of image memory to be optimal for reading by a shader
-        layered_texture_image.transition_image_layout(command_pool, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        //Fill the lower mip levels of every layer, this leaves every level optimal for reading by a shader
+        if (layered_texture_image.mip_levels > 1)
+        {
+            layered_texture_image.generate_mipmaps(command_pool);
+        }
+        else
+        {
+            layered_texture_image.transition_image_layout(command_pool, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        }
 
-        staging_buffer.destroy(vulkan_instance.allocator);
+        command_pool.release_staging_buffer(staging_buffer);
+        command_pool.end_upload_batch();
 
         layered_texture_image.create_image_array_view();
         layered_texture_image.create_texture_sampler();
@@ -452,4 +718,74 @@ namespace vulvox
         return layered_texture_image;
     }
 
+    Image Image::create_compressed_texture_image(Vulkan_Instance& vulkan_instance, Vulkan_Command_Pool& command_pool, const Compressed_Image_Data& image_data, const bool texture_array)
+    {
+        VULVOX_PROFILE_SCOPE("Image::create_compressed_texture_image");
+
+        uint32_t layer_count = texture_array ? image_data.layer_count : 1;
+
+        std::vector<VkBufferImageCopy> regions;
+        std::ranges::copy_if(image_data.regions, std::back_inserter(regions), [layer_count](const VkBufferImageCopy& region) { return region.imageSubresource.baseArrayLayer < layer_count; });
+
+        //Setup host visible staging buffer, the blocks go in without any conversion
+        Buffer staging_buffer;
+        staging_buffer.create(vulkan_instance, image_data.blocks.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+
+        memcpy(staging_buffer.allocation_info.pMappedData, image_data.blocks.data(), image_data.blocks.size());
+
+        Image texture_image;
+        texture_image.create_image(&vulkan_instance, image_data.width, image_data.height, layer_count,
+            image_data.format, VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            VMA_MEMORY_USAGE_AUTO,
+            image_data.mip_levels);
+
+        //The transitions and the copy are submitted together (with the other uploads when the caller opened a batch)
+        command_pool.begin_upload_batch();
+
+        texture_image.transition_image_layout(command_pool, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+        //Every mip level and layer in a single copy command
+        copy_buffer_to_image_regions(command_pool, staging_buffer.buffer, texture_image.image, regions);
+
+        texture_image.transition_image_layout(command_pool, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+        command_pool.release_staging_buffer(staging_buffer);
+        command_pool.end_upload_batch();
+
+        if (texture_array)
+        {
+            texture_image.create_image_array_view();
+        }
+        else
+        {
+            texture_image.create_image_view();
+        }
+
+        texture_image.create_texture_sampler();
+
+        return texture_image;
+    }
+
+    Image_Data Image::decompress_texture(const Compressed_Image_Data& image_data, const uint32_t layer)
+    {
+        Image_Data decompressed_data{};
+        decompressed_data.width = image_data.width;
+        decompressed_data.height = image_data.height;
+
+        //Not allocated by stb_image, so the pixels get their own deleter
+        size_t pixel_size = static_cast<size_t>(image_data.width) * image_data.height * 4;
+        decompressed_data.pixels = decltype(decompressed_data.pixels)(static_cast<stbi_uc*>(malloc(pixel_size)), &free);
+
+        if (!decompressed_data.pixels)
+        {
+            throw std::runtime_error("Failed to allocate decompressed texture pixels!");
+        }
+
+        Texture_File::decompress(image_data, layer, decompressed_data.pixels.get());
+
+        return decompressed_data;
+    }
 }
\ No newline at end of file
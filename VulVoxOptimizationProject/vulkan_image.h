@@ -2,6 +2,19 @@
 
 namespace vulvox
 {
+    /// <summary>
+    /// Decoded RGBA8 pixels of a texture file, no GPU resources involved so it can be created on a worker thread.
+    /// KTX2 and DDS files are not decoded, their blocks are kept in compressed and pixels stays empty.
+    /// </summary>
+    struct Image_Data
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> pixels{ nullptr, &stbi_image_free };
+
+        std::optional<Compressed_Image_Data> compressed;
+    };
+
     class Image
     {
     public:
@@ -11,12 +24,12 @@ namespace vulvox
         /// <summary>
         /// Constructor for a single layered image.
         /// </summary>
-        void create_image(Vulkan_Instance* vulkan_instance, uint32_t image_width, uint32_t image_height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkImageAspectFlags aspect_flags, VmaMemoryUsage memory_usage);
+        void create_image(Vulkan_Instance* vulkan_instance, uint32_t image_width, uint32_t image_height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkImageAspectFlags aspect_flags, VmaMemoryUsage memory_usage, uint32_t mip_level_count = 1);
 
         /// <summary>
         /// Constructor for an image array.
         /// </summary>
-        void create_image(Vulkan_Instance* vulkan_instance, uint32_t image_width, uint32_t image_height, uint32_t array_layers, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkImageAspectFlags aspect_flags, VmaMemoryUsage memory_usage);
+        void create_image(Vulkan_Instance* vulkan_instance, uint32_t image_width, uint32_t image_height, uint32_t array_layers, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkImageAspectFlags aspect_flags, VmaMemoryUsage memory_usage, uint32_t mip_level_count = 1);
 
 
         /// <summary>
@@ -34,34 +47,74 @@ namespace vulvox
 
         void transition_image_layout(Vulkan_Command_Pool& command_pool, VkImageLayout new_layout);
 
+        /// <summary>
+        /// Fills mip levels 1..n of every layer by repeatedly downsampling the previous level with vkCmdBlitImage, part of the current upload batch.
+        /// Level 0 has to be in the transfer dst layout (after the copy), all levels end in the shader read layout.
+        /// Blits need the graphics queue, so with a dedicated transfer queue the image is handed over before the blits.
+        /// </summary>
+        void generate_mipmaps(Vulkan_Command_Pool& command_pool);
+
+        /// <summary>
+        /// Full mip chain length for the size, 1 when the format can't be linearly filtered by a blit.
+        /// </summary>
+        static uint32_t get_mip_level_count(const Vulkan_Instance& vulkan_instance, uint32_t image_width, uint32_t image_height, VkFormat format);
+
 
         void destroy();
 
         static void copy_buffer_to_image(Vulkan_Command_Pool& command_pool, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
         static void copy_buffer_to_image_array(Vulkan_Command_Pool& command_pool, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, uint32_t layer_count, VkDeviceSize layer_size);
+        static void copy_buffer_to_image_regions(Vulkan_Command_Pool& command_pool, VkBuffer buffer, VkImage image, std::span<const VkBufferImageCopy> regions);
 
         static Image create_texture_image(Vulkan_Instance& vulkan_instance, Vulkan_Command_Pool& command_pool, const std::filesystem::path& texture_path);
+
+        /// <summary>
+        /// Uploads previously decoded pixels, only this step needs the render thread.
+        /// </summary>
+        static Image create_texture_image(Vulkan_Instance& vulkan_instance, Vulkan_Command_Pool& command_pool, const Image_Data& image_data);
+
+        /// <summary>
+        /// Decodes the texture file to RGBA8, KTX2 and DDS files are only read, thread safe.
+        /// </summary>
+        static Image_Data decode_texture(const std::filesystem::path& texture_path);
+
+        /// <summary>
+        /// Creates a texture array with a layer per path, the layers of KTX2 and DDS files are added in order.
+        /// Block compressed files are uploaded as is when they share format, size and mip count, otherwise all layers are RGBA8.
+        /// </summary>
         static Image create_texture_array_image(Vulkan_Instance& vulkan_instance, Vulkan_Command_Pool& command_pool, const std::vector<std::filesystem::path>& texture_paths);
 
-        VkImage image;
-        VmaAllocation allocation;
+        /// <summary>
+        /// Copies all mip levels of a block compressed texture (only the first layer unless texture_array is set) without decoding them.
+        /// Mip levels missing from the file are not generated, blits can't write block compressed formats.
+        /// Only call when the device supports the format.
+        /// </summary>
+        static Image create_compressed_texture_image(Vulkan_Instance& vulkan_instance, Vulkan_Command_Pool& command_pool, const Compressed_Image_Data& image_data, const bool texture_array);
+
+        VkImage image = VK_NULL_HANDLE;
+        VmaAllocation allocation = VK_NULL_HANDLE;
         VmaAllocationInfo allocation_info;
 
         VkImageLayout current_layout;
-        VkImageView image_view;
+        VkImageView image_view = VK_NULL_HANDLE;
 
         uint32_t width;
         uint32_t height;
         uint32_t layer_count = 1;
+        uint32_t mip_levels = 1;
 
         VkFormat format;
         VkImageAspectFlags aspect_flags;
 
-        VkSampler sampler;
+        //Only textures have a sampler, render targets leave this empty
+        VkSampler sampler = VK_NULL_HANDLE;
 
     private:
 
-        Vulkan_Instance* vulkan_instance;
+        //Fallback for devices without BC support, decodes the first mip level of a layer to RGBA8
+        static Image_Data decompress_texture(const Compressed_Image_Data& image_data, const uint32_t layer);
+
+        Vulkan_Instance* vulkan_instance = nullptr;
 
 
     };
@@ -21,21 +21,27 @@ namespace vulvox
         app_info.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
         app_info.pEngineName = "VulVox";
         app_info.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-        app_info.apiVersion = VK_API_VERSION_1_0;
+        //Vulkan 1.1 is only used to query the optional descriptor indexing features (vkGetPhysicalDeviceFeatures2)
+        instance_api_version = api_version_support >= VK_API_VERSION_1_1 ? VK_API_VERSION_1_1 : VK_API_VERSION_1_0;
+        app_info.apiVersion = instance_api_version;
 
         VkInstanceCreateInfo create_info{};
         create_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
         create_info.pApplicationInfo = &app_info;
 
-        //GLFW needs support for window surface creation, we check that here
-        uint32_t glfw_extension_count = 0;
-        const char** glfw_extensions;
-        glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_extension_count);
-
         std::vector<const char*> requiredExtensions;
 
-        for (uint32_t i = 0; i < glfw_extension_count; i++) {
-            requiredExtensions.emplace_back(glfw_extensions[i]);
+        //GLFW needs support for window surface creation, we check that here
+        //In headless mode we never create a surface, so we don't need the window system extensions
+        if (!headless)
+        {
+            uint32_t glfw_extension_count = 0;
+            const char** glfw_extensions;
+            glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_extension_count);
+
+            for (uint32_t i = 0; i < glfw_extension_count; i++) {
+                requiredExtensions.emplace_back(glfw_extensions[i]);
+            }
         }
 
 
@@ -58,7 +64,7 @@ namespace vulvox
             create_info.enabledLayerCount = 0;
         }
 
-        if (!check_glfw_extension_support())
+        if (!headless && !check_glfw_extension_support())
         {
             throw std::runtime_error("Not all glfw extensions are supported!");
         }
@@ -165,8 +171,9 @@ namespace vulvox
 
         bool extensions_supported = check_device_extension_support(physical_device_candidate);
 
-        bool swap_chain_adequate = false;
-        if (extensions_supported)
+        //Headless rendering doesn't present, so any device will do
+        bool swap_chain_adequate = headless;
+        if (extensions_supported && !headless)
         {
             Swap_Chain_Support_Details swap_chain_support = query_swap_chain_support(surface, physical_device_candidate);
             swap_chain_adequate = !swap_chain_support.formats.empty() && !swap_chain_support.present_modes.empty();
@@ -244,7 +251,8 @@ namespace vulvox
         std::vector<VkExtensionProperties> available_extensions(extension_count);
         vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, available_extensions.data());
 
-        std::set<std::string, std::less<>> required_extensions(device_extensions.begin(), device_extensions.end());
+        std::vector<const char*> required_device_extensions = get_required_device_extensions();
+        std::set<std::string, std::less<>> required_extensions(required_device_extensions.begin(), required_device_extensions.end());
 
         for (const auto& extension : available_extensions)
         {
@@ -341,8 +349,16 @@ namespace vulvox
             }
 
             //Check if this device supports window system integration (a.k.a. presentation)
+            //Without a surface (headless) nothing is presented, so we let the graphics queue fill the present role
             VkBool32 present_support = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(physical_device, i, surface, &present_support);
+            if (surface != VK_NULL_HANDLE)
+            {
+                vkGetPhysicalDeviceSurfaceSupportKHR(physical_device, i, surface, &present_support);
+            }
+            else
+            {
+                present_support = (queue_family.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
+            }
 
             if (present_support)
             {
@@ -358,6 +374,18 @@ namespace vulvox
             i++;
         }
 
+        //A family that can only transfer maps to the copy engine of the GPU, copies there run in parallel with rendering
+        for (uint32_t family = 0; family < queue_family_count; family++)
+        {
+            VkQueueFlags queue_flags = queue_families[family].queueFlags;
+
+            if ((queue_flags & VK_QUEUE_TRANSFER_BIT) && !(queue_flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+            {
+                indices.transfer_family = family;
+                break;
+            }
+        }
+
         return indices;
     }
 
@@ -376,6 +404,11 @@ namespace vulvox
         std::vector<VkDeviceQueueCreateInfo> queue_create_infos;
         std::set<uint32_t> unique_queue_families = { indices.graphics_family.value(), indices.present_family.value() };
 
+        if (indices.transfer_family.has_value())
+        {
+            unique_queue_families.insert(indices.transfer_family.value());
+        }
+
         //Set queue priority, higher values have higher priority
         float queue_priority = 1.0f;
 
@@ -394,6 +427,32 @@ namespace vulvox
         VkPhysicalDeviceFeatures device_features{};
         device_features.samplerAnisotropy = VK_TRUE; //Device needs to support anisotropic filtering
 
+        //Optional, multiple indirect draws per call with a first instance each, used by draw_batch
+        VkPhysicalDeviceFeatures supported_features{};
+        vkGetPhysicalDeviceFeatures(physical_device, &supported_features);
+
+        multi_draw_indirect = supported_features.multiDrawIndirect && supported_features.drawIndirectFirstInstance;
+        device_features.multiDrawIndirect = multi_draw_indirect ? VK_TRUE : VK_FALSE;
+        device_features.drawIndirectFirstInstance = multi_draw_indirect ? VK_TRUE : VK_FALSE;
+
+        //Optional, block compressed textures from KTX2/DDS files, without it they are decompressed to RGBA8 on load
+        texture_compression_bc = supported_features.textureCompressionBC;
+        device_features.textureCompressionBC = texture_compression_bc ? VK_TRUE : VK_FALSE;
+
+        //Optional, partially bound and update after bind sampler arrays for the bindless texture table
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptor_indexing_features{};
+        descriptor_indexing_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+        descriptor_indexing = check_descriptor_indexing_support(physical_device);
+
+        if (descriptor_indexing)
+        {
+            descriptor_indexing_features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+            descriptor_indexing_features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+            descriptor_indexing_features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+            descriptor_indexing_features.descriptorBindingPartiallyBound = VK_TRUE;
+            descriptor_indexing_features.runtimeDescriptorArray = VK_TRUE;
+        }
+
         VkDeviceCreateInfo create_info{};
         create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 
@@ -403,8 +462,16 @@ namespace vulvox
 
         create_info.pEnabledFeatures = &device_features;
 
-        create_info.enabledExtensionCount = static_cast<uint32_t>(device_extensions.size());
-        create_info.ppEnabledExtensionNames = device_extensions.data();
+        std::vector<const char*> required_device_extensions = get_required_device_extensions();
+
+        if (descriptor_indexing)
+        {
+            required_device_extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+            create_info.pNext = &descriptor_indexing_features;
+        }
+
+        create_info.enabledExtensionCount = static_cast<uint32_t>(required_device_extensions.size());
+        create_info.ppEnabledExtensionNames = required_device_extensions.data();
 
         if (enableValidationLayers)
         {
@@ -428,6 +495,11 @@ namespace vulvox
         vkGetDeviceQueue(device, indices.graphics_family.value(), 0, &graphics_queue);
 
         vkGetDeviceQueue(device, indices.present_family.value(), 0, &present_queue);
+
+        if (indices.transfer_family.has_value())
+        {
+            vkGetDeviceQueue(device, indices.transfer_family.value(), 0, &transfer_queue);
+        }
     }
 
     /// <summary>
@@ -498,8 +570,19 @@ namespace vulvox
         return std::string(std::to_string(major) + "." + std::to_string(minor));
     }
 
-    void Vulkan_Instance::init_instance()
+    std::vector<const char*> Vulkan_Instance::get_required_device_extensions() const
     {
+        if (headless)
+        {
+            return {};
+        }
+
+        return device_extensions;
+    }
+
+    void Vulkan_Instance::init_instance(const bool headless_mode)
+    {
+        headless = headless_mode;
         create_instance();
     }
 
@@ -543,7 +626,11 @@ namespace vulvox
 
     void Vulkan_Instance::cleanup_surface()
     {
-        vkDestroySurfaceKHR(instance, surface, nullptr);
+        if (surface != VK_NULL_HANDLE)
+        {
+            vkDestroySurfaceKHR(instance, surface, nullptr);
+            surface = VK_NULL_HANDLE;
+        }
     }
 
 
@@ -578,6 +665,97 @@ namespace vulvox
         return memory_properties;
     }
 
+    bool Vulkan_Instance::is_headless() const
+    {
+        return headless;
+    }
+
+    bool Vulkan_Instance::supports_multi_draw_indirect() const
+    {
+        return multi_draw_indirect;
+    }
+
+    bool Vulkan_Instance::supports_descriptor_indexing() const
+    {
+        return descriptor_indexing;
+    }
+
+    bool Vulkan_Instance::has_dedicated_transfer_queue() const
+    {
+        return transfer_queue != VK_NULL_HANDLE;
+    }
+
+    bool Vulkan_Instance::supports_compressed_format(const VkFormat format) const
+    {
+        if (!texture_compression_bc)
+        {
+            return false;
+        }
+
+        VkFormatProperties format_properties;
+        vkGetPhysicalDeviceFormatProperties(physical_device, format, &format_properties);
+
+        return (format_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+    }
+
+    bool Vulkan_Instance::check_descriptor_indexing_support(const VkPhysicalDevice& physical_device) const
+    {
+        //The feature query needs Vulkan 1.1 on both the instance and the device, which also covers the maintenance3 dependency of the extension
+        VkPhysicalDeviceProperties device_properties;
+        vkGetPhysicalDeviceProperties(physical_device, &device_properties);
+
+        if (instance_api_version < VK_API_VERSION_1_1 || device_properties.apiVersion < VK_API_VERSION_1_1)
+        {
+            return false;
+        }
+
+        uint32_t extension_count;
+        vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, nullptr);
+
+        std::vector<VkExtensionProperties> available_extensions(extension_count);
+        vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, available_extensions.data());
+
+        bool extension_available = std::any_of(available_extensions.begin(), available_extensions.end(),
+            [](const VkExtensionProperties& extension) { return strcmp(extension.extensionName, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) == 0; });
+
+        if (!extension_available)
+        {
+            return false;
+        }
+
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptor_indexing_features{};
+        descriptor_indexing_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+        VkPhysicalDeviceFeatures2 features{};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &descriptor_indexing_features;
+
+        vkGetPhysicalDeviceFeatures2(physical_device, &features);
+
+        return descriptor_indexing_features.shaderSampledImageArrayNonUniformIndexing
+            && descriptor_indexing_features.descriptorBindingSampledImageUpdateAfterBind
+            && descriptor_indexing_features.descriptorBindingUpdateUnusedWhilePending
+            && descriptor_indexing_features.descriptorBindingPartiallyBound
+            && descriptor_indexing_features.runtimeDescriptorArray;
+    }
+
+    uint32_t Vulkan_Instance::get_max_update_after_bind_samplers() const
+    {
+        VkPhysicalDeviceDescriptorIndexingPropertiesEXT descriptor_indexing_properties{};
+        descriptor_indexing_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+
+        VkPhysicalDeviceProperties2 properties{};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties.pNext = &descriptor_indexing_properties;
+
+        vkGetPhysicalDeviceProperties2(physical_device, &properties);
+
+        return std::min({ descriptor_indexing_properties.maxPerStageDescriptorUpdateAfterBindSamplers,
+            descriptor_indexing_properties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+            descriptor_indexing_properties.maxDescriptorSetUpdateAfterBindSamplers,
+            descriptor_indexing_properties.maxDescriptorSetUpdateAfterBindSampledImages });
+    }
+
     Swap_Chain_Support_Details Vulkan_Instance::query_swap_chain_support(const VkSurfaceKHR surface) const
     {
         return query_swap_chain_support(surface, physical_device);
@@ -12,6 +12,9 @@ namespace vulvox
         std::optional<uint32_t> graphics_family;
         std::optional<uint32_t> present_family;
 
+        //Optional, a transfer only family (dedicated copy engine), not required for completeness
+        std::optional<uint32_t> transfer_family;
+
         /// <summary>
         /// Check if all queue families are filled.
         /// </summary>
@@ -32,7 +35,11 @@ namespace vulvox
 
         Vulkan_Instance() = default;
 
-        void init_instance();
+        /// <summary>
+        /// Creates the vulkan instance.
+        /// In headless mode no window system extensions are requested and no surface or swap chain support is required from the device.
+        /// </summary>
+        void init_instance(const bool headless_mode = false);
         void init_surface(GLFWwindow* window);
         void init_device();
         void init_allocator();
@@ -51,6 +58,33 @@ namespace vulvox
         Swap_Chain_Support_Details query_swap_chain_support(const VkSurfaceKHR surface) const;
         Queue_Family_Indices get_queue_families(const VkSurfaceKHR surface) const;
 
+        bool is_headless() const;
+
+        /// <summary>
+        /// True when the device was created with the multiDrawIndirect and drawIndirectFirstInstance features.
+        /// </summary>
+        bool supports_multi_draw_indirect() const;
+
+        /// <summary>
+        /// True when the device was created with VK_EXT_descriptor_indexing and the features the bindless texture table needs.
+        /// </summary>
+        bool supports_descriptor_indexing() const;
+
+        /// <summary>
+        /// Largest update after bind sampler array a single shader stage can use, only call when descriptor indexing is supported.
+        /// </summary>
+        uint32_t get_max_update_after_bind_samplers() const;
+
+        /// <summary>
+        /// True when the device has a transfer only queue family, uploads then run on transfer_queue next to the graphics work.
+        /// </summary>
+        bool has_dedicated_transfer_queue() const;
+
+        /// <summary>
+        /// True when the device was created with textureCompressionBC and can sample the (BC) format with optimal tiling.
+        /// </summary>
+        bool supports_compressed_format(const VkFormat format) const;
+
         VkFormat find_depth_format();
 
         VkFormat find_supported_format(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
@@ -71,6 +105,7 @@ namespace vulvox
         //Queues that send commands to the command buffers
         VkQueue graphics_queue = VK_NULL_HANDLE;
         VkQueue present_queue = VK_NULL_HANDLE;
+        VkQueue transfer_queue = VK_NULL_HANDLE; //Only set with a dedicated transfer queue family
 
     private:
 
@@ -83,6 +118,7 @@ namespace vulvox
         bool check_glfw_extension_support() const;
         bool check_device_extension_support(const VkPhysicalDevice& physical_device) const;
         bool check_validation_layer_support() const;
+        bool check_descriptor_indexing_support(const VkPhysicalDevice& physical_device) const;
 
         Swap_Chain_Support_Details query_swap_chain_support(const VkSurfaceKHR surface, const VkPhysicalDevice& physical_device) const;
 
@@ -95,6 +131,18 @@ namespace vulvox
         std::string get_physical_device_type(const VkPhysicalDevice& physical_device) const;
         std::string get_physical_device_vulkan_support(const VkPhysicalDevice& physical_device) const;
 
+        //Returns the device extensions required for the current mode (no swap chain extension in headless mode)
+        std::vector<const char*> get_required_device_extensions() const;
+
+        //Headless instances render offscreen only, so they don't need a surface or window system extensions
+        bool headless = false;
+
+        bool multi_draw_indirect = false;
+        bool descriptor_indexing = false;
+        bool texture_compression_bc = false;
+
+        uint32_t instance_api_version = VK_API_VERSION_1_0;
+
         //Required device extensions
         const std::vector<const char*> device_extensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
         const std::vector<const char*> validation_layers = { "VK_LAYER_KHRONOS_validation" };
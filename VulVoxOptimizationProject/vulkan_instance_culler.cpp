@@ -0,0 +1,235 @@
+#include "pch.h"
+#include "vulkan_instance_culler.h"
+
+namespace vulvox
+{
+    namespace
+    {
+        //Input instances, input texture indices, output instances, output texture indices, draw command
+        constexpr uint32_t CULL_BINDING_COUNT = 5;
+
+        //Matches local_size_x in instance_cull.comp
+        constexpr uint32_t CULL_WORKGROUP_SIZE = 64;
+    }
+
+    void Vulkan_Instance_Culler::init(Vulkan_Instance* vulkan_instance, const uint32_t frames_in_flight, const std::filesystem::path& shader_path, const uint32_t max_dispatches_per_frame)
+    {
+        this->vulkan_instance = vulkan_instance;
+
+        //The compute shader is optional, without it draws are never culled
+        if (!std::filesystem::exists(shader_path))
+        {
+            std::cout << "Shader file " << shader_path.filename() << " not found, GPU culling is not available." << std::endl;
+            return;
+        }
+
+        create_descriptor_set_layout();
+        create_pipeline(shader_path);
+
+        VkDescriptorPoolSize pool_size{};
+        pool_size.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        pool_size.descriptorCount = max_dispatches_per_frame * CULL_BINDING_COUNT;
+
+        VkDescriptorPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        pool_info.poolSizeCount = 1;
+        pool_info.pPoolSizes = &pool_size;
+        pool_info.maxSets = max_dispatches_per_frame;
+
+        descriptor_pools.resize(frames_in_flight);
+
+        for (auto& descriptor_pool : descriptor_pools)
+        {
+            if (vkCreateDescriptorPool(vulkan_instance->device, &pool_info, nullptr, &descriptor_pool) != VK_SUCCESS)
+            {
+                throw std::runtime_error("Failed to create culling descriptor pool!");
+            }
+        }
+
+        supported = true;
+    }
+
+    void Vulkan_Instance_Culler::destroy()
+    {
+        if (vulkan_instance == nullptr)
+        {
+            return;
+        }
+
+        for (auto& descriptor_pool : descriptor_pools)
+        {
+            vkDestroyDescriptorPool(vulkan_instance->device, descriptor_pool, nullptr);
+        }
+        descriptor_pools.clear();
+
+        vkDestroyPipeline(vulkan_instance->device, pipeline, nullptr);
+        vkDestroyPipelineLayout(vulkan_instance->device, pipeline_layout, nullptr);
+        vkDestroyDescriptorSetLayout(vulkan_instance->device, descriptor_set_layout, nullptr);
+
+        pipeline = VK_NULL_HANDLE;
+        pipeline_layout = VK_NULL_HANDLE;
+        descriptor_set_layout = VK_NULL_HANDLE;
+
+        supported = false;
+        enabled = false;
+    }
+
+    bool Vulkan_Instance_Culler::is_supported() const
+    {
+        return supported;
+    }
+
+    void Vulkan_Instance_Culler::set_enabled(const bool enable)
+    {
+        if (enable && !supported)
+        {
+            std::cout << "GPU culling is not supported, the culling shader was not loaded." << std::endl;
+            return;
+        }
+
+        enabled = enable;
+    }
+
+    bool Vulkan_Instance_Culler::is_enabled() const
+    {
+        return enabled;
+    }
+
+    void Vulkan_Instance_Culler::begin_frame(const uint32_t frame, const std::array<glm::vec4, 6>& frustum_planes)
+    {
+        current_frame = frame;
+        this->frustum_planes = frustum_planes;
+        reported_out_of_sets = false;
+
+        if (!supported)
+        {
+            return;
+        }
+
+        vkResetDescriptorPool(vulkan_instance->device, descriptor_pools[current_frame], 0);
+    }
+
+    bool Vulkan_Instance_Culler::record_cull(VkCommandBuffer command_buffer, const glm::vec4& bounding_sphere, const uint32_t instance_count,
+        const Buffer_Allocation& instances, const Buffer_Allocation* texture_indices,
+        const Buffer_Allocation& output_instances, const Buffer_Allocation* output_texture_indices,
+        const Buffer_Allocation& draw_command)
+    {
+        VkDescriptorSetAllocateInfo allocate_info{};
+        allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocate_info.descriptorPool = descriptor_pools[current_frame];
+        allocate_info.descriptorSetCount = 1;
+        allocate_info.pSetLayouts = &descriptor_set_layout;
+
+        VkDescriptorSet descriptor_set;
+        if (vkAllocateDescriptorSets(vulkan_instance->device, &allocate_info, &descriptor_set) != VK_SUCCESS)
+        {
+            if (!reported_out_of_sets)
+            {
+                std::cout << "Out of culling descriptor sets this frame, remaining instanced draws are not culled." << std::endl;
+                reported_out_of_sets = true;
+            }
+            return false;
+        }
+
+        //Without texture indices the instance buffers are bound in their place, the shader doesn't access them
+        std::array<const Buffer_Allocation*, CULL_BINDING_COUNT> bindings =
+        {
+            &instances,
+            texture_indices != nullptr ? texture_indices : &instances,
+            &output_instances,
+            output_texture_indices != nullptr ? output_texture_indices : &output_instances,
+            &draw_command
+        };
+
+        std::array<VkDescriptorBufferInfo, CULL_BINDING_COUNT> buffer_infos{};
+        std::array<VkWriteDescriptorSet, CULL_BINDING_COUNT> descriptor_writes{};
+
+        for (uint32_t i = 0; i < CULL_BINDING_COUNT; i++)
+        {
+            buffer_infos[i].buffer = bindings[i]->buffer;
+            buffer_infos[i].offset = bindings[i]->offset;
+            buffer_infos[i].range = bindings[i]->size;
+
+            descriptor_writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptor_writes[i].dstSet = descriptor_set;
+            descriptor_writes[i].dstBinding = i;
+            descriptor_writes[i].dstArrayElement = 0;
+            descriptor_writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            descriptor_writes[i].descriptorCount = 1;
+            descriptor_writes[i].pBufferInfo = &buffer_infos[i];
+        }
+
+        vkUpdateDescriptorSets(vulkan_instance->device, static_cast<uint32_t>(descriptor_writes.size()), descriptor_writes.data(), 0, nullptr);
+
+        Cull_Parameters parameters{};
+        std::copy(frustum_planes.begin(), frustum_planes.end(), parameters.frustum_planes);
+        parameters.bounding_sphere = bounding_sphere;
+        parameters.instance_count = instance_count;
+        parameters.has_texture_indices = texture_indices != nullptr ? 1 : 0;
+
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_layout, 0, 1, &descriptor_set, 0, nullptr);
+        vkCmdPushConstants(command_buffer, pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(Cull_Parameters), &parameters);
+
+        vkCmdDispatch(command_buffer, (instance_count + CULL_WORKGROUP_SIZE - 1) / CULL_WORKGROUP_SIZE, 1, 1);
+
+        return true;
+    }
+
+    void Vulkan_Instance_Culler::create_descriptor_set_layout()
+    {
+        std::array<VkDescriptorSetLayoutBinding, CULL_BINDING_COUNT> layout_bindings{};
+
+        for (uint32_t i = 0; i < CULL_BINDING_COUNT; i++)
+        {
+            layout_bindings[i].binding = i;
+            layout_bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            layout_bindings[i].descriptorCount = 1;
+            layout_bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            layout_bindings[i].pImmutableSamplers = nullptr;
+        }
+
+        VkDescriptorSetLayoutCreateInfo layout_info{};
+        layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layout_info.bindingCount = static_cast<uint32_t>(layout_bindings.size());
+        layout_info.pBindings = layout_bindings.data();
+
+        if (vkCreateDescriptorSetLayout(vulkan_instance->device, &layout_info, nullptr, &descriptor_set_layout) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create culling descriptor set layout!");
+        }
+    }
+
+    void Vulkan_Instance_Culler::create_pipeline(const std::filesystem::path& shader_path)
+    {
+        //Frustum, bounding sphere and instance count are small and change every draw, so pass them as push constants
+        VkPushConstantRange push_constant_range{};
+        push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        push_constant_range.offset = 0;
+        push_constant_range.size = sizeof(Cull_Parameters);
+
+        VkPipelineLayoutCreateInfo pipeline_layout_info{};
+        pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipeline_layout_info.setLayoutCount = 1;
+        pipeline_layout_info.pSetLayouts = &descriptor_set_layout;
+        pipeline_layout_info.pushConstantRangeCount = 1;
+        pipeline_layout_info.pPushConstantRanges = &push_constant_range;
+
+        if (vkCreatePipelineLayout(vulkan_instance->device, &pipeline_layout_info, nullptr, &pipeline_layout) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create culling pipeline layout!");
+        }
+
+        Vulkan_Shader cull_shader{ vulkan_instance->device, shader_path, "main", VK_SHADER_STAGE_COMPUTE_BIT };
+
+        VkComputePipelineCreateInfo pipeline_info{};
+        pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipeline_info.stage = cull_shader.get_shader_stage_create_info();
+        pipeline_info.layout = pipeline_layout;
+
+        if (vkCreateComputePipelines(vulkan_instance->device, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &pipeline) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create culling compute pipeline!");
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+namespace vulvox
+{
+    /// <summary>
+    /// Frustum culling of instanced draws in a compute shader.
+    /// Every visible instance is compacted into an output buffer and counted in a VkDrawIndexedIndirectCommand, the draw is then issued with vkCmdDrawIndexedIndirect.
+    /// The culling has to be recorded outside of the render pass, the engine records it in the upload command buffer that executes before the frame.
+    /// </summary>
+    class Vulkan_Instance_Culler
+    {
+    public:
+
+        Vulkan_Instance_Culler() = default;
+
+        void init(Vulkan_Instance* vulkan_instance, const uint32_t frames_in_flight, const std::filesystem::path& shader_path, const uint32_t max_dispatches_per_frame = 256);
+        void destroy();
+
+        /// <summary>
+        /// False if the compute shader could not be found at init.
+        /// </summary>
+        bool is_supported() const;
+
+        void set_enabled(const bool enable);
+        bool is_enabled() const;
+
+        /// <summary>
+        /// Releases the descriptor sets of the previous use of this frame slot and sets the frustum of the new frame.
+        /// Only call this after the fence of the frame has signaled.
+        /// </summary>
+        void begin_frame(const uint32_t frame, const std::array<glm::vec4, 6>& frustum_planes);
+
+        /// <summary>
+        /// Record the culling dispatch of a single draw, texture_indices and output_texture_indices are optional (nullptr).
+        /// The draw command has to be initialized with an instance count of 0, the shader increments it for every visible instance.
+        /// Returns false when the dispatch could not be recorded (out of descriptor sets this frame), draw without culling in that case.
+        /// </summary>
+        bool record_cull(VkCommandBuffer command_buffer, const glm::vec4& bounding_sphere, const uint32_t instance_count,
+            const Buffer_Allocation& instances, const Buffer_Allocation* texture_indices,
+            const Buffer_Allocation& output_instances, const Buffer_Allocation* output_texture_indices,
+            const Buffer_Allocation& draw_command);
+
+    private:
+
+        //Matches the push constant block of instance_cull.comp
+        struct Cull_Parameters
+        {
+            glm::vec4 frustum_planes[6];
+            glm::vec4 bounding_sphere; //xyz center, w radius
+            uint32_t instance_count;
+            uint32_t has_texture_indices;
+        };
+
+        void create_descriptor_set_layout();
+        void create_pipeline(const std::filesystem::path& shader_path);
+
+        Vulkan_Instance* vulkan_instance = nullptr;
+
+        VkDescriptorSetLayout descriptor_set_layout = VK_NULL_HANDLE;
+        VkPipelineLayout pipeline_layout = VK_NULL_HANDLE;
+        VkPipeline pipeline = VK_NULL_HANDLE;
+
+        //One pool per frame in flight, reset as a whole at the start of the frame
+        std::vector<VkDescriptorPool> descriptor_pools;
+        uint32_t current_frame = 0;
+        bool reported_out_of_sets = false;
+
+        std::array<glm::vec4, 6> frustum_planes{};
+
+        bool supported = false;
+        bool enabled = false;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "pch.h"
+#include "vulkan_linear_allocator.h"
+
+namespace vulvox
+{
+    void Vulkan_Linear_Allocator::init(Vulkan_Instance* vulkan_instance, const uint32_t frames_in_flight, const VkBufferUsageFlags usage, const VkDeviceSize initial_block_size, const VmaAllocationCreateFlags alloc_flags)
+    {
+        this->vulkan_instance = vulkan_instance;
+        this->usage = usage;
+        this->alloc_flags = alloc_flags;
+        this->initial_block_size = initial_block_size;
+
+        frames.resize(frames_in_flight);
+
+        for (auto& frame : frames)
+        {
+            frame.blocks.push_back(create_block(initial_block_size));
+        }
+    }
+
+    void Vulkan_Linear_Allocator::destroy()
+    {
+        for (auto& frame : frames)
+        {
+            for (auto& block : frame.blocks)
+            {
+                block.buffer.destroy(vulkan_instance->allocator);
+            }
+        }
+        frames.clear();
+    }
+
+    void Vulkan_Linear_Allocator::begin_frame(const uint32_t frame)
+    {
+        assert(frame < frames.size());
+        current_frame = frame;
+        allocated_bytes = 0;
+
+        Frame_Blocks& frame_blocks = frames[current_frame];
+
+        //The previous use of this frame overflowed into extra blocks, replace them with one block that fits everything
+        if (frame_blocks.blocks.size() > 1)
+        {
+            VULVOX_PROFILE_SCOPE("Vulkan_Linear_Allocator::merge_blocks");
+
+            for (auto& block : frame_blocks.blocks)
+            {
+                block.buffer.destroy(vulkan_instance->allocator);
+            }
+            frame_blocks.blocks.clear();
+
+            //Leave some headroom so small increases don't overflow again
+            VkDeviceSize merged_size = std::max(initial_block_size, frame_blocks.peak_usage + frame_blocks.peak_usage / 2);
+            frame_blocks.blocks.push_back(create_block(merged_size));
+        }
+
+        for (auto& block : frame_blocks.blocks)
+        {
+            block.used = 0;
+        }
+        frame_blocks.peak_usage = 0;
+    }
+
+    void Vulkan_Linear_Allocator::flush()
+    {
+        for (auto& block : frames[current_frame].blocks)
+        {
+            if (block.used > 0 && block.buffer.allocation_info.pMappedData != nullptr)
+            {
+                vmaFlushAllocation(vulkan_instance->allocator, block.buffer.allocation, 0, block.used);
+            }
+        }
+    }
+
+    Buffer_Allocation Vulkan_Linear_Allocator::allocate(const VkDeviceSize size, const VkDeviceSize alignment)
+    {
+        Frame_Blocks& frame_blocks = frames[current_frame];
+
+        Block* block = &frame_blocks.blocks.back();
+        VkDeviceSize offset = (block->used + alignment - 1) / alignment * alignment;
+
+        if (offset + size > block->buffer.size)
+        {
+            //Current block is full, older blocks stay alive until this frame slot is reused
+            VkDeviceSize block_size = std::max(block->buffer.size * 2, size);
+            frame_blocks.blocks.push_back(create_block(block_size));
+
+            block = &frame_blocks.blocks.back();
+            offset = 0;
+        }
+
+        block->used = offset + size;
+        allocated_bytes += size;
+        frame_blocks.peak_usage += size + alignment;
+
+        Buffer_Allocation allocation{};
+        allocation.buffer = block->buffer.buffer;
+        allocation.offset = offset;
+        allocation.size = size;
+        allocation.mapped_data = block->buffer.allocation_info.pMappedData != nullptr ? static_cast<uint8_t*>(block->buffer.allocation_info.pMappedData) + offset : nullptr;
+
+        return allocation;
+    }
+
+    VkDeviceSize Vulkan_Linear_Allocator::get_allocated_bytes() const
+    {
+        return allocated_bytes;
+    }
+
+    VkDeviceSize Vulkan_Linear_Allocator::get_capacity() const
+    {
+        VkDeviceSize capacity = 0;
+        for (const auto& frame : frames)
+        {
+            for (const auto& block : frame.blocks)
+            {
+                capacity += block.buffer.size;
+            }
+        }
+        return capacity;
+    }
+
+    Vulkan_Linear_Allocator::Block Vulkan_Linear_Allocator::create_block(const VkDeviceSize size)
+    {
+        VULVOX_PROFILE_SCOPE("Vulkan_Linear_Allocator::create_block");
+
+        //When mapped, the pointer stays valid for the lifetime of the block
+        Block block;
+        block.buffer.create(*vulkan_instance, size, usage, alloc_flags);
+
+        return block;
+    }
+}
\ No newline at end of file
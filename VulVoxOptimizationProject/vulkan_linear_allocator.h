@@ -0,0 +1,83 @@
+#pragma once
+
+namespace vulvox
+{
+    /// <summary>
+    /// Range of a buffer handed out by the linear allocator.
+    /// </summary>
+    struct Buffer_Allocation
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        void* mapped_data = nullptr; //Host pointer to the start of the range
+    };
+
+    /// <summary>
+    /// Per-frame linear (bump) allocator, on top of persistently mapped host visible buffers by default.
+    /// Every frame in flight owns its own blocks, allocations are only valid until that frame slot is started again.
+    /// When a block runs out of space mid-frame an extra block is created (the old one may still be referenced by recorded commands),
+    /// at the start of the next use of the frame slot all blocks are merged into a single block that fits the previous peak usage.
+    /// </summary>
+    class Vulkan_Linear_Allocator
+    {
+    public:
+
+        Vulkan_Linear_Allocator() = default;
+
+        /// <summary>
+        /// By default the blocks are host visible and persistently mapped, pass 0 as alloc_flags for device local blocks (mapped_data is nullptr).
+        /// </summary>
+        void init(Vulkan_Instance* vulkan_instance, const uint32_t frames_in_flight, const VkBufferUsageFlags usage, const VkDeviceSize initial_block_size,
+            const VmaAllocationCreateFlags alloc_flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+        void destroy();
+
+        /// <summary>
+        /// Start allocating from the blocks of the given frame, only call this after the frame's fence has signaled.
+        /// </summary>
+        void begin_frame(const uint32_t frame);
+
+        /// <summary>
+        /// Flush the written ranges so they are visible to the device (no-op on host coherent memory).
+        /// </summary>
+        void flush();
+
+        Buffer_Allocation allocate(const VkDeviceSize size, const VkDeviceSize alignment);
+
+        /// <summary>
+        /// Bytes allocated in the current frame.
+        /// </summary>
+        VkDeviceSize get_allocated_bytes() const;
+
+        /// <summary>
+        /// Total capacity of all blocks of all frames.
+        /// </summary>
+        VkDeviceSize get_capacity() const;
+
+    private:
+
+        struct Block
+        {
+            Buffer buffer;
+            VkDeviceSize used = 0;
+        };
+
+        struct Frame_Blocks
+        {
+            std::vector<Block> blocks;
+            VkDeviceSize peak_usage = 0;
+        };
+
+        Block create_block(const VkDeviceSize size);
+
+        Vulkan_Instance* vulkan_instance = nullptr;
+
+        VkBufferUsageFlags usage = 0;
+        VmaAllocationCreateFlags alloc_flags = 0;
+        VkDeviceSize initial_block_size = 0;
+
+        std::vector<Frame_Blocks> frames;
+        uint32_t current_frame = 0;
+        VkDeviceSize allocated_bytes = 0;
+    };
+}
\ No newline at end of file
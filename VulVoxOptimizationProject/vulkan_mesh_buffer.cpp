@@ -0,0 +1,173 @@
+#include "pch.h"
+#include "vulkan_mesh_buffer.h"
+
+namespace vulvox
+{
+    void Vulkan_Mesh_Buffer::init(Vulkan_Instance* vulkan_instance)
+    {
+        this->vulkan_instance = vulkan_instance;
+    }
+
+    void Vulkan_Mesh_Buffer::destroy()
+    {
+        for (auto& page : pages)
+        {
+            //Models that were not unloaded still own ranges, the whole block is released at once
+            vmaClearVirtualBlock(page.vertex_block);
+            vmaClearVirtualBlock(page.index_block);
+            vmaDestroyVirtualBlock(page.vertex_block);
+            vmaDestroyVirtualBlock(page.index_block);
+
+            page.vertex_buffer.destroy(vulkan_instance->allocator);
+            page.index_buffer.destroy(vulkan_instance->allocator);
+        }
+
+        pages.clear();
+    }
+
+    Mesh_Allocation Vulkan_Mesh_Buffer::allocate(Vulkan_Command_Pool& command_pool, std::span<const Vertex> vertices, std::span<const uint32_t> indices)
+    {
+        VULVOX_PROFILE_SCOPE("Vulkan_Mesh_Buffer::allocate");
+
+        //Virtual allocations can't be empty
+        VkDeviceSize vertex_count = std::max<VkDeviceSize>(vertices.size(), 1);
+        VkDeviceSize index_count = std::max<VkDeviceSize>(indices.size(), 1);
+
+        Mesh_Allocation allocation{};
+        bool allocated = false;
+
+        for (uint32_t i = 0; i < pages.size() && !allocated; i++)
+        {
+            allocated = allocate_in_page(i, vertex_count, index_count, allocation);
+        }
+
+        if (!allocated)
+        {
+            create_page(std::max(PAGE_VERTEX_CAPACITY, vertex_count), std::max(PAGE_INDEX_CAPACITY, index_count));
+
+            if (!allocate_in_page(static_cast<uint32_t>(pages.size() - 1), vertex_count, index_count, allocation))
+            {
+                throw std::runtime_error("Failed to allocate mesh in a new mesh buffer page!");
+            }
+        }
+
+        const Page& page = pages[allocation.page];
+
+        //Vertices and indices share a submit
+        command_pool.begin_upload_batch();
+
+        if (!vertices.empty())
+        {
+            upload(command_pool, vertices.data(), vertices.size_bytes(), page.vertex_buffer.buffer, static_cast<VkDeviceSize>(allocation.vertex_offset) * sizeof(Vertex));
+        }
+
+        if (!indices.empty())
+        {
+            upload(command_pool, indices.data(), indices.size_bytes(), page.index_buffer.buffer, static_cast<VkDeviceSize>(allocation.first_index) * sizeof(uint32_t));
+        }
+
+        command_pool.end_upload_batch();
+
+        return allocation;
+    }
+
+    void Vulkan_Mesh_Buffer::free(Mesh_Allocation& allocation)
+    {
+        if (allocation.page >= pages.size())
+        {
+            return;
+        }
+
+        vmaVirtualFree(pages[allocation.page].vertex_block, allocation.vertex_allocation);
+        vmaVirtualFree(pages[allocation.page].index_block, allocation.index_allocation);
+
+        allocation = Mesh_Allocation{};
+    }
+
+    VkBuffer Vulkan_Mesh_Buffer::get_vertex_buffer(const uint32_t page) const
+    {
+        return pages[page].vertex_buffer.buffer;
+    }
+
+    VkBuffer Vulkan_Mesh_Buffer::get_index_buffer(const uint32_t page) const
+    {
+        return pages[page].index_buffer.buffer;
+    }
+
+    void Vulkan_Mesh_Buffer::create_page(const VkDeviceSize vertex_capacity, const VkDeviceSize index_capacity)
+    {
+        Page page{};
+
+        //Device only buffers, filled with transfers from staging buffers
+        page.vertex_buffer.create(*vulkan_instance, vertex_capacity * sizeof(Vertex), VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, 0);
+        page.index_buffer.create(*vulkan_instance, index_capacity * sizeof(uint32_t), VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 0);
+
+        //Sizes and offsets of the virtual blocks count elements, so an offset is directly usable as vertex offset or first index
+        VmaVirtualBlockCreateInfo block_info{};
+        block_info.size = vertex_capacity;
+
+        if (vmaCreateVirtualBlock(&block_info, &page.vertex_block) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create mesh buffer vertex block!");
+        }
+
+        block_info.size = index_capacity;
+
+        if (vmaCreateVirtualBlock(&block_info, &page.index_block) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create mesh buffer index block!");
+        }
+
+        pages.push_back(page);
+    }
+
+    bool Vulkan_Mesh_Buffer::allocate_in_page(const uint32_t page_index, const VkDeviceSize vertex_count, const VkDeviceSize index_count, Mesh_Allocation& allocation)
+    {
+        Page& page = pages[page_index];
+
+        VmaVirtualAllocationCreateInfo allocation_info{};
+        allocation_info.size = vertex_count;
+
+        VkDeviceSize vertex_offset = 0;
+        VmaVirtualAllocation vertex_allocation = VK_NULL_HANDLE;
+
+        if (vmaVirtualAllocate(page.vertex_block, &allocation_info, &vertex_allocation, &vertex_offset) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        allocation_info.size = index_count;
+
+        VkDeviceSize first_index = 0;
+        VmaVirtualAllocation index_allocation = VK_NULL_HANDLE;
+
+        if (vmaVirtualAllocate(page.index_block, &allocation_info, &index_allocation, &first_index) != VK_SUCCESS)
+        {
+            vmaVirtualFree(page.vertex_block, vertex_allocation);
+            return false;
+        }
+
+        allocation.page = page_index;
+        allocation.vertex_offset = static_cast<int32_t>(vertex_offset);
+        allocation.first_index = static_cast<uint32_t>(first_index);
+        allocation.vertex_allocation = vertex_allocation;
+        allocation.index_allocation = index_allocation;
+
+        return true;
+    }
+
+    void Vulkan_Mesh_Buffer::upload(Vulkan_Command_Pool& command_pool, const void* data, const VkDeviceSize size, VkBuffer dst_buffer, const VkDeviceSize dst_offset)
+    {
+        //Create staging buffer that transfers data between the host and device
+        Buffer staging_buffer;
+        staging_buffer.create(*vulkan_instance, size,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+
+        memcpy(staging_buffer.allocation_info.pMappedData, data, size);
+
+        command_pool.copy_buffer(staging_buffer.buffer, dst_buffer, size, dst_offset);
+
+        //Destroyed once the copy is done, which is at the end of the upload batch when one is open
+        command_pool.release_staging_buffer(staging_buffer);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+namespace vulvox
+{
+    /// <summary>
+    /// Range of a model in the shared vertex and index buffers of a mesh buffer page.
+    /// </summary>
+    struct Mesh_Allocation
+    {
+        uint32_t page = UINT32_MAX;
+        uint32_t first_index = 0;
+        int32_t vertex_offset = 0;
+
+        VmaVirtualAllocation vertex_allocation = VK_NULL_HANDLE;
+        VmaVirtualAllocation index_allocation = VK_NULL_HANDLE;
+    };
+
+    /// <summary>
+    /// Shared (mega) vertex and index buffers that hold the geometry of all loaded models.
+    /// Models only differ in their first index and vertex offset, so draws of different models in the same page don't rebind any buffers
+    /// and can be combined into a single multi-draw indirect call.
+    /// The buffers are split in fixed size pages, a full page is never reallocated (recorded draws keep referencing it), a new page is added instead.
+    /// The ranges within a page are managed by VMA virtual blocks, measured in vertices and indices instead of bytes.
+    /// </summary>
+    class Vulkan_Mesh_Buffer
+    {
+    public:
+
+        Vulkan_Mesh_Buffer() = default;
+
+        void init(Vulkan_Instance* vulkan_instance);
+        void destroy();
+
+        /// <summary>
+        /// Uploads the geometry to the first page with enough free space, blocks until the copy is finished unless an upload batch is open.
+        /// </summary>
+        Mesh_Allocation allocate(Vulkan_Command_Pool& command_pool, std::span<const Vertex> vertices, std::span<const uint32_t> indices);
+
+        /// <summary>
+        /// Releases the range, the caller makes sure the GPU no longer reads it.
+        /// </summary>
+        void free(Mesh_Allocation& allocation);
+
+        VkBuffer get_vertex_buffer(const uint32_t page) const;
+        VkBuffer get_index_buffer(const uint32_t page) const;
+
+        //Default page size, a model that does not fit gets a page of its own size
+        static constexpr VkDeviceSize PAGE_VERTEX_CAPACITY = 1 << 20;
+        static constexpr VkDeviceSize PAGE_INDEX_CAPACITY = 1 << 22;
+
+    private:
+
+        struct Page
+        {
+            Buffer vertex_buffer;
+            Buffer index_buffer;
+
+            VmaVirtualBlock vertex_block = VK_NULL_HANDLE;
+            VmaVirtualBlock index_block = VK_NULL_HANDLE;
+        };
+
+        void create_page(const VkDeviceSize vertex_capacity, const VkDeviceSize index_capacity);
+
+        //Allocates both ranges in the page, returns false (without allocating) when one of them does not fit
+        bool allocate_in_page(const uint32_t page_index, const VkDeviceSize vertex_count, const VkDeviceSize index_count, Mesh_Allocation& allocation);
+
+        void upload(Vulkan_Command_Pool& command_pool, const void* data, const VkDeviceSize size, VkBuffer dst_buffer, const VkDeviceSize dst_offset);
+
+        Vulkan_Instance* vulkan_instance = nullptr;
+
+        std::vector<Page> pages;
+    };
+}
\ No newline at end of file
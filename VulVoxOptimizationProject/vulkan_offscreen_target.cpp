@@ -0,0 +1,52 @@
+#include "pch.h"
+#include "vulkan_offscreen_target.h"
+
+namespace vulvox
+{
+    Vulkan_Offscreen_Target::Vulkan_Offscreen_Target(Vulkan_Instance* vulkan_instance) : vulkan_instance(vulkan_instance)
+    {
+    }
+
+    void Vulkan_Offscreen_Target::create_targets(uint32_t width, uint32_t height, uint32_t image_count)
+    {
+        extent = { width, height };
+
+        std::cout << "Offscreen target format: " << string_VkFormat(image_format) << std::endl;
+        std::cout << "Image buffer extent: " << extent.width << " x " << extent.height << std::endl;
+        std::cout << std::endl;
+
+        images.resize(image_count);
+
+        for (auto& image : images)
+        {
+            //Color attachment that can also be the source of a copy, so rendered frames can be read back
+            image.create_image(
+                vulkan_instance,
+                extent.width, extent.height,
+                image_format,
+                VK_IMAGE_TILING_OPTIMAL,
+                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                VMA_MEMORY_USAGE_AUTO);
+
+            image.create_image_view();
+        }
+    }
+
+    void Vulkan_Offscreen_Target::cleanup_targets()
+    {
+        for (auto& framebuffer : framebuffers)
+        {
+            vkDestroyFramebuffer(vulkan_instance->device, framebuffer, nullptr);
+        }
+
+        framebuffers.clear();
+
+        for (auto& image : images)
+        {
+            image.destroy();
+        }
+
+        images.clear();
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+namespace vulvox
+{
+    /// <summary>
+    /// Ring of offscreen color images that replaces the swap chain when rendering headless.
+    /// Each frame in flight renders into its own image, so the images can be read back without stalling the next frame.
+    /// </summary>
+    class Vulkan_Offscreen_Target
+    {
+    public:
+
+        explicit Vulkan_Offscreen_Target(Vulkan_Instance* vulkan_instance);
+
+        void create_targets(uint32_t width, uint32_t height, uint32_t image_count);
+
+        void cleanup_targets();
+
+        VkFormat image_format = VK_FORMAT_R8G8B8A8_SRGB;
+        VkExtent2D extent = { 0,0 };
+
+        //Buffers that hold the target images for renderpass
+        std::vector<VkFramebuffer> framebuffers;
+        std::vector<Image> images;
+
+    private:
+
+        //Couple the targets to a specific vulkan instance (The targets will be destroyed before the instance)
+        Vulkan_Instance* vulkan_instance;
+    };
+}
@@ -43,6 +43,13 @@ namespace vulvox
         create_info.imageArrayLayers = 1; //Always one, unless we are working on a stereoscopic 3D application
         create_info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT; //We are writing directly to the image buffer, change when adding post-processing
 
+        //Allow copying from the swap chain images so rendered frames can be read back (frame capture)
+        if (swap_chain_support.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT)
+        {
+            create_info.imageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        }
+        image_usage = create_info.imageUsage;
+
         Queue_Family_Indices indices = vulkan_instance->get_queue_families(surface);
 
         std::array<uint32_t, 2> queue_family_indices = { indices.graphics_family.value(), indices.present_family.value() };
@@ -204,4 +211,14 @@ namespace vulvox
             }
         }
     }
+
+    const std::vector<VkImage>& Vulkan_Swap_Chain::get_images() const
+    {
+        return swap_chain_images;
+    }
+
+    bool Vulkan_Swap_Chain::supports_readback() const
+    {
+        return (image_usage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) != 0;
+    }
 }
\ No newline at end of file
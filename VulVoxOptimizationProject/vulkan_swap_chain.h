@@ -17,10 +17,18 @@ namespace vulvox
 
         void cleanup_swap_chain();
 
+        const std::vector<VkImage>& get_images() const;
+
+        /// <summary>
+        /// Returns true if the swap chain images can be used as a copy source (required for frame captures).
+        /// </summary>
+        bool supports_readback() const;
+
         //Swapchain context and information
         VkSwapchainKHR swap_chain = VK_NULL_HANDLE;
         VkFormat image_format = VK_FORMAT_UNDEFINED;
         VkExtent2D extent = { 0,0 };
+        VkImageUsageFlags image_usage = 0;
 
         //Buffers that hold the target images for renderpass
         std::vector<VkFramebuffer> framebuffers;
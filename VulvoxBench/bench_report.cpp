@@ -0,0 +1,131 @@
+#include "pch.h"
+#include "bench_report.h"
+
+namespace
+{
+    struct Summary
+    {
+        double mean = 0.0;
+        double median = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    Summary summarize(std::vector<double> values)
+    {
+        Summary summary{};
+        if (values.empty())
+        {
+            return summary;
+        }
+
+        std::sort(values.begin(), values.end());
+
+        summary.mean = std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+        summary.median = values[values.size() / 2];
+        summary.p99 = values[std::min(values.size() - 1, static_cast<size_t>(static_cast<double>(values.size()) * 0.99))];
+        summary.max = values.back();
+
+        return summary;
+    }
+
+    template<typename Member_Function>
+    Summary summarize_records(const std::vector<Frame_Record>& records, Member_Function member_function)
+    {
+        std::vector<double> values;
+        values.reserve(records.size());
+
+        for (const auto& record : records)
+        {
+            values.push_back(member_function(record));
+        }
+
+        return summarize(values);
+    }
+
+    void write_summary(std::ostream& output, const std::string& name, const Summary& summary, bool last = false)
+    {
+        output << "    \"" << name << "\": { "
+            << "\"mean\": " << summary.mean << ", "
+            << "\"median\": " << summary.median << ", "
+            << "\"p99\": " << summary.p99 << ", "
+            << "\"max\": " << summary.max << " }"
+            << (last ? "\n" : ",\n");
+    }
+}
+
+void write_json_report(std::ostream& output, const Bench_Config& config, const std::vector<Frame_Record>& records)
+{
+    output.precision(6);
+    output << std::fixed;
+
+    output << "{\n";
+    output << "  \"scene\": \"" << config.scene_name << "\",\n";
+    output << "  \"count\": " << config.count << ",\n";
+    output << "  \"frames\": " << config.frames << ",\n";
+    output << "  \"warmup_frames\": " << config.warmup_frames << ",\n";
+    output << "  \"width\": " << config.width << ",\n";
+    output << "  \"height\": " << config.height << ",\n";
+    output << "  \"headless\": " << (config.headless ? "true" : "false") << ",\n";
+    output << "  \"gpu_profiling\": " << (config.gpu_profiling ? "true" : "false") << ",\n";
+    output << "  \"gpu_culling\": " << (config.gpu_culling ? "true" : "false") << ",\n";
+    output << "  \"cpu_culling\": " << (config.cpu_culling ? "true" : "false") << ",\n";
+    output << "  \"auto_instancing\": " << (config.auto_instancing ? "true" : "false") << ",\n";
+    output << "  \"frames_in_flight\": " << config.frames_in_flight << ",\n";
+
+    //Share of the frames that started recording while the previous frame was still executing on the GPU
+    size_t overlapped_frames = std::count_if(records.begin(), records.end(), [](const Frame_Record& record) { return record.statistics.overlapped_previous_frame; });
+    output << "  \"overlapped_frame_ratio\": " << (records.empty() ? 0.0 : static_cast<double>(overlapped_frames) / static_cast<double>(records.size())) << ",\n";
+
+    output << "  \"summary\": {\n";
+    write_summary(output, "frame_ms", summarize_records(records, [](const Frame_Record& record) { return record.frame_ms; }));
+    write_summary(output, "start_draw_ms", summarize_records(records, [](const Frame_Record& record) { return record.start_draw_ms; }));
+    write_summary(output, "draw_ms", summarize_records(records, [](const Frame_Record& record) { return record.draw_ms; }));
+    write_summary(output, "end_draw_ms", summarize_records(records, [](const Frame_Record& record) { return record.end_draw_ms; }));
+    write_summary(output, "fence_wait_ms", summarize_records(records, [](const Frame_Record& record) { return record.statistics.fence_wait_ms; }));
+    write_summary(output, "instance_upload_bytes", summarize_records(records, [](const Frame_Record& record) { return static_cast<double>(record.statistics.instance_upload_bytes); }), true);
+    output << "  },\n";
+
+    output << "  \"frame_records\": [\n";
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const Frame_Record& record = records[i];
+
+        output << "    { "
+            << "\"frame\": " << record.frame << ", "
+            << "\"frame_ms\": " << record.frame_ms << ", "
+            << "\"start_draw_ms\": " << record.start_draw_ms << ", "
+            << "\"draw_ms\": " << record.draw_ms << ", "
+            << "\"end_draw_ms\": " << record.end_draw_ms << ", "
+            << "\"fence_wait_ms\": " << record.statistics.fence_wait_ms << ", "
+            << "\"frame_in_flight_index\": " << record.statistics.frame_in_flight_index << ", "
+            << "\"overlapped_previous_frame\": " << (record.statistics.overlapped_previous_frame ? "true" : "false") << ", "
+            << "\"instance_upload_bytes\": " << record.statistics.instance_upload_bytes << ", "
+            << "\"draw_calls\": " << record.statistics.draw_calls << ", "
+            << "\"instance_count\": " << record.statistics.instance_count;
+
+        if (config.cpu_culling)
+        {
+            output << ", \"cpu_culled_instances\": " << record.statistics.cpu_culled_instances;
+        }
+
+        if (config.gpu_profiling)
+        {
+            output << ", \"gpu_render_pass_ms\": " << record.gpu_render_pass_ms;
+        }
+
+        if (config.per_draw_call_timings)
+        {
+            output << ", \"draw_call_ms\": [";
+            for (size_t j = 0; j < record.draw_call_ms.size(); j++)
+            {
+                output << (j == 0 ? "" : ", ") << record.draw_call_ms[j];
+            }
+            output << "]";
+        }
+
+        output << " }" << (i + 1 < records.size() ? ",\n" : "\n");
+    }
+    output << "  ]\n";
+    output << "}\n";
+}
\ No newline at end of file
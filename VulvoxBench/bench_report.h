@@ -0,0 +1,45 @@
+#pragma once
+
+struct Bench_Config
+{
+    std::string scene_name = "draw_instanced";
+    uint64_t count = 10000;
+    uint32_t frames = 500;
+    uint32_t warmup_frames = 50;
+    uint32_t width = 1280;
+    uint32_t height = 720;
+    bool headless = true;
+    bool per_draw_call_timings = false; //Write the time of every single draw call instead of only the totals
+    bool gpu_profiling = false; //Measure the render pass on the GPU with timestamp queries
+    bool gpu_culling = false; //Frustum cull instanced draws on the GPU
+    bool cpu_culling = false; //Frustum cull instanced draws on the CPU before uploading them
+    bool auto_instancing = true; //Merge repeated draw_model calls into instanced draws
+    uint32_t frames_in_flight = 2; //Frames the CPU may record ahead of the GPU
+    std::filesystem::path output_path;
+    std::filesystem::path cpu_trace_path; //Chrome trace of the engine internals, requires a library built with CPU profiling
+};
+
+/// <summary>
+/// Measurements of a single benchmark frame, times are host (CPU) times in milliseconds.
+/// </summary>
+struct Frame_Record
+{
+    uint32_t frame = 0;
+
+    double frame_ms = 0.0;
+    double start_draw_ms = 0.0;
+    double draw_ms = 0.0; //Sum of all draw calls
+    double end_draw_ms = 0.0;
+
+    std::vector<double> draw_call_ms;
+
+    //GPU time of the render pass, lags frames_in_flight frames behind and is negative when not available
+    double gpu_render_pass_ms = -1.0;
+
+    vulvox::Frame_Statistics statistics;
+};
+
+/// <summary>
+/// Writes the config, a summary (mean, median, p99, max) and the per-frame measurements as JSON.
+/// </summary>
+void write_json_report(std::ostream& output, const Bench_Config& config, const std::vector<Frame_Record>& records);
\ No newline at end of file
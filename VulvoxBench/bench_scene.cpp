@@ -0,0 +1,481 @@
+#include "pch.h"
+#include "bench_scene.h"
+
+namespace
+{
+    //Fixed seed so every run generates the same scene
+    constexpr uint32_t SCENE_SEED = 1337;
+
+    const std::string TEXTURE_ARRAY_NAME = "bench_texture_array";
+    constexpr uint32_t TEXTURE_ARRAY_SIZE = 4;
+
+    //Converts the grid matrices (translation only) to the compact instance formats
+    template<typename Instance_Type>
+    Instance_Type to_instance(const glm::mat4& model_matrix)
+    {
+        if constexpr (std::is_same_v<Instance_Type, vulvox::Instance_Affine>)
+        {
+            return vulvox::Instance_Affine(model_matrix);
+        }
+        else
+        {
+            return Instance_Type(glm::vec3(model_matrix[3]), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), 1.0f);
+        }
+    }
+}
+
+glm::mat4 Bench_Scene::get_view_matrix() const
+{
+    glm::vec3 center{ scene_extent * 0.5f };
+    glm::vec3 camera_pos = center + glm::vec3(scene_extent * 0.8f, scene_extent * 0.6f, scene_extent * 1.2f);
+
+    return glm::lookAt(camera_pos, center, glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+float Bench_Scene::get_far_plane() const
+{
+    return scene_extent * 4.0f + 100.0f;
+}
+
+uint64_t Bench_Scene::get_count() const
+{
+    return count;
+}
+
+std::unique_ptr<Bench_Scene> Bench_Scene::create(const std::string& name, uint64_t count)
+{
+    if (name == "draw_model") { return std::make_unique<Draw_Model_Scene>(count); }
+    if (name == "draw_model_handles") { return std::make_unique<Draw_Model_Handles_Scene>(count); }
+    if (name == "parallel_draw_model") { return std::make_unique<Parallel_Draw_Model_Scene>(count); }
+    if (name == "draw_instanced") { return std::make_unique<Draw_Instanced_Scene>(count); }
+    if (name == "draw_instanced_affine") { return std::make_unique<Draw_Instanced_Format_Scene<vulvox::Instance_Affine>>(count); }
+    if (name == "draw_instanced_quat_scale") { return std::make_unique<Draw_Instanced_Format_Scene<vulvox::Instance_Quat_Scale>>(count); }
+    if (name == "draw_instanced_half") { return std::make_unique<Draw_Instanced_Format_Scene<vulvox::Instance_Half_Quat_Scale>>(count); }
+    if (name == "begin_instances") { return std::make_unique<Begin_Instances_Scene>(count); }
+    if (name == "instance_set") { return std::make_unique<Instance_Set_Scene>(count); }
+    if (name == "draw_instanced_texture_array") { return std::make_unique<Draw_Instanced_Texture_Array_Scene>(count); }
+    if (name == "draw_planes") { return std::make_unique<Draw_Planes_Scene>(count); }
+    if (name == "draw_batch") { return std::make_unique<Draw_Batch_Scene>(count); }
+    if (name == "draw_batch_bindless") { return std::make_unique<Draw_Batch_Bindless_Scene>(count); }
+
+    return nullptr;
+}
+
+std::vector<std::string> Bench_Scene::get_scene_names()
+{
+    return { "draw_model", "draw_model_handles", "parallel_draw_model", "draw_instanced", "draw_instanced_affine", "draw_instanced_quat_scale", "draw_instanced_half", "begin_instances", "instance_set", "draw_instanced_texture_array", "draw_planes", "draw_batch", "draw_batch_bindless" };
+}
+
+std::vector<glm::mat4> Bench_Scene::create_grid(float spacing) const
+{
+    uint64_t side = static_cast<uint64_t>(std::ceil(std::cbrt(static_cast<double>(count))));
+    side = std::max<uint64_t>(side, 1);
+
+    std::vector<glm::mat4> matrices;
+    matrices.reserve(count);
+
+    for (uint64_t i = 0; i < count; i++)
+    {
+        glm::vec3 position{ static_cast<float>(i % side), static_cast<float>((i / side) % side), static_cast<float>(i / (side * side)) };
+        matrices.push_back(glm::translate(glm::mat4{ 1.0f }, position * spacing));
+    }
+
+    return matrices;
+}
+
+void Bench_Scene::load_cube_assets(vulvox::Renderer& renderer) const
+{
+    renderer.load_model("cube", CUBE_MODEL_PATH);
+    renderer.load_texture("cube", CUBE_WHITE_TEXTURE_PATH);
+
+    std::vector<std::filesystem::path> texture_paths{ CUBE_WHITE_TEXTURE_PATH, CUBE_BLUE_TEXTURE_PATH, CUBE_GRASS_TEXTURE_PATH, CUBE_SEA_TEXTURE_PATH };
+    renderer.load_texture_array(TEXTURE_ARRAY_NAME, texture_paths);
+}
+
+void Draw_Model_Scene::load(vulvox::Renderer& renderer)
+{
+    load_cube_assets(renderer);
+
+    const float spacing = 3.0f;
+    grid_matrices = create_grid(spacing);
+    model_matrices = grid_matrices;
+    scene_extent = std::cbrt(static_cast<float>(count)) * spacing;
+}
+
+void Draw_Model_Scene::update(uint32_t frame)
+{
+    glm::mat4 rotation = glm::rotate(glm::mat4{ 1.0f }, glm::radians(static_cast<float>(frame)), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    for (size_t i = 0; i < grid_matrices.size(); i++)
+    {
+        model_matrices[i] = grid_matrices[i] * rotation;
+    }
+}
+
+void Draw_Model_Scene::draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms)
+{
+    for (const auto& model_matrix : model_matrices)
+    {
+        time_draw_call(draw_call_ms, [&]() { renderer.draw_model("cube", "cube", model_matrix); });
+    }
+}
+
+void Draw_Model_Handles_Scene::load(vulvox::Renderer& renderer)
+{
+    Draw_Model_Scene::load(renderer);
+
+    //Loading an already loaded name returns the existing handle
+    cube_model = renderer.load_model("cube", CUBE_MODEL_PATH);
+    cube_texture = renderer.load_texture("cube", CUBE_WHITE_TEXTURE_PATH);
+}
+
+void Draw_Model_Handles_Scene::draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms)
+{
+    for (const auto& model_matrix : model_matrices)
+    {
+        time_draw_call(draw_call_ms, [&]() { renderer.draw_model(cube_model, cube_texture, model_matrix); });
+    }
+}
+
+void Parallel_Draw_Model_Scene::load(vulvox::Renderer& renderer)
+{
+    load_cube_assets(renderer);
+
+    const float spacing = 3.0f;
+    grid_matrices = create_grid(spacing);
+    model_matrices = grid_matrices;
+    scene_extent = std::cbrt(static_cast<float>(count)) * spacing;
+
+    //Leave a core for the render thread, which waits for the workers anyway
+    worker_count = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    renderer.set_recording_workers(worker_count);
+}
+
+void Parallel_Draw_Model_Scene::update(uint32_t frame)
+{
+    glm::mat4 rotation = glm::rotate(glm::mat4{ 1.0f }, glm::radians(static_cast<float>(frame)), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    for (size_t i = 0; i < grid_matrices.size(); i++)
+    {
+        model_matrices[i] = grid_matrices[i] * rotation;
+    }
+}
+
+void Parallel_Draw_Model_Scene::draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms)
+{
+    //Timed as a single call, the individual draws overlap
+    time_draw_call(draw_call_ms, [&]()
+        {
+            size_t slice = (model_matrices.size() + worker_count - 1) / worker_count;
+
+            std::vector<std::thread> workers;
+            workers.reserve(worker_count);
+
+            for (uint32_t worker = 0; worker < worker_count; worker++)
+            {
+                workers.emplace_back([&, worker]()
+                    {
+                        size_t begin = std::min(model_matrices.size(), worker * slice);
+                        size_t end = std::min(model_matrices.size(), begin + slice);
+
+                        renderer.begin_worker_recording(worker);
+                        for (size_t i = begin; i < end; i++)
+                        {
+                            renderer.draw_model("cube", "cube", model_matrices[i]);
+                        }
+                        renderer.end_worker_recording();
+                    });
+            }
+
+            for (auto& worker : workers)
+            {
+                worker.join();
+            }
+        });
+}
+
+void Draw_Instanced_Scene::load(vulvox::Renderer& renderer)
+{
+    load_cube_assets(renderer);
+
+    const float spacing = 3.0f;
+    grid_matrices = create_grid(spacing);
+    model_matrices = grid_matrices;
+    scene_extent = std::cbrt(static_cast<float>(count)) * spacing;
+}
+
+void Draw_Instanced_Scene::update(uint32_t frame)
+{
+    //Instance data is uploaded on every draw_instanced call, so only a cheap wave is applied to keep the frames distinct
+    float wave = std::sin(static_cast<float>(frame) * 0.1f);
+
+    for (size_t i = 0; i < grid_matrices.size(); i++)
+    {
+        model_matrices[i][3].y = grid_matrices[i][3].y + wave;
+    }
+}
+
+void Draw_Instanced_Scene::draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms)
+{
+    time_draw_call(draw_call_ms, [&]() { renderer.draw_instanced("cube", "cube", model_matrices); });
+}
+
+template<typename Instance_Type>
+void Draw_Instanced_Format_Scene<Instance_Type>::load(vulvox::Renderer& renderer)
+{
+    load_cube_assets(renderer);
+
+    const float spacing = 3.0f;
+    grid_matrices = create_grid(spacing);
+    instances.resize(grid_matrices.size());
+    scene_extent = std::cbrt(static_cast<float>(count)) * spacing;
+}
+
+template<typename Instance_Type>
+void Draw_Instanced_Format_Scene<Instance_Type>::update(uint32_t frame)
+{
+    float wave = std::sin(static_cast<float>(frame) * 0.1f);
+
+    for (size_t i = 0; i < grid_matrices.size(); i++)
+    {
+        glm::mat4 model_matrix = grid_matrices[i];
+        model_matrix[3].y += wave;
+        instances[i] = to_instance<Instance_Type>(model_matrix);
+    }
+}
+
+template<typename Instance_Type>
+void Draw_Instanced_Format_Scene<Instance_Type>::draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms)
+{
+    time_draw_call(draw_call_ms, [&]() { renderer.draw_instanced("cube", "cube", instances); });
+}
+
+void Begin_Instances_Scene::load(vulvox::Renderer& renderer)
+{
+    load_cube_assets(renderer);
+
+    const float spacing = 3.0f;
+    grid_matrices = create_grid(spacing);
+    scene_extent = std::cbrt(static_cast<float>(count)) * spacing;
+}
+
+void Begin_Instances_Scene::update(uint32_t frame)
+{
+    wave = std::sin(static_cast<float>(frame) * 0.1f);
+}
+
+void Begin_Instances_Scene::draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms)
+{
+    //The wave is applied while writing the instance data, so the timing includes filling the buffer
+    time_draw_call(draw_call_ms, [&]()
+        {
+            std::span<glm::mat4> instances = renderer.begin_instances<glm::mat4>("cube", "cube", static_cast<uint32_t>(grid_matrices.size()));
+
+            for (size_t i = 0; i < instances.size(); i++)
+            {
+                instances[i] = grid_matrices[i];
+                instances[i][3].y += wave;
+            }
+
+            renderer.end_instances();
+        });
+}
+
+void Instance_Set_Scene::load(vulvox::Renderer& renderer)
+{
+    load_cube_assets(renderer);
+
+    const float spacing = 3.0f;
+    grid_matrices = create_grid(spacing);
+    scene_extent = std::cbrt(static_cast<float>(count)) * spacing;
+
+    //Upload the whole grid once, outside of the measured frames
+    instance_set = renderer.create_instance_set("cube", "cube", static_cast<uint32_t>(grid_matrices.size()));
+    renderer.update_instances(instance_set, 0, grid_matrices);
+
+    dirty_size = std::max<size_t>(grid_matrices.size() / 100, 1);
+}
+
+void Instance_Set_Scene::update(uint32_t frame)
+{
+    //Move a different slice of the grid every frame
+    float wave = std::sin(static_cast<float>(frame) * 0.1f);
+    dirty_first = static_cast<uint32_t>((static_cast<uint64_t>(frame) * dirty_size) % grid_matrices.size());
+    dirty_matrices.resize(std::min(dirty_size, grid_matrices.size() - dirty_first));
+
+    for (size_t i = 0; i < dirty_matrices.size(); i++)
+    {
+        dirty_matrices[i] = grid_matrices[dirty_first + i];
+        dirty_matrices[i][3].y += wave;
+    }
+}
+
+void Instance_Set_Scene::draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms)
+{
+    time_draw_call(draw_call_ms, [&]()
+        {
+            renderer.update_instances(instance_set, dirty_first, dirty_matrices);
+            renderer.draw_instance_set(instance_set);
+        });
+}
+
+void Draw_Instanced_Texture_Array_Scene::load(vulvox::Renderer& renderer)
+{
+    load_cube_assets(renderer);
+
+    const float spacing = 3.0f;
+    grid_matrices = create_grid(spacing);
+    model_matrices = grid_matrices;
+    scene_extent = std::cbrt(static_cast<float>(count)) * spacing;
+
+    std::mt19937 random_generator(SCENE_SEED);
+    std::uniform_int_distribution<uint32_t> texture_distribution(0, TEXTURE_ARRAY_SIZE - 1);
+
+    texture_indices.resize(count);
+    for (auto& texture_index : texture_indices)
+    {
+        texture_index = texture_distribution(random_generator);
+    }
+}
+
+void Draw_Instanced_Texture_Array_Scene::update(uint32_t frame)
+{
+    float wave = std::sin(static_cast<float>(frame) * 0.1f);
+
+    for (size_t i = 0; i < grid_matrices.size(); i++)
+    {
+        model_matrices[i][3].y = grid_matrices[i][3].y + wave;
+    }
+}
+
+void Draw_Instanced_Texture_Array_Scene::draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms)
+{
+    time_draw_call(draw_call_ms, [&]() { renderer.draw_instanced_with_texture_array("cube", TEXTURE_ARRAY_NAME, model_matrices, texture_indices); });
+}
+
+void Draw_Planes_Scene::load(vulvox::Renderer& renderer)
+{
+    load_cube_assets(renderer);
+
+    scene_extent = std::sqrt(static_cast<float>(count)) * 2.0f;
+
+    std::mt19937 random_generator(SCENE_SEED);
+    std::uniform_real_distribution<float> position_distribution(0.0f, scene_extent);
+    std::uniform_real_distribution<float> velocity_distribution(-0.5f, 0.5f);
+    std::uniform_int_distribution<uint32_t> texture_distribution(0, TEXTURE_ARRAY_SIZE - 1);
+
+    positions.resize(count);
+    velocities.resize(count);
+    model_matrices.resize(count);
+    texture_indices.resize(count);
+    min_max_uvs.resize(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        positions[i] = { position_distribution(random_generator), position_distribution(random_generator), position_distribution(random_generator) };
+        velocities[i] = { velocity_distribution(random_generator), velocity_distribution(random_generator), velocity_distribution(random_generator) };
+        texture_indices[i] = texture_distribution(random_generator);
+
+        //Use one quadrant of the texture, like a sprite sheet
+        float u = static_cast<float>(i % 2) * 0.5f;
+        float v = static_cast<float>((i / 2) % 2) * 0.5f;
+        min_max_uvs[i] = { u, v, u + 0.5f, v + 0.5f };
+    }
+}
+
+void Draw_Planes_Scene::update(uint32_t /*frame*/)
+{
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+        positions[i] += velocities[i];
+
+        //Bounce off the scene bounds
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (positions[i][axis] < 0.0f || positions[i][axis] > scene_extent)
+            {
+                velocities[i][axis] = -velocities[i][axis];
+            }
+        }
+
+        model_matrices[i] = glm::translate(glm::mat4{ 1.0f }, positions[i]);
+    }
+}
+
+void Draw_Planes_Scene::draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms)
+{
+    time_draw_call(draw_call_ms, [&]() { renderer.draw_planes(TEXTURE_ARRAY_NAME, model_matrices, texture_indices, min_max_uvs); });
+}
+
+void Draw_Batch_Scene::load(vulvox::Renderer& renderer)
+{
+    load_cube_assets(renderer);
+
+    //Every copy is a separate model with its own range in the shared vertex and index buffers
+    constexpr uint32_t MODEL_COUNT = 4;
+    std::vector<vulvox::Model_Handle> batch_models;
+
+    for (uint32_t i = 0; i < MODEL_COUNT; i++)
+    {
+        batch_models.push_back(renderer.load_model("batch_cube_" + std::to_string(i), CUBE_MODEL_PATH));
+    }
+
+    const float spacing = 3.0f;
+    grid_matrices = create_grid(spacing);
+    scene_extent = std::cbrt(static_cast<float>(count)) * spacing;
+
+    items.resize(grid_matrices.size());
+
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        items[i].model = batch_models[i % MODEL_COUNT];
+        items[i].texture_index = static_cast<uint32_t>(i % TEXTURE_ARRAY_SIZE);
+        items[i].model_matrix = grid_matrices[i];
+    }
+}
+
+void Draw_Batch_Scene::update(uint32_t frame)
+{
+    glm::mat4 rotation = glm::rotate(glm::mat4{ 1.0f }, glm::radians(static_cast<float>(frame)), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    for (size_t i = 0; i < grid_matrices.size(); i++)
+    {
+        items[i].model_matrix = grid_matrices[i] * rotation;
+    }
+}
+
+void Draw_Batch_Scene::draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms)
+{
+    time_draw_call(draw_call_ms, [&]() { renderer.draw_batch(TEXTURE_ARRAY_NAME, items); });
+}
+
+void Draw_Batch_Bindless_Scene::load(vulvox::Renderer& renderer)
+{
+    Draw_Batch_Scene::load(renderer);
+
+    if (!renderer.has_bindless_textures())
+    {
+        std::cout << "Bindless textures are unavailable, draw_batch_bindless records no draws." << std::endl;
+    }
+
+    std::vector<vulvox::Texture_Handle> batch_textures{
+        renderer.load_texture("batch_white", CUBE_WHITE_TEXTURE_PATH),
+        renderer.load_texture("batch_blue", CUBE_BLUE_TEXTURE_PATH),
+        renderer.load_texture("batch_grass", CUBE_GRASS_TEXTURE_PATH),
+        renderer.load_texture("batch_sea", CUBE_SEA_TEXTURE_PATH) };
+
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        items[i].texture = batch_textures[i % batch_textures.size()];
+    }
+}
+
+void Draw_Batch_Bindless_Scene::draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms)
+{
+    if (!renderer.has_bindless_textures())
+    {
+        return;
+    }
+
+    time_draw_call(draw_call_ms, [&]() { renderer.draw_batch(items); });
+}
\ No newline at end of file
@@ -0,0 +1,256 @@
+#pragma once
+
+/// <summary>
+/// Scripted, deterministic workload for the benchmark.
+/// Every scene only uses the public renderer api, so the measurements match what a client would see.
+/// </summary>
+class Bench_Scene
+{
+public:
+    explicit Bench_Scene(uint64_t count) : count(count) {}
+    virtual ~Bench_Scene() = default;
+
+    /// <summary>
+    /// Load the assets and build the initial instance data, not part of the measurements.
+    /// </summary>
+    virtual void load(vulvox::Renderer& renderer) = 0;
+
+    /// <summary>
+    /// Update the instance data for the given frame, not part of the measurements.
+    /// </summary>
+    virtual void update(uint32_t /*frame*/) {}
+
+    /// <summary>
+    /// Issue the draw calls of this frame, the time of each draw call is appended to draw_call_ms.
+    /// </summary>
+    virtual void draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms) = 0;
+
+    /// <summary>
+    /// View matrix that keeps the whole scene in view.
+    /// </summary>
+    virtual glm::mat4 get_view_matrix() const;
+
+    /// <summary>
+    /// Far plane distance that includes the whole scene.
+    /// </summary>
+    float get_far_plane() const;
+
+    uint64_t get_count() const;
+
+    /// <summary>
+    /// Creates the scene with the given name, returns nullptr if the name is unknown.
+    /// </summary>
+    static std::unique_ptr<Bench_Scene> create(const std::string& name, uint64_t count);
+    static std::vector<std::string> get_scene_names();
+
+protected:
+
+    //Times a single renderer call
+    template<typename Draw_Function>
+    static void time_draw_call(std::vector<double>& draw_call_ms, Draw_Function draw_function)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        draw_function();
+        draw_call_ms.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+    }
+
+    //Places count objects in a cube shaped grid with the given spacing
+    std::vector<glm::mat4> create_grid(float spacing) const;
+
+    void load_cube_assets(vulvox::Renderer& renderer) const;
+
+    uint64_t count;
+    float scene_extent = 1.0f;
+};
+
+/// <summary>
+/// Single draw_model call per cube.
+/// </summary>
+class Draw_Model_Scene : public Bench_Scene
+{
+public:
+    using Bench_Scene::Bench_Scene;
+
+    void load(vulvox::Renderer& renderer) override;
+    void update(uint32_t frame) override;
+    void draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms) override;
+
+protected:
+    std::vector<glm::mat4> grid_matrices;
+    std::vector<glm::mat4> model_matrices;
+};
+
+/// <summary>
+/// Same workload as Draw_Model_Scene, but drawn with the handles returned by the load functions instead of the names.
+/// </summary>
+class Draw_Model_Handles_Scene : public Draw_Model_Scene
+{
+public:
+    using Draw_Model_Scene::Draw_Model_Scene;
+
+    void load(vulvox::Renderer& renderer) override;
+    void draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms) override;
+
+private:
+    vulvox::Model_Handle cube_model;
+    vulvox::Texture_Handle cube_texture;
+};
+
+/// <summary>
+/// Same workload as Draw_Model_Scene, but the draw_model calls are split over recording workers that each run on their own thread.
+/// </summary>
+class Parallel_Draw_Model_Scene : public Bench_Scene
+{
+public:
+    using Bench_Scene::Bench_Scene;
+
+    void load(vulvox::Renderer& renderer) override;
+    void update(uint32_t frame) override;
+    void draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms) override;
+
+private:
+    std::vector<glm::mat4> grid_matrices;
+    std::vector<glm::mat4> model_matrices;
+    uint32_t worker_count = 1;
+};
+
+/// <summary>
+/// All cubes in a single draw_instanced call, matrices are re-uploaded every frame.
+/// </summary>
+class Draw_Instanced_Scene : public Bench_Scene
+{
+public:
+    using Bench_Scene::Bench_Scene;
+
+    void load(vulvox::Renderer& renderer) override;
+    void update(uint32_t frame) override;
+    void draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms) override;
+
+private:
+    std::vector<glm::mat4> grid_matrices;
+    std::vector<glm::mat4> model_matrices;
+};
+
+/// <summary>
+/// Same workload as Draw_Instanced_Scene, but with a compact instance format (Instance_Affine, Instance_Quat_Scale or Instance_Half_Quat_Scale).
+/// </summary>
+template<typename Instance_Type>
+class Draw_Instanced_Format_Scene : public Bench_Scene
+{
+public:
+    using Bench_Scene::Bench_Scene;
+
+    void load(vulvox::Renderer& renderer) override;
+    void update(uint32_t frame) override;
+    void draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms) override;
+
+private:
+    std::vector<glm::mat4> grid_matrices;
+    std::vector<Instance_Type> instances;
+};
+
+/// <summary>
+/// Same workload as Draw_Instanced_Scene, but the matrices are written straight into the instance buffer with begin_instances.
+/// </summary>
+class Begin_Instances_Scene : public Bench_Scene
+{
+public:
+    using Bench_Scene::Bench_Scene;
+
+    void load(vulvox::Renderer& renderer) override;
+    void update(uint32_t frame) override;
+    void draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms) override;
+
+private:
+    std::vector<glm::mat4> grid_matrices;
+    float wave = 0.0f;
+};
+
+/// <summary>
+/// Static scenery in a retained instance set, only 1% of the cubes is updated every frame.
+/// </summary>
+class Instance_Set_Scene : public Bench_Scene
+{
+public:
+    using Bench_Scene::Bench_Scene;
+
+    void load(vulvox::Renderer& renderer) override;
+    void update(uint32_t frame) override;
+    void draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms) override;
+
+private:
+    vulvox::Instance_Set_Handle instance_set;
+
+    std::vector<glm::mat4> grid_matrices;
+    std::vector<glm::mat4> dirty_matrices;
+    uint32_t dirty_first = 0;
+    size_t dirty_size = 1;
+};
+
+/// <summary>
+/// All cubes in a single draw_instanced_with_texture_array call, every cube picks one of the array textures.
+/// </summary>
+class Draw_Instanced_Texture_Array_Scene : public Bench_Scene
+{
+public:
+    using Bench_Scene::Bench_Scene;
+
+    void load(vulvox::Renderer& renderer) override;
+    void update(uint32_t frame) override;
+    void draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms) override;
+
+private:
+    std::vector<glm::mat4> grid_matrices;
+    std::vector<glm::mat4> model_matrices;
+    std::vector<uint32_t> texture_indices;
+};
+
+/// <summary>
+/// Sprite storm, randomly moving textured planes drawn with a single draw_planes call.
+/// </summary>
+class Draw_Planes_Scene : public Bench_Scene
+{
+public:
+    using Bench_Scene::Bench_Scene;
+
+    void load(vulvox::Renderer& renderer) override;
+    void update(uint32_t frame) override;
+    void draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms) override;
+
+private:
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> velocities;
+
+    std::vector<glm::mat4> model_matrices;
+    std::vector<uint32_t> texture_indices;
+    std::vector<glm::vec4> min_max_uvs;
+};
+
+/// <summary>
+/// Cubes spread over several models (copies of the cube model) drawn with a single draw_batch call, matrices are re-uploaded every frame.
+/// </summary>
+class Draw_Batch_Scene : public Bench_Scene
+{
+public:
+    using Bench_Scene::Bench_Scene;
+
+    void load(vulvox::Renderer& renderer) override;
+    void update(uint32_t frame) override;
+    void draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms) override;
+
+protected:
+    std::vector<glm::mat4> grid_matrices;
+    std::vector<vulvox::Batch_Item> items;
+};
+
+/// <summary>
+/// Same batch as Draw_Batch_Scene, but every item samples one of several separately loaded textures through the bindless texture table.
+/// </summary>
+class Draw_Batch_Bindless_Scene : public Draw_Batch_Scene
+{
+public:
+    using Draw_Batch_Scene::Draw_Batch_Scene;
+
+    void load(vulvox::Renderer& renderer) override;
+    void draw(vulvox::Renderer& renderer, std::vector<double>& draw_call_ms) override;
+};
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <thread>
+
+//GLFW & Vulkan
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+//GLM
+//Force depth range from 0.0 to 1.0 (Vulkan standard), instead of -1.0 to 1.0
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <filesystem>
+#include "../VulVoxOptimizationProject/renderer.h"
+
+
+const std::string CUBE_MODEL_PATH = "../models/cube-tex.obj";
+const std::string CUBE_WHITE_TEXTURE_PATH = "../textures/cube-tex.png";
+const std::string CUBE_BLUE_TEXTURE_PATH = "../textures/cube-tex-blue.png";
+const std::string CUBE_GRASS_TEXTURE_PATH = "../textures/cube-tex-grass.png";
+const std::string CUBE_SEA_TEXTURE_PATH = "../textures/cube-tex-sea.png";
\ No newline at end of file
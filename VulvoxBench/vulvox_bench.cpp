@@ -0,0 +1,206 @@
+#include "pch.h"
+#include "bench_scene.h"
+#include "bench_report.h"
+
+namespace
+{
+    void print_usage()
+    {
+        std::cout << "Usage: vulvox_bench [options]\n"
+            << "  --scene <name>          Scene to run (default draw_instanced)\n"
+            << "  --count <n>             Amount of objects in the scene (default 10000)\n"
+            << "  --frames <n>            Measured frames (default 500)\n"
+            << "  --warmup <n>            Frames rendered before measuring (default 50)\n"
+            << "  --width <n>             Render width (default 1280)\n"
+            << "  --height <n>            Render height (default 720)\n"
+            << "  --windowed              Render to a window instead of headless\n"
+            << "  --per-draw-call         Write the timing of every draw call\n"
+            << "  --gpu-timings           Measure the render pass with GPU timestamp queries\n"
+            << "  --gpu-culling           Frustum cull instanced draws in a compute shader\n"
+            << "  --cpu-culling           Frustum cull instanced draws on worker threads before the upload\n"
+            << "  --no-auto-instancing    Record every draw_model call as its own draw\n"
+            << "  --frames-in-flight <n>  Frames the CPU records ahead of the GPU, 1 to 4 (default 2)\n"
+            << "  --output <file>         JSON output path (default <scene>_<count>.json)\n"
+            << "  --cpu-trace <file>      Write a Chrome trace of the engine CPU scopes\n"
+            << "  --list                  List the available scenes\n";
+    }
+
+    bool parse_arguments(int argc, char* argv[], Bench_Config& config)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string argument = argv[i];
+
+            //All options except flags take a single value
+            auto next_value = [&]() -> std::string
+                {
+                    if (i + 1 >= argc)
+                    {
+                        throw std::runtime_error("Missing value for argument " + argument);
+                    }
+                    return argv[++i];
+                };
+
+            if (argument == "--scene") { config.scene_name = next_value(); }
+            else if (argument == "--count") { config.count = std::stoull(next_value()); }
+            else if (argument == "--frames") { config.frames = static_cast<uint32_t>(std::stoul(next_value())); }
+            else if (argument == "--warmup") { config.warmup_frames = static_cast<uint32_t>(std::stoul(next_value())); }
+            else if (argument == "--width") { config.width = static_cast<uint32_t>(std::stoul(next_value())); }
+            else if (argument == "--height") { config.height = static_cast<uint32_t>(std::stoul(next_value())); }
+            else if (argument == "--windowed") { config.headless = false; }
+            else if (argument == "--per-draw-call") { config.per_draw_call_timings = true; }
+            else if (argument == "--gpu-timings") { config.gpu_profiling = true; }
+            else if (argument == "--gpu-culling") { config.gpu_culling = true; }
+            else if (argument == "--cpu-culling") { config.cpu_culling = true; }
+            else if (argument == "--no-auto-instancing") { config.auto_instancing = false; }
+            else if (argument == "--frames-in-flight") { config.frames_in_flight = static_cast<uint32_t>(std::stoul(next_value())); }
+            else if (argument == "--output") { config.output_path = next_value(); }
+            else if (argument == "--cpu-trace") { config.cpu_trace_path = next_value(); }
+            else if (argument == "--list")
+            {
+                for (const auto& scene_name : Bench_Scene::get_scene_names())
+                {
+                    std::cout << scene_name << std::endl;
+                }
+                return false;
+            }
+            else
+            {
+                print_usage();
+                return false;
+            }
+        }
+
+        if (config.output_path.empty())
+        {
+            config.output_path = config.scene_name + "_" + std::to_string(config.count) + ".json";
+        }
+
+        return true;
+    }
+
+    double elapsed_ms(std::chrono::high_resolution_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        Bench_Config config;
+        if (!parse_arguments(argc, argv, config))
+        {
+            return 0;
+        }
+
+        std::unique_ptr<Bench_Scene> scene = Bench_Scene::create(config.scene_name, config.count);
+        if (!scene)
+        {
+            std::cout << "Unknown scene " << config.scene_name << ", use --list to show the available scenes." << std::endl;
+            return 1;
+        }
+
+        vulvox::Renderer renderer;
+
+        if (config.headless)
+        {
+            renderer.init_headless(config.width, config.height, glm::radians(45.0f), 0.1f, 1000.0f, config.frames_in_flight);
+        }
+        else
+        {
+            renderer.init(config.width, config.height, glm::radians(45.0f), 0.1f, 1000.0f, config.frames_in_flight);
+        }
+
+        //Report the amount that is actually used, out of range requests are clamped
+        config.frames_in_flight = renderer.get_frames_in_flight();
+
+        renderer.set_gpu_profiling(config.gpu_profiling);
+        renderer.set_gpu_culling(config.gpu_culling);
+        renderer.set_cpu_culling(config.cpu_culling);
+        renderer.set_auto_instancing(config.auto_instancing);
+
+        scene->load(renderer);
+        renderer.set_far_plane(scene->get_far_plane());
+        renderer.set_view_matrix(scene->get_view_matrix());
+
+        std::vector<Frame_Record> records;
+        records.reserve(config.frames);
+
+        std::vector<double> draw_call_ms;
+        draw_call_ms.reserve(config.count);
+
+        uint32_t total_frames = config.warmup_frames + config.frames;
+        for (uint32_t frame = 0; frame < total_frames && !renderer.should_close(); frame++)
+        {
+            if (!config.headless)
+            {
+                glfwPollEvents();
+            }
+
+            scene->update(frame);
+            draw_call_ms.clear();
+
+            Frame_Record record{};
+            record.frame = frame;
+
+            auto frame_start = std::chrono::high_resolution_clock::now();
+
+            auto start_draw_start = std::chrono::high_resolution_clock::now();
+            renderer.start_draw();
+            record.start_draw_ms = elapsed_ms(start_draw_start);
+
+            scene->draw(renderer, draw_call_ms);
+
+            auto end_draw_start = std::chrono::high_resolution_clock::now();
+            renderer.end_draw();
+            record.end_draw_ms = elapsed_ms(end_draw_start);
+
+            record.frame_ms = elapsed_ms(frame_start);
+            record.draw_ms = std::accumulate(draw_call_ms.begin(), draw_call_ms.end(), 0.0);
+            record.statistics = renderer.get_frame_statistics();
+
+            if (vulvox::GPU_Frame_Timings gpu_timings = renderer.get_gpu_timings(); gpu_timings.valid)
+            {
+                record.gpu_render_pass_ms = gpu_timings.render_pass_ms;
+            }
+
+            if (frame < config.warmup_frames)
+            {
+                continue;
+            }
+
+            if (config.per_draw_call_timings)
+            {
+                record.draw_call_ms = draw_call_ms;
+            }
+
+            records.push_back(std::move(record));
+        }
+
+        if (!config.cpu_trace_path.empty())
+        {
+            renderer.write_cpu_trace(config.cpu_trace_path);
+        }
+
+        renderer.destroy();
+
+        std::ofstream output(config.output_path);
+        if (!output.is_open())
+        {
+            throw std::runtime_error("Failed to open output file " + config.output_path.string());
+        }
+
+        write_json_report(output, config, records);
+
+        std::cout << "Wrote " << records.size() << " frames to " << config.output_path.string() << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cout << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+
+//GLFW & Vulkan
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+//GLM
+//Force depth range from 0.0 to 1.0 (Vulkan standard), instead of -1.0 to 1.0
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../VulVoxOptimizationProject/renderer.h"
\ No newline at end of file
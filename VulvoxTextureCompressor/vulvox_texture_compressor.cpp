@@ -0,0 +1,145 @@
+#include "pch.h"
+
+namespace
+{
+    struct Compressor_Config
+    {
+        vulvox::Texture_Compression compression = vulvox::Texture_Compression::BC7;
+        std::filesystem::path cache_directory = vulvox::Texture_Cache::DEFAULT_DIRECTORY;
+        uint32_t thread_count = 0;
+        bool overwrite = false;
+
+        std::vector<std::filesystem::path> inputs;
+    };
+
+    void print_usage()
+    {
+        std::cout << "Usage: vulvox_texture_compressor [options] <texture or directory>...\n"
+            << "  --format <bc1|bc7>      Block compression of the cached textures (default bc7)\n"
+            << "  --cache <dir>           Texture cache directory (default texture_cache)\n"
+            << "  --threads <n>           Worker threads, 0 uses all cores (default 0)\n"
+            << "  --force                 Compress textures that already have a cache entry again\n"
+            << "Directories are searched recursively for PNG, JPG, TGA and BMP files.\n"
+            << "Run from the directory the renderer is started from, or pass the same cache directory to Renderer::set_texture_cache_directory.\n";
+    }
+
+    bool parse_arguments(int argc, char* argv[], Compressor_Config& config)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string argument = argv[i];
+
+            //All options except flags take a single value
+            auto next_value = [&]() -> std::string
+                {
+                    if (i + 1 >= argc)
+                    {
+                        throw std::runtime_error("Missing value for argument " + argument);
+                    }
+                    return argv[++i];
+                };
+
+            if (argument == "--format")
+            {
+                std::string format = next_value();
+
+                if (format == "bc1") { config.compression = vulvox::Texture_Compression::BC1; }
+                else if (format == "bc7") { config.compression = vulvox::Texture_Compression::BC7; }
+                else { throw std::runtime_error("Unknown format " + format + ", use bc1 or bc7"); }
+            }
+            else if (argument == "--cache") { config.cache_directory = next_value(); }
+            else if (argument == "--threads") { config.thread_count = static_cast<uint32_t>(std::stoul(next_value())); }
+            else if (argument == "--force") { config.overwrite = true; }
+            else if (!argument.starts_with("--"))
+            {
+                config.inputs.push_back(argument);
+            }
+            else
+            {
+                print_usage();
+                return false;
+            }
+        }
+
+        if (config.inputs.empty())
+        {
+            print_usage();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool is_source_texture(const std::filesystem::path& path)
+    {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp";
+    }
+
+    std::vector<std::filesystem::path> collect_textures(const std::vector<std::filesystem::path>& inputs)
+    {
+        std::vector<std::filesystem::path> texture_paths;
+
+        for (const auto& input : inputs)
+        {
+            if (std::filesystem::is_directory(input))
+            {
+                for (const auto& entry : std::filesystem::recursive_directory_iterator(input))
+                {
+                    if (entry.is_regular_file() && is_source_texture(entry.path()))
+                    {
+                        texture_paths.push_back(entry.path());
+                    }
+                }
+            }
+            else if (std::filesystem::is_regular_file(input))
+            {
+                texture_paths.push_back(input);
+            }
+            else
+            {
+                std::cout << "Skipped " << input.string() << ", no such file or directory." << std::endl;
+            }
+        }
+
+        return texture_paths;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        Compressor_Config config;
+        if (!parse_arguments(argc, argv, config))
+        {
+            return 0;
+        }
+
+        std::vector<std::filesystem::path> texture_paths = collect_textures(config.inputs);
+
+        if (texture_paths.empty())
+        {
+            std::cout << "No textures found." << std::endl;
+            return 1;
+        }
+
+        vulvox::Texture_Cache texture_cache(config.cache_directory);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        uint32_t stored_count = texture_cache.store_all(texture_paths, config.compression, config.thread_count, config.overwrite);
+        double elapsed_seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        std::cout << "Compressed " << stored_count << " of " << texture_paths.size() << " textures to " << config.cache_directory.string()
+            << " in " << elapsed_seconds << " s" << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cout << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -6,4 +6,9 @@ C:/VulkanSDK/1.3.290.0/Bin/glslc.exe instance_tex_array_shader.vert -o instance_
 C:/VulkanSDK/1.3.290.0/Bin/glslc.exe instance_tex_array_shader.frag -o instance_tex_array_frag.spv
 C:/VulkanSDK/1.3.290.0/Bin/glslc.exe instance_tex_array_shader.frag -o instance_tex_array_frag.spv
 C:/VulkanSDK/1.3.290.0/Bin/glslc.exe instance_plane.vert -o instance_plane_vert.spv
+C:/VulkanSDK/1.3.290.0/Bin/glslc.exe instance_affine_shader.vert -o instance_affine_vert.spv
+C:/VulkanSDK/1.3.290.0/Bin/glslc.exe instance_quat_shader.vert -o instance_quat_vert.spv
+C:/VulkanSDK/1.3.290.0/Bin/glslc.exe instance_cull.comp -o instance_cull_comp.spv
+C:/VulkanSDK/1.3.290.0/Bin/glslc.exe instance_bindless_shader.vert -o instance_bindless_vert.spv
+C:/VulkanSDK/1.3.290.0/Bin/glslc.exe instance_bindless_shader.frag -o instance_bindless_frag.spv
 pause
\ No newline at end of file
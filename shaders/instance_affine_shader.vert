@@ -0,0 +1,33 @@
+#version 450
+
+layout(set = 0, binding = 0) uniform MVP
+{
+	mat4 model;
+	mat4 view;
+	mat4 projection;
+} mvp;
+
+//Vertex attributes
+layout(location = 0) in vec3 in_position;
+layout(location = 1) in vec3 in_color;
+layout(location = 2) in vec2 in_texture_coordinate;
+
+//Instance attributes, the upper three rows of the model matrix
+layout(location = 3) in vec4 instance_row_0;
+layout(location = 4) in vec4 instance_row_1;
+layout(location = 5) in vec4 instance_row_2;
+
+layout(location = 0) out vec3 frag_color;
+layout(location = 1) out vec2 frag_texture_coordinate;
+
+void main()
+{
+	frag_color = in_color;
+	
+	frag_texture_coordinate = vec2(in_texture_coordinate);
+
+	vec4 position = vec4(in_position, 1.0);
+	vec3 world_position = vec3(dot(instance_row_0, position), dot(instance_row_1, position), dot(instance_row_2, position));
+
+	gl_Position = mvp.projection * mvp.view * mvp.model * vec4(world_position, 1.0);
+}
\ No newline at end of file
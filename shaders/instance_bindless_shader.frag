@@ -0,0 +1,24 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+//Every loaded texture, only the elements that are drawn with have to be valid
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+layout(location = 0) in vec3 frag_color;
+layout(location = 1) in vec2 frag_texture_coordinate;
+layout(location = 2) flat in uint frag_texture_index;
+
+layout(location = 0) out vec4 out_color;
+
+void main()
+{
+    //The index can differ within a draw (and a subgroup), so it has to be marked non-uniform
+    vec4 tex_color = vec4(frag_color, 1.0) * texture(textures[nonuniformEXT(frag_texture_index)], frag_texture_coordinate);
+
+    // Alpha Testing (discard low-alpha pixels)
+    if (tex_color.a < 0.01) {
+        discard; // Skip pixels with very low alpha
+    }
+
+    out_color = tex_color;
+}
\ No newline at end of file
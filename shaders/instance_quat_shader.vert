@@ -0,0 +1,36 @@
+#version 450
+
+layout(set = 0, binding = 0) uniform MVP
+{
+	mat4 model;
+	mat4 view;
+	mat4 projection;
+} mvp;
+
+//Vertex attributes
+layout(location = 0) in vec3 in_position;
+layout(location = 1) in vec3 in_color;
+layout(location = 2) in vec2 in_texture_coordinate;
+
+//Instance attributes, used by both the float and half float formats (the vertex fetch converts halfs to floats)
+layout(location = 3) in vec4 instance_position_scale; //xyz position, w uniform scale
+layout(location = 4) in vec4 instance_rotation; //Unit quaternion
+
+layout(location = 0) out vec3 frag_color;
+layout(location = 1) out vec2 frag_texture_coordinate;
+
+vec3 rotate(vec4 q, vec3 v)
+{
+	return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+void main()
+{
+	frag_color = in_color;
+	
+	frag_texture_coordinate = vec2(in_texture_coordinate);
+
+	vec3 world_position = rotate(instance_rotation, in_position * instance_position_scale.w) + instance_position_scale.xyz;
+
+	gl_Position = mvp.projection * mvp.view * mvp.model * vec4(world_position, 1.0);
+}
\ No newline at end of file